@@ -40,12 +40,14 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <UgJson.h>
 #include <UgList.h>
 #include <UgArray.h>
 #include <UgEntry.h>
 #include <UgValue.h>
+#include <UgJsonrpc.h>
 #include <UgJson-custom.h>
 
 // ----------------------------------------------------------------------------
@@ -566,6 +568,87 @@ void  test_json_object_custom (void)
 	worked_id_final (&worked);
 }
 
+// ----------------------------------------------------------------------------
+// UgEntry name index
+
+typedef struct
+{
+	int         first;
+	int         second;
+	int         duplicate;
+	WorkedId    worked;
+} IndexTest;
+
+static const UgEntry  IndexTestEntry[] =
+{
+	{"first",   offsetof (IndexTest, first),     UG_ENTRY_INT, NULL, NULL},
+	{"second",  offsetof (IndexTest, second),    UG_ENTRY_INT, NULL, NULL},
+	{"first",   offsetof (IndexTest, duplicate), UG_ENTRY_INT, NULL, NULL},
+	{"worked",  offsetof (IndexTest, worked),    UG_ENTRY_OBJECT,
+			WorkedIdEntry, NULL},
+	{NULL},
+};
+
+static void  index_test_parse (IndexTest* itest)
+{
+	UgJson      json;
+	const char* json_string = {
+		"{ \"second\": 2, \"unknown\": [1, 2], \"first\": 1,"
+		"  \"worked\": { \"id\": \"index\", \"worked\": true } }"
+	};
+
+	memset (itest, 0, sizeof (IndexTest));
+	ug_json_init (&json);
+	ug_json_begin_parse (&json);
+	ug_json_push (&json, ug_json_parse_entry, itest, (void*) IndexTestEntry);
+	ug_json_push (&json, ug_json_parse_object, NULL, NULL);
+	ug_json_parse (&json, json_string, -1);
+	ug_json_end_parse (&json);
+	ug_json_final (&json);
+}
+
+static int  index_test_check (IndexTest* itest)
+{
+	int  error = 0;
+
+	if (itest->first != 1 || itest->second != 2 || itest->duplicate != 0)
+		error++;
+	if (itest->worked.worked != TRUE || itest->worked.id == NULL ||
+	    strcmp (itest->worked.id, "index") != 0)
+	{
+		error++;
+	}
+	ug_free (itest->worked.id);
+	return error;
+}
+
+void  test_entry_index (void)
+{
+	IndexTest   itest;
+	int         error = 0;
+
+	puts ("\n--- test_entry_index:");
+
+	// walk UgEntry array
+	index_test_parse (&itest);
+	error += index_test_check (&itest);
+	// use name index, it is reference counted.
+	if (ug_entry_index_add (IndexTestEntry) == FALSE)
+		error++;
+	ug_entry_index_add (IndexTestEntry);
+	index_test_parse (&itest);
+	error += index_test_check (&itest);
+	ug_entry_index_remove (IndexTestEntry);
+	index_test_parse (&itest);
+	error += index_test_check (&itest);
+	// walk UgEntry array again
+	ug_entry_index_remove (IndexTestEntry);
+	index_test_parse (&itest);
+	error += index_test_check (&itest);
+
+	printf ("entry index, error : %d\n", error);
+}
+
 // ----------------------------------------------------------------------------
 // JSON array sample
 
@@ -775,6 +858,251 @@ void  test_json_value (void)
 	ug_json_final (&json);
 }
 
+// ----------------------------------------------------------------------------
+// test JSON-RPC response that parsed into arena
+// large objects are indexed once after parsing by ug_value_index_arena().
+
+static int  json_arena_parse (UgJsonrpcObject* jobj, int members)
+{
+	UgJson  json;
+	char*   string;
+	char*   cur;
+	int     index, code;
+
+	string = malloc (members * 32 + 128);
+	cur = string + sprintf (string, "{\"id\":1,\"result\":[{");
+	for (index = 0;  index < members;  index++)
+		cur += sprintf (cur, "%s\"m%d\":%d", (index) ? "," : "", index, index);
+	strcpy (cur, "},\"tail\"]}");
+
+	ug_json_init (&json);
+	ug_json_begin_parse (&json);
+	ug_json_push (&json, ug_json_parse_rpc_object, jobj, NULL);
+	ug_json_push (&json, ug_json_parse_object, NULL, NULL);
+	ug_json_parse (&json, string, -1);
+	code = ug_json_end_parse (&json);
+	ug_json_final (&json);
+	free (string);
+
+	if (jobj->in_arena.result)
+		ug_value_index_arena (&jobj->result, jobj->arena);
+	return code;
+}
+
+static int  json_arena_check (UgJsonrpcObject* jobj, int members)
+{
+	UgValue*  object;
+	UgValue*  member;
+	char      name[16];
+	int       index, error = 0;
+
+	if (jobj->in_arena.id == 0 || jobj->in_arena.result == 0 ||
+	    jobj->result.type != UG_VALUE_ARRAY ||
+	    jobj->result.c.array->length != 2)
+	{
+		return 1;
+	}
+	object = jobj->result.c.array->at;
+	if (object->type != UG_VALUE_OBJECT || object->c.object->length != members)
+		return 1;
+	// objects that have more than 8 members are indexed.
+	if ((members > 8) != (object->c.object->index != NULL))
+		error++;
+	for (index = 0;  index < members;  index++) {
+		sprintf (name, "m%d", index);
+		member = ug_value_find_name (object, name);
+		if (member == NULL || member->c.integer != index)
+			error++;
+	}
+	if (ug_value_find_name (object, "none") != NULL)
+		error++;
+	return error;
+}
+
+void  test_json_value_arena (void)
+{
+	UgJsonrpcObject*  jobj;
+	int   counts[] = {3, 8, 9, 40, 1000};
+	int   index, error = 0;
+
+	puts ("\n--- test_json_value_arena:");
+
+	jobj = ug_jsonrpc_object_new ();
+	jobj->arena = ug_arena_new (0);
+	for (index = 0;  index < (int) (sizeof (counts) / sizeof (int));  index++) {
+		if (json_arena_parse (jobj, counts[index]) != UG_JSON_ERROR_NONE ||
+		    json_arena_check (jobj, counts[index]) != 0)
+		{
+			printf ("members %d failed\n", counts[index]);
+			error++;
+		}
+		// response object is reused and arena is reset by clear.
+		if (index & 1)
+			ug_jsonrpc_object_clear (jobj);
+	}
+	ug_jsonrpc_object_clear (jobj);
+	if (jobj->in_arena.id || jobj->in_arena.result ||
+	    jobj->result.type != UG_VALUE_NONE)
+	{
+		error++;
+	}
+	ug_jsonrpc_object_free (jobj);
+	printf ("error : %d\n", error);
+}
+
+// ----------------------------------------------------------------------------
+// test JSON scanners
+// ug_json_parse() scans whitespace, string and digit runs by SSE2/AVX2.
+// Input is split at every byte offset and result must be the same.
+
+// parse 'string' in 2 chunks and write it back to JSON
+static char*  json_split_parse (const char* string, int length, int split, int* code)
+{
+	UgJson   json;
+	UgValue  value;
+	UgBuffer buffer;
+
+	ug_value_init (&value);
+	ug_json_init (&json);
+	ug_json_begin_parse (&json);
+	ug_json_push (&json, ug_json_parse_value, &value, NULL);
+	*code = ug_json_parse (&json, string, split);
+	if (*code == UG_JSON_ERROR_NONE)
+		*code = ug_json_parse (&json, string + split, length - split);
+	if (*code == UG_JSON_ERROR_NONE)
+		*code = ug_json_end_parse (&json);
+	else
+		ug_json_end_parse (&json);
+
+	ug_buffer_init (&buffer, 256);
+	ug_json_begin_write (&json, UG_JSON_FORMAT_UTF8, &buffer);
+	if (*code == UG_JSON_ERROR_NONE)
+		ug_json_write_value (&json, &value);
+	ug_json_end_write (&json);
+	ug_buffer_write_char (&buffer, '\0');
+	ug_json_final (&json);
+	ug_value_clear (&value);
+	return buffer.beg;
+}
+
+static int  json_split_check (const char* string, const char* expected)
+{
+	char*  result;
+	char*  whole;
+	int    length, split;
+	int    code, whole_code, n_error = 0;
+
+	length = (int) strlen (string);
+	whole = json_split_parse (string, length, length, &whole_code);
+	if (expected && (whole_code != UG_JSON_ERROR_NONE || strcmp (whole, expected) != 0)) {
+		printf ("parse '%s' get '%s'\n", string, whole);
+		n_error++;
+	}
+	for (split = 0;  split < length;  split++) {
+		result = json_split_parse (string, length, split, &code);
+		if (code != whole_code || strcmp (result, whole) != 0) {
+			printf ("parse '%s' split at %d get '%s'\n", string, split, result);
+			n_error++;
+		}
+		ug_free (result);
+	}
+	ug_free (whole);
+	return n_error;
+}
+
+// build 'n' characters from 'chars' in 'buf'
+static char*  json_fill (char* buf, const char* chars, int n)
+{
+	int  index, length;
+
+	length = (int) strlen (chars);
+	for (index = 0;  index < n;  index++)
+		buf[index] = chars[index % length];
+	return buf + n;
+}
+
+void  test_json_scanner (void)
+{
+	static const int  lengths[] = {1, 15, 16, 17, 31, 32, 33, 64};
+	static const char* strings[][2] = {
+		{" [ \"abc\\\"def\\\\ghi\\/\\b\\f\\n\\r\\t\" ,\t\"\\u00e9\\u4e2d\" ]",
+		 "[\"abc\\\"def\\\\ghi\\/\\b\\f\\n\\r\\t\",\"\xc3\xa9\xe4\xb8\xad\"]"},
+		// UTF-8 is copied as it is
+		{"\"Sam a t\xc5\xb1zolt\xc3\xb3 - Vil\xc3\xa1gcs\xc3\xba" "cs k\xc3\xads\xc3\xa9rletek\"",
+		 NULL},
+		{"{\"int\" : -1234567890123,\n \"uint\":18446744073709551615,"
+		 " \"double\": -0.000125e+3, \"exp\" :1E-7,\"zero\":0}",
+		 NULL},
+		{"[true, false ,null,\r\n\t[], {}, [[1],[2 , 3]]]",
+		 "[true,false,null,[],{},[[1],[2,3]]]"},
+		// errors must be reported at any split
+		{"[\"abc\\q\"]", NULL},
+		{"[1, 2 3]", NULL},
+		{"{\"a\" : tru}", NULL},
+		{"[\"\\u00g0\"]", NULL},
+	};
+	char   buf[512];
+	char   expected[512];
+	char*  cur;
+	char*  exp;
+	int    index, n, n_error = 0;
+
+	puts ("\n--- test_json_scanner:");
+	for (index = 0;  index < (int) (sizeof (strings) / sizeof (strings[0]));  index++)
+		n_error += json_split_check (strings[index][0], strings[index][1]);
+
+	// runs around vector width: whitespace, string and digits
+	for (index = 0;  index < (int) (sizeof (lengths) / sizeof (int));  index++) {
+		n = lengths[index];
+		// whitespace run and string body
+		cur = json_fill (buf, " \t\r\n", n);
+		*cur++ = '[';
+		*cur++ = '"';
+		cur = json_fill (cur, "abcdefghijklmnopqrstuvwxyz", n);
+		*cur++ = '"';
+		cur = json_fill (cur, " ", n);
+		*cur++ = ']';
+		*cur = 0;
+		exp = expected;
+		*exp++ = '[';
+		*exp++ = '"';
+		exp = json_fill (exp, "abcdefghijklmnopqrstuvwxyz", n);
+		strcpy (exp, "\"]");
+		n_error += json_split_check (buf, expected);
+
+		// escape and UTF-8 after run
+		cur = buf;
+		*cur++ = '"';
+		cur = json_fill (cur, "0123456789", n);
+		strcpy (cur, "\\n\xc3\xa9\\u00e9\"");
+		exp = expected;
+		*exp++ = '"';
+		exp = json_fill (exp, "0123456789", n);
+		strcpy (exp, "\\n\xc3\xa9\xc3\xa9\"");
+		n_error += json_split_check (buf, expected);
+
+		// digit run, fraction and exponent
+		if (n < 19) {
+			cur = buf;
+			*cur++ = '[';
+			cur = json_fill (cur, "123456789", n);
+			*cur++ = ',';
+			*cur++ = '-';
+			cur = json_fill (cur, "987654321", n);
+			strcpy (cur, "]");
+			n_error += json_split_check (buf, buf);
+		}
+		cur = buf;
+		*cur++ = '[';
+		cur = json_fill (cur, "1", n);
+		*cur++ = '.';
+		cur = json_fill (cur, "5", n);
+		strcpy (cur, "e-2]");
+		n_error += json_split_check (buf, NULL);
+	}
+	printf ("error : %d\n", n_error);
+}
+
 // ----------------------------------------------------------------------------
 // test JSON writer
 
@@ -826,6 +1154,164 @@ void  test_json_writer (void)
 	ug_json_final (&json);
 }
 
+// write one value by 'func' and return JSON string.
+// If 'chunk' > 0, UgBuffer is flushed every 'chunk' bytes.
+typedef void (*JsonWriteFunc) (UgJson* json, const void* value);
+
+static int  json_flush_chunk (UgBuffer* buffer)
+{
+	ug_array_append ((UgArrayChar*) buffer->data, buffer->beg,
+	                 ug_buffer_length (buffer));
+	buffer->cur = buffer->beg;
+	return 1;
+}
+
+static char*  json_write_chunk (JsonWriteFunc func, const void* value, int chunk)
+{
+	UgJson      json;
+	UgBuffer    buffer;
+	UgArrayChar array;
+	char        exbuf[64];
+
+	ug_array_init (&array, sizeof (char), 64);
+	if (chunk > 0)
+		ug_buffer_init_external (&buffer, exbuf, chunk);
+	else
+		ug_buffer_init (&buffer, 64);
+	buffer.more = json_flush_chunk;
+	buffer.data = &array;
+
+	ug_json_init (&json);
+	ug_json_begin_write (&json, 0, &buffer);
+	func (&json, value);
+	ug_json_end_write (&json);
+	json_flush_chunk (&buffer);
+	ug_json_final (&json);
+	if (chunk <= 0)
+		ug_buffer_clear (&buffer, TRUE);
+	ug_array_end0 (&array);
+	return array.at;
+}
+
+static void  json_write_int64 (UgJson* json, const void* value)
+{
+	ug_json_write_int64 (json, *(const int64_t*) value);
+}
+
+static void  json_write_uint64 (UgJson* json, const void* value)
+{
+	ug_json_write_uint64 (json, *(const uint64_t*) value);
+}
+
+static void  json_write_double (UgJson* json, const void* value)
+{
+	ug_json_write_double (json, *(const double*) value);
+}
+
+static void  json_write_string (UgJson* json, const void* value)
+{
+	ug_json_write_string (json, value);
+}
+
+static int  json_check_double (double value, const char* expected)
+{
+	char*   string;
+	double  result;
+	int     n_error = 0;
+
+	string = json_write_chunk (json_write_double, &value, 0);
+	result = strtod (string, NULL);
+	// compare bits, so -0 is not equal to 0
+	if (memcmp (&result, &value, sizeof (double)) != 0 ||
+	    (expected && strcmp (string, expected) != 0))
+	{
+		printf ("write %.17g get '%s'\n", value, string);
+		n_error++;
+	}
+	ug_free (string);
+	return n_error;
+}
+
+void  test_json_writer_value (void)
+{
+	static const double  doubles[][1] = {
+		{0.1}, {0.5}, {1.25}, {-3.75}, {123456.789}, {0.1 + 0.2},
+		{1.0 / 3.0}, {9007199254740993.0}, {1.7976931348623157e308},
+		{2.2250738585072014e-308},   // smallest normal
+		{4.9406564584124654e-324},   // smallest subnormal
+		{2.2250738585072009e-308},   // largest subnormal
+	};
+	const int64_t   int64_min = INT64_MIN;
+	const int64_t   int64_max = INT64_MAX;
+	const uint64_t  uint64_max = UINT64_MAX;
+	uint64_t        bits = 0x123456789ABCDEF;
+	double          value;
+	char    string[128];
+	char    expected[128];
+	char*   cur;
+	char*   result;
+	char*   chunked;
+	int     index, chunk, n_error = 0;
+
+	puts ("\n--- test_json_writer_value:");
+	// integer limits
+	result = json_write_chunk (json_write_int64, &int64_min, 0);
+	if (strcmp (result, "-9223372036854775808") != 0)
+		n_error++;
+	ug_free (result);
+	result = json_write_chunk (json_write_int64, &int64_max, 0);
+	if (strcmp (result, "9223372036854775807") != 0)
+		n_error++;
+	ug_free (result);
+	result = json_write_chunk (json_write_uint64, &uint64_max, 0);
+	if (strcmp (result, "18446744073709551615") != 0)
+		n_error++;
+	ug_free (result);
+
+	// double
+	n_error += json_check_double (0.0, "0");
+	n_error += json_check_double (-0.0, "-0");
+	n_error += json_check_double (1e-7, "0.0000001");
+	n_error += json_check_double (1e21, "1e+21");
+	n_error += json_check_double (-2.5, "-2.5");
+	for (index = 0;  index < (int) (sizeof (doubles) / sizeof (doubles[0]));  index++)
+		n_error += json_check_double (doubles[index][0], NULL);
+	// random bit patterns except NaN and infinity
+	for (index = 0;  index < 100000;  index++) {
+		bits = bits * 6364136223846793005ULL + 1442695040888963407ULL;
+		memcpy (&value, &bits, sizeof (double));
+		if (value != value || value - value != 0)
+			continue;
+		n_error += json_check_double (value, NULL);
+	}
+
+	// escaped and control characters cross the chunk boundary
+	for (index = 0;  index < 16;  index++) {
+		cur = string;
+		memset (cur, 'x', index);
+		strcpy (cur + index, "\"\\/\b\f\n\r\t\x01\x1f\x7f" "\xc3\xa9" "end");
+		cur = expected;
+		*cur++ = '"';
+		memset (cur, 'x', index);
+		strcpy (cur + index, "\\\"\\\\\\/\\b\\f\\n\\r\\t\\u0001\\u001F\x7f" "\\u00E9" "end\"");
+		result = json_write_chunk (json_write_string, string, 0);
+		if (strcmp (result, expected) != 0) {
+			printf ("write '%s' get '%s'\n", string, result);
+			n_error++;
+		}
+		for (chunk = 1;  chunk < 9;  chunk++) {
+			chunked = json_write_chunk (json_write_string, string, chunk);
+			if (strcmp (chunked, result) != 0) {
+				printf ("write in %d bytes chunk get '%s'\n", chunk, chunked);
+				n_error++;
+			}
+			ug_free (chunked);
+		}
+		ug_free (result);
+	}
+	printf ("error : %d\n", n_error);
+}
+
 // ----------------------------------------------------------------------------
 // test UgArray
 
@@ -858,10 +1344,16 @@ int   main (void)
 	test_array ();
 	// test JSON writer
 	test_json_writer ();
+	test_json_writer_value ();
 	// test simple JSON value
 	test_json_value ();
+	test_json_value_arena ();
+	// scanners of ug_json_parse()
+	test_json_scanner ();
 	// use Custom type (WorkedId) to store JSON object
 	test_json_object_custom ();
+	// UgEntry name index
+	test_entry_index ();
 	// use UgArray(int) to store JSON number array
 	test_json_int_array ();
 	// use UgList to store JSON string and number array
@@ -36,6 +36,8 @@
 
 #include <stdio.h>
 #include <UgString.h>
+#include <UgStdio.h>
+#include <UgFileUtil.h>
 #include <UgetApp.h>
 #include <UgetPluginCurl.h>
 #include <UgetPluginAria2.h>
@@ -153,7 +155,7 @@ void  test_download(void)
 	// http options
 	http = ug_data_realloc(data, UgetHttpInfo);
 	if (referrer)
-		http->referrer = ug_strdup(referrer);
+		ug_str_set_shared(&http->referrer, referrer);
 
 //	download_by_plugin(data, UgetPluginCurlInfo);
 //	download_by_plugin(data, UgetPluginAria2Info);
@@ -282,7 +284,7 @@ void  start_app (UgetApp* app)
 	common = ug_data_realloc (dnode->data, UgetCommonInfo);
 	common->name = ug_strdup ("Download");
 	common->uri = ug_strdup ("http://www.utorrent.com/scripts/dl.php?track=stable&build=29812&client=utorrent");
-	common->folder = ug_strdup ("D:\\Downloads");
+	ug_str_set_shared (&common->folder, "D:\\Downloads");
 	common->debug_level = 1;
 //	common->keeping.enable = TRUE;
 //	common->keeping.uri = TRUE;
@@ -321,7 +323,7 @@ void  test_app_node (UgetApp* app)
 		dnode[count] = uget_node_new (NULL);
 		common = ug_data_realloc (dnode[count]->data, UgetCommonInfo);
 		common->uri = ug_strdup ("ftp://127.0.0.1/");
-		common->folder = ug_strdup ("D:\\Downloads");
+		ug_str_set_shared (&common->folder, "D:\\Downloads");
 		common->keeping.enable = TRUE;
 		common->keeping.uri = FALSE;
 		common->keeping.folder = FALSE;
@@ -356,6 +358,7 @@ void  test_app (void)
 
 	app = calloc (1, sizeof (UgetApp));
 	uget_app_init (app);
+	uget_app_ref_view (app, &app->mix_split);
 	setup_app (app);
 	start_app (app);
 //	test_app_node (app);
@@ -365,6 +368,392 @@ void  test_app (void)
 	free (app);
 }
 
+// ----------------------------------------------------------------------------
+// test_app_snapshot
+
+static int  compare_files (const char* file1, const char* file2)
+{
+	FILE*  file[2];
+	int    ch[2];
+
+	file[0] = fopen (file1, "rb");
+	file[1] = fopen (file2, "rb");
+	do {
+		ch[0] = (file[0]) ? fgetc (file[0]) : -2;
+		ch[1] = (file[1]) ? fgetc (file[1]) : -3;
+	} while (ch[0] == ch[1] && ch[0] != EOF);
+	if (file[0])
+		fclose (file[0]);
+	if (file[1])
+		fclose (file[1]);
+	return ch[0] - ch[1];
+}
+
+void  add_test_downloads (UgetApp* app, int n_downloads)
+{
+	UgetNode*    dnode;
+	UgetCommon*  common;
+	UgetHttp*    http;
+	int          count;
+
+	for (count = 0;  count < n_downloads;  count++) {
+		dnode = uget_node_new (NULL);
+		common = ug_data_realloc (dnode->data, UgetCommonInfo);
+		common->uri = ug_strdup_printf ("http://test.host%d/file%d.zip", count % 7, count);
+		ug_str_set_shared (&common->folder, "/tmp/downloads");
+		if (count % 4 == 0) {
+			http = ug_data_realloc (dnode->data, UgetHttpInfo);
+			ug_str_set_shared (&http->referrer, "http://test.host/");
+		}
+		uget_app_add_download (app, dnode, NULL, FALSE);
+		if (count % 3 == 0)
+			uget_app_recycle_download (app, dnode);
+	}
+}
+
+void  test_app_snapshot (void)
+{
+	UgetApp*   app[2];
+	UgetNode*  cnode[2];
+	int        count, n_error;
+
+	puts ("\n--- test_app_snapshot:");
+	app[0] = calloc (1, sizeof (UgetApp));
+	uget_app_init (app[0]);
+	ug_create_dir ("test-app");
+	uget_app_set_config_dir (app[0], "test-app");
+	setup_app (app[0]);
+	add_test_downloads (app[0], 500);
+	// rewrite all category files and snapshot
+	app[0]->journal.compact = TRUE;
+	uget_app_save_categories (app[0], NULL);
+	uget_app_wait_categories (app[0]);
+	uget_app_final (app[0]);
+	free (app[0]);
+	printf ("snapshot.bin exist : %d\n",
+	        ug_file_is_exist ("test-app/category/snapshot.bin"));
+
+	// load from snapshot, then load from JSON files
+	for (count = 0;  count < 2;  count++) {
+		if (count == 1)
+			uget_app_snapshot_remove ("test-app/category");
+		app[count] = calloc (1, sizeof (UgetApp));
+		uget_app_init (app[count]);
+		uget_app_load_categories (app[count], "test-app");
+	}
+
+	n_error = 0;
+	cnode[0] = app[0]->real.children;
+	cnode[1] = app[1]->real.children;
+	for (;  cnode[0] && cnode[1];  cnode[0] = cnode[0]->next, cnode[1] = cnode[1]->next) {
+		uget_app_save_category (app[0], cnode[0], "test-snapshot.json", NULL);
+		uget_app_save_category (app[1], cnode[1], "test-json.json", NULL);
+		if (compare_files ("test-snapshot.json", "test-json.json") != 0)
+			n_error++;
+	}
+	if (cnode[0] != cnode[1] || app[0]->real.n_children == 0)
+		n_error++;
+	printf ("categories : %d, error : %d\n", app[0]->real.n_children, n_error);
+
+	for (count = 0;  count < 2;  count++) {
+		uget_app_final (app[count]);
+		free (app[count]);
+	}
+}
+
+// ----------------------------------------------------------------------------
+// test_app_page
+
+static char*  download_to_string (UgetNode* dnode)
+{
+	UgetCommon*  common;
+	UgetHttp*    http;
+
+	common = ug_data_get (dnode->data, UgetCommonInfo);
+	http = ug_data_get (dnode->data, UgetHttpInfo);
+	return ug_strdup_printf ("%s %s %s", common->uri, common->folder,
+	                         (http) ? http->referrer : "");
+}
+
+static void  add_strings (UgArrayPtr* array, UgetNode* dnode)
+{
+	for (;  dnode;  dnode = dnode->next)
+		*(char**) ug_array_alloc (array, 1) = download_to_string (dnode);
+}
+
+void  test_app_page (void)
+{
+	UgetApp*       app;
+	UgetNode*      cnode;
+	UgetNode*      dnode;
+	UgetCategory*  category;
+	UgetRelation*  relation;
+	UgArrayPtr     expected;
+	UgArrayPtr     cold;
+	char*          string;
+	int            count, n_error = 0;
+
+	puts ("\n--- test_app_page:");
+	app = calloc (1, sizeof (UgetApp));
+	uget_app_init (app);
+	uget_app_set_config_dir (app, "test-app");
+	setup_app (app);
+	add_test_downloads (app, 60);
+	cnode = app->real.children;
+	category = ug_data_get (cnode->data, UgetCategoryInfo);
+	ug_array_init (&expected, sizeof (char*), 64);
+	ug_array_init (&cold, sizeof (char*), 64);
+
+	// recycled downloads at tail of category are paged out
+	for (dnode = cnode->children;  dnode;  dnode = dnode->next) {
+		relation = ug_data_get (dnode->data, UgetRelationInfo);
+		if (relation->group & UGET_GROUP_RECYCLED)
+			break;
+	}
+	add_strings (&cold, dnode);
+	count = uget_app_page_out (app, cnode);
+	if (count != cold.length || category->cold.records.length != count)
+		n_error++;
+	printf ("paged out : %d\n", count);
+
+	// page out download that is recycled later, it is in front of records.
+	string = download_to_string (cnode->children);
+	uget_app_recycle_download (app, cnode->children);
+	count = uget_app_page_out (app, cnode);
+	if (count != 1 || category->cold.records.length != cold.length + 1)
+		n_error++;
+	add_strings (&expected, cnode->children);
+	*(char**) ug_array_alloc (&expected, 1) = string;
+	for (count = 0;  count < cold.length;  count++)
+		*(char**) ug_array_alloc (&expected, 1) = cold.at[count];
+
+	// remove more than half of records, buffers are packed.
+	for (count = 0;  count < 12;  count++) {
+		if (uget_app_page_remove (app, cnode, UGET_GROUP_RECYCLED) == FALSE)
+			n_error++;
+		ug_free (expected.at[--expected.length]);
+	}
+	if (category->cold.n_packed == cold.length + 1)
+		n_error++;
+	printf ("records : %d\n", category->cold.records.length);
+
+	// page in and compare order and data
+	count = uget_app_page_in (app, cnode);
+	if (count != 9 || cnode->n_children != expected.length)
+		n_error++;
+	for (count = 0, dnode = cnode->children;  dnode;  dnode = dnode->next) {
+		string = download_to_string (dnode);
+		if (count >= expected.length || strcmp (string, expected.at[count++]) != 0)
+			n_error++;
+		ug_free (string);
+	}
+	// category was paged in, it will not be paged out again.
+	if (uget_app_page_out (app, cnode) != 0)
+		n_error++;
+	printf ("paged in : %d, error : %d\n", cnode->n_children, n_error);
+
+	ug_array_foreach_str (&expected, (UgForeachFunc) ug_free, NULL);
+	ug_array_clear (&expected);
+	ug_array_clear (&cold);
+	uget_app_final (app);
+	free (app);
+}
+
+// finish download like uget_app_activate() does.
+static void  finish_download (UgetApp* app, UgetNode* dnode)
+{
+	UgetCategory*  category;
+	UgetRelation*  relation;
+	UgetNode*      cnode;
+	UgetNode*      sibling;
+
+	cnode = dnode->parent;
+	category = ug_data_get (cnode->data, UgetCategoryInfo);
+	relation = ug_data_realloc (dnode->data, UgetRelationInfo);
+	uget_node_remove (cnode, dnode);
+	uget_node_clear_fake (dnode);
+	relation->group = UGET_GROUP_FINISHED;
+	sibling = category->finished->children;
+	if (sibling == NULL)
+		sibling = category->recycled->children;
+	if (sibling)
+		sibling = sibling->real;
+	uget_node_insert (cnode, sibling, dnode);
+}
+
+void  test_app_page_order (void)
+{
+	UgetApp*       app;
+	UgetNode*      cnode;
+	UgetNode*      dnode;
+	UgetCategory*  category;
+	UgetRelation*  relation;
+	int            count, recycled, n_error = 0;
+
+	puts ("\n--- test_app_page_order:");
+	app = calloc (1, sizeof (UgetApp));
+	uget_app_init (app);
+	uget_app_set_config_dir (app, "test-app");
+	setup_app (app);
+	add_test_downloads (app, 9);
+	cnode = app->real.children;
+	category = ug_data_get (cnode->data, UgetCategoryInfo);
+	finish_download (app, cnode->children);
+	finish_download (app, cnode->children);
+	count = uget_app_page_out (app, cnode);
+	if (count != 5)
+		n_error++;
+
+	// these downloads are placed at tail of category before page in
+	finish_download (app, cnode->children);
+	uget_app_recycle_download (app, cnode->children);
+	count = uget_app_page_in (app, cnode);
+
+	// finished downloads must be in front of recycled downloads
+	for (recycled = FALSE, dnode = cnode->children;  dnode;  dnode = dnode->next) {
+		relation = ug_data_get (dnode->data, UgetRelationInfo);
+		if (relation->group & UGET_GROUP_RECYCLED)
+			recycled = TRUE;
+		else if (recycled)
+			n_error++;
+	}
+	if (category->finished->n_children != 3 || category->recycled->n_children != 4)
+		n_error++;
+	printf ("paged in : %d, error : %d\n", count, n_error);
+
+	uget_app_final (app);
+	free (app);
+}
+
+// ----------------------------------------------------------------------------
+// test_app_journal
+
+static void  add_all_strings (UgetApp* app, UgArrayPtr* array)
+{
+	UgetNode*  cnode;
+
+	uget_app_page_in (app, NULL);
+	for (cnode = app->real.children;  cnode;  cnode = cnode->next)
+		add_strings (array, cnode->children);
+}
+
+static int  compare_strings (UgArrayPtr* array1, UgArrayPtr* array2)
+{
+	int  index;
+
+	if (array1->length != array2->length)
+		return 1;
+	for (index = 0;  index < array1->length;  index++) {
+		if (strcmp (array1->at[index], array2->at[index]) != 0)
+			return 1;
+	}
+	return 0;
+}
+
+void  test_app_journal (void)
+{
+	UgetApp*     app;
+	UgetNode*    cnode;
+	UgetNode*    dnode;
+	UgetNode*    head;
+	UgetCommon*  common;
+	UgArrayPtr   expected;
+	UgArrayPtr   exported;
+	UgArrayPtr   loaded;
+	char*        path;
+	FILE*        file;
+	int          count, n_error = 0;
+
+	puts ("\n--- test_app_journal:");
+	app = calloc (1, sizeof (UgetApp));
+	uget_app_init (app);
+	uget_app_set_config_dir (app, "test-journal");
+	// empty category is in front of downloads
+	cnode = uget_node_new (NULL);
+	common = ug_data_realloc (cnode->data, UgetCommonInfo);
+	common->name = ug_strdup ("Empty Category");
+	uget_app_add_category (app, cnode, TRUE);
+	setup_app (app);
+	add_test_downloads (app, 30);
+	app->journal.compact = TRUE;
+	uget_app_save_categories (app, NULL);
+	uget_app_wait_categories (app);
+	path = ug_strdup (app->journal.path);
+
+	// move 3 downloads to head, loader moves them together.
+	cnode = app->real.last;
+	head = cnode->children;
+	for (count = 0;  count < 3;  count++)
+		uget_app_move_download (app, uget_node_nth_child (cnode, 5), head);
+	uget_app_delete_download (app, uget_node_nth_child (cnode, 10), FALSE);
+	add_test_downloads (app, 2);
+	dnode = uget_node_nth_child (cnode, 12);
+	common = ug_data_get (dnode->data, UgetCommonInfo);
+	ug_str_set_shared (&common->folder, "/tmp/changed");
+	uget_app_journal_changed (app, dnode);
+	uget_app_save_categories (app, NULL);
+	uget_app_wait_categories (app);
+	if (app->journal.n_records == 0)
+		n_error++;
+
+	// export categories, journal stays in it's folder.
+	uget_app_save_categories (app, "test-journal/export");
+	uget_app_wait_categories (app);
+	if (strcmp (path, app->journal.path) != 0)
+		n_error++;
+	ug_array_init (&exported, sizeof (char*), 64);
+	add_all_strings (app, &exported);
+	count = app->journal.n_records;
+	uget_app_move_download (app, cnode->last, cnode->children);
+	uget_app_save_categories (app, NULL);
+	uget_app_wait_categories (app);
+	if (app->journal.n_records <= count)
+		n_error++;
+	printf ("records : %d\n", app->journal.n_records);
+
+	ug_array_init (&expected, sizeof (char*), 64);
+	add_all_strings (app, &expected);
+	uget_app_final (app);
+	free (app);
+
+	// load from journal folder and exported folder
+	for (count = 0;  count < 2;  count++) {
+		app = calloc (1, sizeof (UgetApp));
+		uget_app_init (app);
+		if (count == 0)
+			uget_app_load_categories (app, "test-journal");
+		else
+			uget_app_load_categories (app, "test-journal/export");
+		ug_array_init (&loaded, sizeof (char*), 64);
+		add_all_strings (app, &loaded);
+		if (compare_strings ((count == 0) ? &expected : &exported, &loaded) != 0)
+			n_error++;
+		ug_array_foreach_str (&loaded, (UgForeachFunc) ug_free, NULL);
+		ug_array_clear (&loaded);
+		uget_app_final (app);
+		free (app);
+	}
+
+	// empty category is broken, journal can't be applied to other category.
+	file = fopen ("test-journal/category/0000.json", "w");
+	fputs ("broken", file);
+	fclose (file);
+	app = calloc (1, sizeof (UgetApp));
+	uget_app_init (app);
+	uget_app_load_categories (app, "test-journal");
+	if (app->real.n_children != 1 || app->journal.compact == FALSE)
+		n_error++;
+	uget_app_final (app);
+	free (app);
+	printf ("downloads : %d, error : %d\n", expected.length, n_error);
+
+	ug_array_foreach_str (&expected, (UgForeachFunc) ug_free, NULL);
+	ug_array_foreach_str (&exported, (UgForeachFunc) ug_free, NULL);
+	ug_array_clear (&expected);
+	ug_array_clear (&exported);
+	ug_free (path);
+}
+
 // ----------------------------------------------------------------------------
 // main
 
@@ -377,6 +766,10 @@ int   main (void)
 	uget_plugin_global_set(UgetPluginMegaInfo, UGET_PLUGIN_GLOBAL_INIT, (void*) TRUE);
 //	test_setup_plugin_aria2();
 
+	test_app_snapshot();
+	test_app_page();
+	test_app_page_order();
+	test_app_journal();
 	test_download();
 //	test_task();
 //	test_app();
@@ -43,6 +43,7 @@
 #include <UgString.h>
 #include <UgGroupData.h>
 #include <UgetFiles.h>
+#include <UgetHash.h>
 //#include <UgetPlugin.h>
 
 #include <UgetA2cf.h>
@@ -249,6 +250,197 @@ void test_uget_node ()
 	write_node_to_file (root, "test-UgetNode.json");
 }
 
+static int  check_node_order (UgetNode* parent, int reversed)
+{
+	UgetNode* cur;
+	int       n_error = 0;
+
+	for (cur = parent->children;  cur && cur->next;  cur = cur->next) {
+		if (reversed == FALSE && uget_node_compare_size (cur, cur->next) > 0)
+			n_error++;
+		if (reversed == TRUE  && uget_node_compare_size (cur->next, cur) > 0)
+			n_error++;
+	}
+	return n_error;
+}
+
+void test_node_sort ()
+{
+	struct UgetNodeControl  control;
+	UgetProgress* progress;
+	UgetNode*     root;
+	UgetNode*     node;
+	int           index;
+
+	puts ("\n--- test_node_sort:");
+	root = uget_node_new (NULL);
+	for (index = 0;  index < 2000;  index++) {
+		node = uget_node_new (NULL);
+		progress = ug_data_realloc (node->data, UgetProgressInfo);
+		progress->total = (index * 7919) % 1000;
+		uget_node_append (root, node);
+	}
+	uget_node_sort (root, (UgCompareFunc) uget_node_compare_size, FALSE);
+	printf ("uget_node_sort() error : %d\n", check_node_order (root, FALSE));
+	uget_node_sort (root, (UgCompareFunc) uget_node_compare_size, TRUE);
+	printf ("uget_node_sort() reversed error : %d\n", check_node_order (root, TRUE));
+
+	control = *root->control;
+	control.sort.compare = (UgCompareFunc) uget_node_compare_size;
+	control.sort.reverse = TRUE;
+	root->control = &control;
+	for (index = 0;  index < 500;  index++) {
+		node = uget_node_new (NULL);
+		progress = ug_data_realloc (node->data, UgetProgressInfo);
+		progress->total = (index * 104729) % 1200;
+		uget_node_insert_sorted (root, node);
+	}
+	printf ("uget_node_insert_sorted() error : %d, n_children : %d\n",
+	        check_node_order (root, TRUE), root->n_children);
+	uget_node_free (root);
+}
+
+// ----------------------------------------------------------------------------
+// UgetLog
+
+static void  log_add_string (UgetLog* log, const char* string)
+{
+	uget_log_add (log, uget_event_new_warning (0, (char*) string));
+}
+
+void test_log ()
+{
+	UgetNode*   node;
+	UgetLog*    log;
+	UgetEvent*  event;
+	char        string[16];
+	int         index, n_error = 0;
+
+	puts ("\n--- test_log:");
+	node = uget_node_new (NULL);
+	log = ug_data_realloc (node->data, UgetLogInfo);
+
+	// repeated message is coalesced and count how many times it happened
+	for (index = 0;  index < 5;  index++)
+		log_add_string (log, "A");
+	event = (UgetEvent*) log->messages.head;
+	if (log->messages.size != 1 || event->repeats != 4)
+		n_error++;
+
+	// matching message in recent messages become the newest one
+	log_add_string (log, "B");
+	log_add_string (log, "C");
+	log_add_string (log, "A");
+	event = (UgetEvent*) log->messages.head;
+	if (log->messages.size != 3 || strcmp (event->string, "A") != 0 ||
+	    event->repeats != 5 || event->first_time > event->time)
+		n_error++;
+	// message older than UGET_LOG_RECENT is not coalesced
+	for (index = 0;  index < UGET_LOG_RECENT;  index++) {
+		sprintf (string, "D%d", index);
+		log_add_string (log, string);
+	}
+	log_add_string (log, "B");
+	event = (UgetEvent*) log->messages.head;
+	if (log->messages.size != 4 + UGET_LOG_RECENT || event->repeats != 0)
+		n_error++;
+
+	// log is capped, the oldest messages are dropped
+	for (index = 0;  index < 100;  index++) {
+		sprintf (string, "E%d", index);
+		log_add_string (log, string);
+		log_add_string (log, string);
+	}
+	event = (UgetEvent*) log->messages.head;
+	if (log->messages.size != UGET_LOG_CAPACITY ||
+	    strcmp (event->string, "E99") != 0 || event->repeats != 1)
+		n_error++;
+	event = (UgetEvent*) log->messages.tail;
+	sprintf (string, "E%d", 100 - UGET_LOG_CAPACITY);
+	if (strcmp (event->string, string) != 0)
+		n_error++;
+
+	// capacity can be changed
+	uget_log_set_capacity (4);
+	log_add_string (log, "F");
+	if (log->messages.size != 4)
+		n_error++;
+	uget_log_set_capacity (UGET_LOG_CAPACITY);
+
+	uget_node_free (node);
+	printf ("error : %d\n", n_error);
+}
+
+// ----------------------------------------------------------------------------
+// UgetHash
+
+static int  check_uri_hash (void* uhash, int beg, int end, int found)
+{
+	char  uri[64];
+	int   n_error = 0;
+
+	for (;  beg < end;  beg++) {
+		sprintf (uri, "http://host%d.test/path/file%d.zip", beg % 97, beg);
+		if (uget_uri_hash_find (uhash, uri) != found)
+			n_error++;
+	}
+	return n_error;
+}
+
+void test_uri_hash ()
+{
+	void*  uhash;
+	char   uri[64];
+	int    index, n_error = 0;
+
+	puts ("\n--- test_uri_hash:");
+	uhash = uget_uri_hash_new ();
+
+	// growth: table resize when it is 7/8 full, check all URIs near limit
+	for (index = 0;  index < 3000;  index++) {
+		sprintf (uri, "http://host%d.test/path/file%d.zip", index % 97, index);
+		uget_uri_hash_add (uhash, uri);
+		if (index < 600 && (index % 7 == 0 || index % 8 == 0))
+			n_error += check_uri_hash (uhash, 0, index + 1, TRUE);
+	}
+	n_error += check_uri_hash (uhash, 0, 3000, TRUE);
+	n_error += check_uri_hash (uhash, 3000, 4000, FALSE);
+
+	// erase & insert: removed slots are reused and probing still works
+	for (index = 0;  index < 100000;  index++) {
+		sprintf (uri, "http://host%d.test/path/file%d.zip", index % 97, index);
+		uget_uri_hash_remove (uhash, uri);
+		sprintf (uri, "http://host%d.test/path/file%d.zip", (index + 3000) % 97, index + 3000);
+		uget_uri_hash_add (uhash, uri);
+		if (index % 3000 == 2999) {
+			n_error += check_uri_hash (uhash, index - 2999, index + 1, FALSE);
+			n_error += check_uri_hash (uhash, index + 1, index + 3001, TRUE);
+		}
+	}
+	uget_uri_hash_free (uhash);
+
+	// duplicate URIs count references, canonical form is compared
+	uhash = uget_uri_hash_new ();
+	uget_uri_hash_add (uhash, "http://example.com/file.zip");
+	uget_uri_hash_add (uhash, "HTTP://Example.COM:80/file.zip");
+	uget_uri_hash_add (uhash, "http://example.com/file.zip?utm_source=test");
+	uget_uri_hash_remove (uhash, "http://example.com/file.zip");
+	uget_uri_hash_remove (uhash, "http://example.com:80/file.zip");
+	if (uget_uri_hash_find (uhash, "http://example.com/file.zip") == FALSE)
+		n_error++;
+	uget_uri_hash_remove (uhash, "http://EXAMPLE.com/file.zip");
+	if (uget_uri_hash_find (uhash, "http://example.com/file.zip") == TRUE)
+		n_error++;
+	// remove URI that is not in table
+	uget_uri_hash_remove (uhash, "http://example.com/file.zip");
+	uget_uri_hash_add (uhash, "http://example.com/file.zip");
+	if (uget_uri_hash_find (uhash, "http://example.com/file.zip") == FALSE)
+		n_error++;
+	uget_uri_hash_free (uhash);
+
+	printf ("error : %d\n", n_error);
+}
+
 // ----------------------------------------------------------------------------
 // UgetA2cf
 
@@ -563,6 +755,9 @@ int main (void)
 {
 //	test_uget_node ();
 //	test_fake_path ();
+	test_node_sort ();
+	test_log ();
+	test_uri_hash ();
 
 //	test_uget_a2cf ();
 //	test_uget_curl ();
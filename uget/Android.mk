@@ -20,6 +20,9 @@ LOCAL_SRC_FILES  := \
 	UgetHash.c    \
 	UgetSite.c    \
 	UgetApp.c     \
+	UgetApp-journal.c   \
+	UgetApp-snapshot.c  \
+	UgetApp-cold.c      \
 	UgetEvent.c   \
 	UgetPlugin.c  \
 	UgetA2cf.c    \
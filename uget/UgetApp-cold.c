@@ -0,0 +1,383 @@
+/*
+ *
+ *   Copyright (C) 2012-2018 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  In addition, as a special exception, the copyright holders give
+ *  permission to link the code of portions of this program with the
+ *  OpenSSL library under certain conditions as described in each
+ *  individual source file, and distribute linked combinations
+ *  including the two.
+ *  You must obey the GNU Lesser General Public License in all respects
+ *  for all of the code used other than OpenSSL.  If you modify
+ *  file(s) with this exception, you may extend this exception to your
+ *  version of the file(s), but you are not obligated to do so.  If you
+ *  do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source
+ *  files in the program, then also delete it here.
+ *
+ */
+
+#include <string.h>
+#include <UgUtil.h>
+#include <UgString.h>
+#include <UgetApp.h>
+#include <UgetData.h>
+#include <UgetHash.h>
+
+#define COLD_GROUP    (UGET_GROUP_FINISHED | UGET_GROUP_RECYCLED)
+
+// download can be paged out if it will not run and journal has it's data.
+static int  is_cold (UgetApp* app, UgetRelation* relation)
+{
+	if ((relation->group & COLD_GROUP) == 0 ||
+	    (relation->group & UGET_GROUP_ACTIVE))
+		return FALSE;
+	if (app->journal.fd != -1) {
+		if (relation->journal.id == 0 || relation->journal.dirty ||
+		    relation->journal.group != relation->group)
+			return FALSE;
+	}
+	return TRUE;
+}
+
+static uint32_t  cold_string (UgetSnapshotWriter* writer, const char* string)
+{
+	if (string == NULL)
+		return UGET_COLD_NULL;
+	return uget_snapshot_write_string (writer, string);
+}
+
+static void  cold_clear (struct UgetCategoryCold* cold)
+{
+	ug_array_clear (&cold->records);
+	ug_buffer_clear (&cold->strings, TRUE);
+	ug_buffer_clear (&cold->nodes, TRUE);
+	ug_array_clear (&cold->groups);
+	cold->n_finished = 0;
+	cold->n_recycled = 0;
+	cold->n_packed = 0;
+}
+
+// free unused space
+static void  cold_trim (struct UgetCategoryCold* cold)
+{
+	ug_buffer_set_size (&cold->strings, ug_buffer_length (&cold->strings));
+	ug_buffer_set_size (&cold->nodes, ug_buffer_length (&cold->nodes));
+	cold->records.at = ug_realloc (cold->records.at,
+			cold->records.length * sizeof (UgetColdRecord));
+	cold->records.allocated = cold->records.length;
+}
+
+static uint32_t  cold_repack_string (struct UgetCategoryCold* cold,
+                                     UgetSnapshotWriter* writer, uint32_t offset)
+{
+	return cold_string (writer, uget_cold_string (cold, offset));
+}
+
+// removed records left their strings and nodes in buffers,
+// pack remaining records to new buffers.
+static void  cold_repack (struct UgetCategoryCold* cold)
+{
+	struct UgetCategoryCold  packed;
+	UgetSnapshotWriter* writer;
+	UgetColdRecord* record;
+	UgetNode*       dnode;
+	int             index;
+
+	ug_buffer_init (&packed.strings, ug_buffer_length (&cold->strings) / 2 + 64);
+	ug_buffer_init (&packed.nodes, ug_buffer_length (&cold->nodes) / 2 + 64);
+	ug_array_init (&packed.groups, sizeof (void*), cold->groups.length);
+	writer = uget_snapshot_writer_new (&packed.strings, &packed.nodes, &packed.groups);
+	for (index = 0;  index < cold->records.length;  index++) {
+		record = cold->records.at + index;
+		dnode = uget_snapshot_read_node (&cold->strings, &cold->nodes,
+		                                 &cold->groups, record->node, NULL);
+		record->name   = cold_repack_string (cold, writer, record->name);
+		record->uri    = cold_repack_string (cold, writer, record->uri);
+		record->folder = cold_repack_string (cold, writer, record->folder);
+		record->file   = cold_repack_string (cold, writer, record->file);
+		record->cookie_file = cold_repack_string (cold, writer, record->cookie_file);
+		record->post_file   = cold_repack_string (cold, writer, record->post_file);
+		if (dnode) {
+			record->node = uget_snapshot_write_node (writer, dnode);
+			uget_node_free (dnode);
+		}
+		else
+			record->node = UGET_COLD_NULL;
+	}
+	uget_snapshot_writer_free (writer);
+
+	ug_buffer_clear (&cold->strings, TRUE);
+	ug_buffer_clear (&cold->nodes, TRUE);
+	ug_array_clear (&cold->groups);
+	cold->strings = packed.strings;
+	cold->nodes   = packed.nodes;
+	cold->groups  = packed.groups;
+	cold->n_packed = cold->records.length;
+	cold_trim (cold);
+}
+
+// fill summary of download and pack it's node
+static void  cold_add (struct UgetCategoryCold* cold, UgetSnapshotWriter* writer,
+                       UgetColdRecord* record, UgetNode* dnode)
+{
+	UgetRelation*   relation;
+	const UgetCommon* common;
+	UgetProgress*   progress;
+	UgetLog*        log;
+	const UgetHttp* http;
+
+	memset (record, 0, sizeof (UgetColdRecord));
+	relation = ug_data_get (dnode->data, UgetRelationInfo);
+	record->group = relation->group;
+	record->id = relation->journal.id;
+	if (relation->group & UGET_GROUP_FINISHED)
+		cold->n_finished++;
+	if (relation->group & UGET_GROUP_RECYCLED)
+		cold->n_recycled++;
+
+	common = ug_data_get (dnode->data, UgetCommonInfo);
+	record->name   = cold_string (writer, common ? common->name : NULL);
+	record->uri    = cold_string (writer, common ? common->uri : NULL);
+	record->folder = cold_string (writer, common ? common->folder : NULL);
+	record->file   = cold_string (writer, common ? common->file : NULL);
+	if ((progress = ug_data_get (dnode->data, UgetProgressInfo)) != NULL)
+		record->total = progress->total;
+	if ((log = ug_data_get (dnode->data, UgetLogInfo)) != NULL) {
+		record->added_time = log->added_time;
+		record->completed_time = log->completed_time;
+	}
+	// uget_app_clear_attachment() use these
+	http = ug_data_get (dnode->data, UgetHttpInfo);
+	record->cookie_file = cold_string (writer, http ? http->cookie_file : NULL);
+	record->post_file   = cold_string (writer, http ? http->post_file : NULL);
+
+	record->node = uget_snapshot_write_node (writer, dnode);
+}
+
+int   uget_app_page_out (UgetApp* app, UgetNode* cnode)
+{
+	struct UgetCategoryCold*  cold;
+	UgetSnapshotWriter* writer;
+	UgetCategory* category;
+	UgetRelation* relation;
+	UgetNode*     dnode;
+	UgetNode*     first;
+	int           count, index;
+
+	category = ug_data_get (cnode->data, UgetCategoryInfo);
+	if (category == NULL || category->cold.resident)
+		return 0;
+	cold = &category->cold;
+
+	// find downloads at tail of category
+	count = 0;
+	for (first = NULL, dnode = cnode->last;  dnode;  dnode = dnode->prev) {
+		relation = ug_data_get (dnode->data, UgetRelationInfo);
+		if (relation == NULL || is_cold (app, relation) == FALSE)
+			break;
+		first = dnode;
+		count++;
+	}
+	if (first == NULL)
+		return 0;
+
+	if (cold->strings.beg == NULL) {
+		ug_buffer_init (&cold->strings, 4096);
+		ug_buffer_init (&cold->nodes, 4096);
+	}
+	// these downloads are in front of records that were paged out before.
+	ug_array_alloc (&cold->records, count);
+	memmove (cold->records.at + count, cold->records.at,
+	         (cold->records.length - count) * sizeof (UgetColdRecord));
+
+	writer = uget_snapshot_writer_new (&cold->strings, &cold->nodes, &cold->groups);
+	for (index = 0;  first;  index++) {
+		dnode = first;
+		first = first->next;
+		cold_add (cold, writer, cold->records.at + index, dnode);
+		uget_node_remove (cnode, dnode);
+		uget_node_free (dnode);
+	}
+	uget_snapshot_writer_free (writer);
+
+	cold->n_packed += count;
+	cold_trim (cold);
+	return count;
+}
+
+static int  page_in_category (UgetApp* app, UgetNode* cnode)
+{
+	struct UgetCategoryCold*  cold;
+	UgetColdRecord* record;
+	UgetCategory* category;
+	UgetRelation* relation;
+	UgetNode*     dnode;
+	UgetNode*     sibling;
+	int           index, prev, moved;
+
+	category = ug_data_get (cnode->data, UgetCategoryInfo);
+	if (category == NULL)
+		return 0;
+	// uget_app_page_out() will not page out this category again.
+	category->cold.resident = TRUE;
+	if (category->cold.records.length == 0)
+		return 0;
+	cold = &category->cold;
+
+	// journal placed these downloads after all loaded downloads
+	if (cnode->last) {
+		relation = ug_data_realloc (cnode->last->data, UgetRelationInfo);
+		prev = relation->journal.id;
+	}
+	else
+		prev = -(uget_node_child_position (&app->real, cnode) + 1);
+
+	// finished downloads must be placed before loaded recycled downloads
+	sibling = NULL;
+	for (dnode = cnode->last;  dnode;  dnode = dnode->prev) {
+		relation = ug_data_get (dnode->data, UgetRelationInfo);
+		if (relation == NULL || (relation->group & UGET_GROUP_RECYCLED) == 0)
+			break;
+		sibling = dnode;
+	}
+
+	for (moved = FALSE, index = 0;  index < cold->records.length;  index++) {
+		record = cold->records.at + index;
+		dnode = uget_snapshot_read_node (&cold->strings, &cold->nodes,
+		                                 &cold->groups, record->node,
+		                                 cnode->data->slice);
+		if (dnode == NULL)
+			continue;
+		// convert old format to new
+		while (dnode->children)
+			uget_node_free (dnode->children);
+
+		relation = ug_data_realloc (dnode->data, UgetRelationInfo);
+		relation->journal.id    = record->id;
+		relation->journal.group = relation->group;
+		relation->journal.dirty = FALSE;
+		if (sibling && (relation->group & UGET_GROUP_RECYCLED) == 0) {
+			uget_node_insert (cnode, sibling, dnode);
+			moved = TRUE;
+		}
+		else
+			uget_node_append (cnode, dnode);
+		// 0 is not a valid position, journal will write "move" for
+		// paged-in downloads that are not in their recorded position.
+		relation->journal.prev  = (moved) ? 0 : prev;
+		prev = relation->journal.id;
+	}
+
+	cold_clear (cold);
+	return index;
+}
+
+int   uget_app_page_in (UgetApp* app, UgetNode* cnode)
+{
+	int  count;
+
+	if (cnode)
+		return page_in_category (app, cnode);
+
+	count = 0;
+	for (cnode = app->real.children;  cnode;  cnode = cnode->next)
+		count += page_in_category (app, cnode);
+	return count;
+}
+
+int   uget_app_page_remove (UgetApp* app, UgetNode* cnode, int group)
+{
+	struct UgetCategoryCold*  cold;
+	UgetColdRecord* record;
+	UgetCategory* category;
+	int           index;
+
+	category = ug_data_get (cnode->data, UgetCategoryInfo);
+	if (category == NULL)
+		return FALSE;
+	cold = &category->cold;
+
+	for (index = cold->records.length - 1;  index >= 0;  index--) {
+		if (cold->records.at[index].group & group)
+			break;
+	}
+	if (index < 0)
+		return FALSE;
+
+	record = cold->records.at + index;
+	if (app->uri_hash)
+		uget_uri_hash_remove (app->uri_hash, uget_cold_string (cold, record->uri));
+	if (app->journal.fd != -1 && record->id > 0)
+		*(int*) ug_array_alloc (&app->journal.removed, 1) = record->id;
+	if (record->group & UGET_GROUP_FINISHED)
+		cold->n_finished--;
+	if (record->group & UGET_GROUP_RECYCLED)
+		cold->n_recycled--;
+
+	// free or pack buffers if most of records were removed
+	ug_array_erase (&cold->records, index, 1);
+	if (cold->records.length == 0)
+		cold_clear (cold);
+	else if (cold->records.length * 2 < cold->n_packed)
+		cold_repack (cold);
+	return TRUE;
+}
+
+static int  cold_count (struct UgetCategoryCold* cold, int group)
+{
+	switch (group) {
+	case UGET_GROUP_NULL:
+		return cold->records.length;
+
+	case UGET_GROUP_FINISHED:
+		return cold->n_finished;
+
+	case UGET_GROUP_RECYCLED:
+		return cold->n_recycled;
+
+	default:
+		return 0;
+	}
+}
+
+int   uget_app_count_paged_out (UgetNode* node)
+{
+	UgetCategory* category;
+	UgetNode*     cnode;
+	int           group, count;
+
+	group = uget_node_get_group (node);
+	category = ug_data_get (node->base->data, UgetCategoryInfo);
+	if (category)
+		return cold_count (&category->cold, group);
+
+	// "All Category" is not in UgetApp::real, count all categories in it.
+	for (cnode = node;  cnode->parent;  cnode = cnode->parent)
+		;
+	while (cnode->real)
+		cnode = cnode->real;
+	for (count = 0, cnode = cnode->children;  cnode;  cnode = cnode->next) {
+		category = ug_data_get (cnode->data, UgetCategoryInfo);
+		if (category)
+			count += cold_count (&category->cold, group);
+	}
+	return count;
+}
@@ -0,0 +1,705 @@
+/*
+ *
+ *   Copyright (C) 2012-2018 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  In addition, as a special exception, the copyright holders give
+ *  permission to link the code of portions of this program with the
+ *  OpenSSL library under certain conditions as described in each
+ *  individual source file, and distribute linked combinations
+ *  including the two.
+ *  You must obey the GNU Lesser General Public License in all respects
+ *  for all of the code used other than OpenSSL.  If you modify
+ *  file(s) with this exception, you may extend this exception to your
+ *  version of the file(s), but you are not obligated to do so.  If you
+ *  do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source
+ *  files in the program, then also delete it here.
+ *
+ */
+
+#include <stddef.h>     // offsetof()
+#include <string.h>
+#include <UgUtil.h>
+#include <UgStdio.h>
+#include <UgEntry.h>
+#include <UgetApp.h>
+#include <UgetData.h>
+
+#define JOURNAL_FILE          "journal.json"
+#define JOURNAL_LIMIT_MIN     1024       // minimum number of records
+#define JOURNAL_FLUSH_SIZE    65536      // flush buffer if it is full
+
+// ----------------------------------------------------------------------------
+// UgetJournalRecord: one line of journal file
+
+typedef struct UgetJournalRecord  UgetJournalRecord;
+
+struct UgetJournalRecord
+{
+	char*       op;
+	int         id;
+	int         category;
+	int         after;
+	UgArrayInt  ids;
+	UgetNode*   node;     // "data" was parsed to this node
+};
+
+typedef UG_ARRAY(UgetJournalRecord)  UgetJournalRecords;
+
+static UgJsonError ug_json_parse_journal_data (UgJson* json,
+                                   const char* name, const char* value,
+                                   void* pnode, void* none);
+
+static const UgEntry  UgetJournalRecordEntry[] =
+{
+	{"op",       offsetof (UgetJournalRecord, op),       UG_ENTRY_STRING,
+			NULL, NULL},
+	{"id",       offsetof (UgetJournalRecord, id),       UG_ENTRY_INT,
+			NULL, NULL},
+	{"category", offsetof (UgetJournalRecord, category), UG_ENTRY_INT,
+			NULL, NULL},
+	{"after",    offsetof (UgetJournalRecord, after),    UG_ENTRY_INT,
+			NULL, NULL},
+	{"ids",      offsetof (UgetJournalRecord, ids),      UG_ENTRY_ARRAY,
+			ug_json_parse_array_int, ug_json_write_array_int},
+	{"data",     offsetof (UgetJournalRecord, node),     UG_ENTRY_CUSTOM,
+			ug_json_parse_journal_data, NULL},
+	{NULL}    // null-terminated
+};
+
+static void  record_init (UgetJournalRecord* record)
+{
+	memset (record, 0, sizeof (UgetJournalRecord));
+	ug_array_init (&record->ids, sizeof (int), 0);
+}
+
+static void  record_final (UgetJournalRecord* record)
+{
+	ug_free (record->op);
+	ug_array_clear (&record->ids);
+	if (record->node)
+		uget_node_free (record->node);
+}
+
+static UgJsonError ug_json_parse_journal_data (UgJson* json,
+                                   const char* name, const char* value,
+                                   void* pnode, void* none)
+{
+	UgetNode*  node;
+
+	if (json->type != UG_JSON_OBJECT)
+		return UG_JSON_ERROR_TYPE_NOT_MATCH;
+
+	node = *(UgetNode**) pnode;
+	if (node == NULL) {
+		node = uget_node_new (NULL);
+		*(UgetNode**) pnode = node;
+	}
+	return ug_json_parse_data_ptr (json, name, value,
+	                               (void**) &node->data, NULL);
+}
+
+// ----------------------------------------------------------------------------
+// UgetJournalWriter: write records to buffer and flush it to file
+
+typedef struct
+{
+	UgJson    json;
+	UgBuffer  buffer;
+	int       fd;
+	int       n_records;
+} UgetJournalWriter;
+
+static void  writer_init (UgetJournalWriter* writer, int fd)
+{
+	ug_json_init (&writer->json);
+	ug_buffer_init (&writer->buffer, 4096);
+	writer->fd = fd;
+	writer->n_records = 0;
+}
+
+static void  writer_final (UgetJournalWriter* writer)
+{
+	ug_buffer_clear (&writer->buffer, TRUE);
+	ug_json_final (&writer->json);
+}
+
+static void  writer_flush (UgetJournalWriter* writer)
+{
+	UgBuffer*  buffer = &writer->buffer;
+
+	if (buffer->cur > buffer->beg)
+		ug_write (writer->fd, buffer->beg, ug_buffer_length (buffer));
+	buffer->cur = buffer->beg;
+}
+
+static void  write_head (UgetJournalWriter* writer, const char* op, int id)
+{
+	ug_json_begin_write (&writer->json, UG_JSON_FORMAT_UTF8, &writer->buffer);
+	ug_json_write_object_head (&writer->json);
+	ug_json_write_string (&writer->json, "op");
+	ug_json_write_string (&writer->json, op);
+	if (id) {
+		ug_json_write_string (&writer->json, "id");
+		ug_json_write_int (&writer->json, id);
+	}
+}
+
+static void  write_tail (UgetJournalWriter* writer)
+{
+	ug_json_write_object_tail (&writer->json);
+	ug_json_end_write (&writer->json);
+	ug_buffer_write_char (&writer->buffer, '\n');
+	writer->n_records++;
+
+	if (ug_buffer_length (&writer->buffer) >= JOURNAL_FLUSH_SIZE)
+		writer_flush (writer);
+}
+
+static void  write_position (UgetJournalWriter* writer, int nth, int after)
+{
+	ug_json_write_string (&writer->json, "category");
+	ug_json_write_int (&writer->json, nth);
+	ug_json_write_string (&writer->json, "after");
+	ug_json_write_int (&writer->json, (after > 0) ? after : 0);
+}
+
+static void  write_data (UgetJournalWriter* writer, UgetNode* node)
+{
+	ug_json_write_string (&writer->json, "data");
+	ug_json_write_data_ptr (&writer->json, &node->data);
+}
+
+// replace content of journal file by one record
+static void  journal_reset (int fd, const char* op, int id)
+{
+	UgetJournalWriter  writer;
+
+	ug_truncate (fd, 0);
+	ug_seek (fd, 0, SEEK_SET);
+	writer_init (&writer, fd);
+	write_head (&writer, op, id);
+	write_tail (&writer);
+	writer_flush (&writer);
+	writer_final (&writer);
+	ug_sync (fd);
+}
+
+static void  journal_open (UgetAppJournal* journal, const char* path_base)
+{
+	char*  path;
+
+	path = ug_build_filename (path_base, JOURNAL_FILE, NULL);
+	if (journal->path && strcmp (journal->path, path) == 0 && journal->fd != -1) {
+		ug_free (path);
+		return;
+	}
+	if (journal->fd != -1)
+		ug_close (journal->fd);
+	ug_free (journal->path);
+	journal->path = path;
+	journal->fd = ug_open (path, UG_O_CREAT | UG_O_WRONLY | UG_O_BINARY,
+			UG_S_IREAD | UG_S_IWRITE | UG_S_IRGRP | UG_S_IROTH);
+}
+
+// set journal state of downloads in category.
+// If 'id' is not NULL, give new id to downloads.
+static void  mark_category (UgetNode* cnode, int nth, int* id)
+{
+	UgetRelation* relation;
+	UgetNode*     dnode;
+	int           prev;
+
+	prev = -(nth + 1);
+	for (dnode = cnode->children;  dnode;  dnode = dnode->next) {
+		relation = ug_data_realloc (dnode->data, UgetRelationInfo);
+		if (id)
+			relation->journal.id = (*id)++;
+		relation->journal.prev  = prev;
+		relation->journal.group = relation->group;
+		relation->journal.dirty = FALSE;
+		prev = relation->journal.id;
+	}
+}
+
+// ----------------------------------------------------------------------------
+// UgetAppJournal
+
+void  uget_app_journal_init (UgetApp* app)
+{
+	app->journal.path = NULL;
+	app->journal.fd = -1;
+	app->journal.next_id = 1;
+	app->journal.n_records = 0;
+	app->journal.limit = JOURNAL_LIMIT_MIN;
+	app->journal.compact = FALSE;
+	app->journal.compactor = NULL;
+	ug_array_init (&app->journal.removed, sizeof (int), 16);
+}
+
+void  uget_app_journal_final (UgetApp* app)
+{
+	if (app->journal.fd != -1)
+		ug_close (app->journal.fd);
+	app->journal.fd = -1;
+	ug_free (app->journal.path);
+	app->journal.path = NULL;
+	ug_array_clear (&app->journal.removed);
+}
+
+void  uget_app_journal_changed (UgetApp* app, UgetNode* node)
+{
+	UgetRelation* relation;
+
+	node = node->base;
+	if (node->parent == &app->real)
+		app->journal.compact = TRUE;
+	else if (node->parent && node->parent->parent == &app->real) {
+		relation = ug_data_realloc (node->data, UgetRelationInfo);
+		relation->journal.dirty = TRUE;
+	}
+}
+
+void  uget_app_journal_removed (UgetApp* app, UgetNode* dnode)
+{
+	UgetRelation* relation;
+
+	if (app->journal.fd == -1)
+		return;
+	relation = ug_data_get (dnode->data, UgetRelationInfo);
+	if (relation && relation->journal.id > 0)
+		*(int*) ug_array_alloc (&app->journal.removed, 1) = relation->journal.id;
+}
+
+int   uget_app_journal_append (UgetApp* app, const char* path_base)
+{
+	UgetAppJournal*    journal;
+	UgetJournalWriter  writer;
+	UgetRelation*      relation;
+	UgetNode*          cnode;
+	UgetNode*          dnode;
+	char*              path;
+	int                nth, prev;
+
+	journal = &app->journal;
+	if (journal->fd == -1 || journal->compact)
+		return FALSE;
+	// categories may be saved to other folder
+	path = ug_build_filename (path_base, JOURNAL_FILE, NULL);
+	nth = strcmp (path, journal->path);
+	ug_free (path);
+	if (nth != 0)
+		return FALSE;
+
+	writer_init (&writer, journal->fd);
+	if (journal->removed.length > 0) {
+		write_head (&writer, "remove", 0);
+		ug_json_write_string (&writer.json, "ids");
+		ug_json_write_array_head (&writer.json);
+		ug_json_write_array_int (&writer.json, &journal->removed);
+		ug_json_write_array_tail (&writer.json);
+		write_tail (&writer);
+		journal->removed.length = 0;
+	}
+
+	// A download is moved if it's previous node changed. Loader move it with
+	// following downloads that were not moved, see apply_record().
+	for (nth = 0, cnode = app->real.children;  cnode;  cnode = cnode->next, nth++) {
+		prev = -(nth + 1);
+		for (dnode = cnode->children;  dnode;  dnode = dnode->next) {
+			relation = ug_data_realloc (dnode->data, UgetRelationInfo);
+			if (relation->journal.id == 0) {
+				relation->journal.id = journal->next_id++;
+				write_head (&writer, "add", relation->journal.id);
+				write_position (&writer, nth, prev);
+				write_data (&writer, dnode);
+				write_tail (&writer);
+			}
+			else {
+				if (relation->journal.prev != prev) {
+					write_head (&writer, "move", relation->journal.id);
+					write_position (&writer, nth, prev);
+					write_tail (&writer);
+				}
+				// active download changes it's progress
+				if (relation->journal.dirty ||
+				    relation->journal.group != relation->group ||
+				    relation->group & UGET_GROUP_ACTIVE)
+				{
+					write_head (&writer, "update", relation->journal.id);
+					write_data (&writer, dnode);
+					write_tail (&writer);
+				}
+			}
+			relation->journal.prev  = prev;
+			relation->journal.group = relation->group;
+			relation->journal.dirty = FALSE;
+			prev = relation->journal.id;
+		}
+	}
+
+	if (writer.n_records > 0) {
+		write_head (&writer, "commit", 0);
+		write_tail (&writer);
+		writer_flush (&writer);
+		ug_sync (journal->fd);
+		journal->n_records += writer.n_records;
+	}
+	writer_final (&writer);
+	return TRUE;
+}
+
+int   uget_app_journal_begin_compact (UgetApp* app, const char* path_base, int* fd)
+{
+	UgetNode*  cnode;
+	char*      path;
+	int        nth, id;
+
+	// categories are exported to other folder, journal stays in it's folder.
+	path = ug_build_filename (path_base, JOURNAL_FILE, NULL);
+	if (app->journal.path && strcmp (app->journal.path, path) != 0) {
+		*fd = ug_open (path, UG_O_CREAT | UG_O_WRONLY | UG_O_BINARY,
+				UG_S_IREAD | UG_S_IWRITE | UG_S_IRGRP | UG_S_IROTH);
+		ug_free (path);
+		id = 0;
+		for (cnode = app->real.children;  cnode;  cnode = cnode->next)
+			id += cnode->n_children;
+		return id;
+	}
+	ug_free (path);
+
+	journal_open (&app->journal, path_base);
+	*fd = app->journal.fd;
+
+	id = 1;
+	for (nth = 0, cnode = app->real.children;  cnode;  cnode = cnode->next, nth++)
+		mark_category (cnode, nth, &id);
+
+	app->journal.next_id = id;
+	app->journal.n_records = 0;
+	app->journal.limit = (id > JOURNAL_LIMIT_MIN) ? id : JOURNAL_LIMIT_MIN;
+	app->journal.compact = FALSE;
+	app->journal.removed.length = 0;
+	return id - 1;
+}
+
+void  uget_app_journal_mark_compact (int fd)
+{
+	if (fd != -1)
+		journal_reset (fd, "compact", 0);
+}
+
+void  uget_app_journal_end_compact (int fd, int n_nodes)
+{
+	if (fd != -1)
+		journal_reset (fd, "base", n_nodes);
+}
+
+int   uget_app_journal_is_compacting (UgetApp* app, const char* path_base)
+{
+	static const char  mark[] = "{\"op\":\"compact\"}";
+	char   buf[sizeof (mark)];
+	char*  path;
+	int    fd, len;
+
+	path = ug_build_filename (path_base, JOURNAL_FILE, NULL);
+	fd = ug_open (path, UG_O_RDONLY | UG_O_BINARY, 0);
+	ug_free (path);
+	if (fd == -1)
+		return FALSE;
+	len = ug_read (fd, buf, sizeof (mark) - 1);
+	ug_close (fd);
+
+	if (len == sizeof (mark) - 1 && memcmp (buf, mark, len) == 0)
+		return TRUE;
+	return FALSE;
+}
+
+// ----------------------------------------------------------------------------
+// replay
+
+static UgetNode*  table_get (UgArrayPtr* table, int id)
+{
+	if (id <= 0 || id >= table->length)
+		return NULL;
+	return table->at[id];
+}
+
+static void  table_set (UgArrayPtr* table, int id, UgetNode* node)
+{
+	int  length;
+
+	if (id >= table->length) {
+		length = table->length;
+		ug_array_alloc (table, id + 1 - length);
+		memset (table->at + length, 0, (id + 1 - length) * sizeof (void*));
+	}
+	table->at[id] = node;
+}
+
+// mark downloads that are added or moved by records of the same commit.
+static void  mark_record (UgetJournalRecord* record, UgArrayInt* marks, int batch)
+{
+	int  length;
+
+	if (record->id <= 0 || (strcmp (record->op, "add") != 0 &&
+	                        strcmp (record->op, "move") != 0))
+		return;
+	if (record->id >= marks->length) {
+		length = marks->length;
+		ug_array_alloc (marks, record->id + 1 - length);
+		memset (marks->at + length, 0, (record->id + 1 - length) * sizeof (int));
+	}
+	marks->at[record->id] = batch;
+}
+
+static int  is_marked (UgetNode* node, UgArrayInt* marks, int batch)
+{
+	const UgetRelation*  relation;
+
+	relation = ug_data_get (node->data, UgetRelationInfo);
+	if (relation == NULL || relation->journal.id >= marks->length)
+		return FALSE;
+	return marks->at[relation->journal.id] == batch;
+}
+
+static void  apply_record (UgetJournalRecord* record, UgArrayPtr* table,
+                           UgArrayInt* marks, int batch,
+                           UgetNode** cnodes, int n_cnodes)
+{
+	UgetRelation* relation;
+	UgetNode*     cnode;
+	UgetNode*     node;
+	UgetNode*     next;
+	UgetNode*     sibling;
+	UgData*       data;
+	int           index;
+
+	if (strcmp (record->op, "remove") == 0) {
+		for (index = 0;  index < record->ids.length;  index++) {
+			node = table_get (table, record->ids.at[index]);
+			if (node) {
+				table->at[record->ids.at[index]] = NULL;
+				uget_node_free (node);
+			}
+		}
+		return;
+	}
+	else if (strcmp (record->op, "update") == 0) {
+		node = table_get (table, record->id);
+		if (node && record->node) {
+			data = node->data;
+			node->data = record->node->data;
+			record->node->data = data;
+			relation = ug_data_realloc (node->data, UgetRelationInfo);
+			relation->journal.id = record->id;
+		}
+		return;
+	}
+	else if (strcmp (record->op, "add") == 0) {
+		if (record->node == NULL || record->id <= 0 || table_get (table, record->id))
+			return;
+		if (record->category < 0 || record->category >= n_cnodes)
+			return;
+		node = record->node;
+		record->node = NULL;
+		table_set (table, record->id, node);
+		relation = ug_data_realloc (node->data, UgetRelationInfo);
+		relation->journal.id = record->id;
+	}
+	else if (strcmp (record->op, "move") == 0) {
+		node = table_get (table, record->id);
+		if (node == NULL || record->category < 0 || record->category >= n_cnodes)
+			return;
+	}
+	else
+		return;
+
+	// insert node after "after" node in category
+	cnode = cnodes[record->category];
+	sibling = table_get (table, record->after);
+	if (sibling && sibling->parent == cnode)
+		sibling = sibling->next;
+	else
+		sibling = cnode->children;
+	if (node->parent == NULL) {
+		uget_node_insert (cnode, sibling, node);
+		return;
+	}
+	// Writer doesn't write downloads that follow moved one if their previous
+	// node is not changed. Move them together until next moved download.
+	if (sibling == node)
+		return;
+	for (;;) {
+		next = node->next;
+		uget_node_remove (node->parent, node);
+		uget_node_insert (cnode, sibling, node);
+		if (next == NULL || next == sibling || is_marked (next, marks, batch))
+			break;
+		node = next;
+	}
+}
+
+static char*  read_file (const char* path, int* length)
+{
+	char*  buf;
+	int    fd, size, len;
+
+	fd = ug_open (path, UG_O_RDONLY | UG_O_BINARY, 0);
+	if (fd == -1)
+		return NULL;
+	size = (int) ug_seek (fd, 0, SEEK_END);
+	ug_seek (fd, 0, SEEK_SET);
+	if (size <= 0) {
+		ug_close (fd);
+		return NULL;
+	}
+
+	buf = ug_malloc (size + 1);
+	for (*length = 0;  *length < size;  *length += len) {
+		len = ug_read (fd, buf + *length, size - *length);
+		if (len <= 0)
+			break;
+	}
+	buf[*length] = 0;
+	ug_close (fd);
+	return buf;
+}
+
+int   uget_app_journal_replay (UgetApp* app, const char* path_base,
+                               UgetNode** cnodes, int n_cnodes, int n_files)
+{
+	UgetJournalRecords  records;
+	UgetJournalRecord*  record;
+	UgArrayPtr  table;
+	UgArrayInt  marks;
+	UgJson      json;
+	UgJsonError error;
+	UgetNode*   dnode;
+	char*       path;
+	char*       buf;
+	char*       line;
+	char*       line_end;
+	int         buf_len, committed, valid;
+	int         nth, index, id, batch;
+
+	// give id to downloads by order
+	ug_array_init (&table, sizeof (void*), 1024);
+	table_set (&table, 0, NULL);
+	for (nth = 0;  nth < n_cnodes;  nth++) {
+		for (dnode = cnodes[nth]->children;  dnode;  dnode = dnode->next) {
+			id = table.length;
+			table_set (&table, id, dnode);
+			((UgetRelation*) ug_data_realloc (dnode->data,
+					UgetRelationInfo))->journal.id = id;
+		}
+	}
+
+	// records number categories by position of category files, they can't be
+	// applied if any category file failed to load.
+	path = ug_build_filename (path_base, JOURNAL_FILE, NULL);
+	if (n_cnodes == n_files)
+		buf = read_file (path, &buf_len);
+	else
+		buf = NULL;
+	ug_free (path);
+
+	app->journal.n_records = 0;
+	committed = 0;
+	valid = (buf == NULL && n_cnodes == n_files);
+	if (buf) {
+		ug_json_init (&json);
+		ug_array_init (&records, sizeof (UgetJournalRecord), 64);
+		ug_array_init (&marks, sizeof (int), 1024);
+		batch = 0;
+		for (line = buf;  line < buf + buf_len;  line = line_end + 1) {
+			line_end = strchr (line, '\n');
+			if (line_end == NULL)
+				break;    // incomplete record
+			record = ug_array_alloc (&records, 1);
+			record_init (record);
+			ug_json_begin_parse (&json);
+			ug_json_push (&json, ug_json_parse_entry,
+					record, (void*) UgetJournalRecordEntry);
+			ug_json_push (&json, ug_json_parse_object, NULL, NULL);
+			error = ug_json_parse (&json, line, (int) (line_end - line));
+			if (error == UG_JSON_ERROR_NONE)
+				error = ug_json_end_parse (&json);
+			if (error != UG_JSON_ERROR_NONE || record->op == NULL)
+				break;
+
+			// first record must be "base" and match category files
+			if (line == buf) {
+				if (strcmp (record->op, "base") != 0 || record->id != table.length - 1)
+					break;
+				committed = (int) (line_end + 1 - buf);
+				valid = TRUE;
+				record_final (record);
+				records.length = 0;
+				continue;
+			}
+			if (strcmp (record->op, "commit") != 0)
+				continue;
+			// apply records before "commit"
+			batch++;
+			for (index = 0;  index < records.length - 1;  index++)
+				mark_record (records.at + index, &marks, batch);
+			for (index = 0;  index < records.length - 1;  index++)
+				apply_record (records.at + index, &table, &marks, batch, cnodes, n_cnodes);
+			for (index = 0;  index < records.length;  index++)
+				record_final (records.at + index);
+			app->journal.n_records += records.length;
+			records.length = 0;
+			committed = (int) (line_end + 1 - buf);
+		}
+		for (index = 0;  index < records.length;  index++)
+			record_final (records.at + index);
+		ug_array_clear (&records);
+		ug_array_clear (&marks);
+		ug_json_final (&json);
+		ug_free (buf);
+	}
+
+	for (nth = 0;  nth < n_cnodes;  nth++)
+		mark_category (cnodes[nth], nth, NULL);
+	app->journal.next_id = table.length;
+	app->journal.limit = (table.length > JOURNAL_LIMIT_MIN) ?
+			table.length : JOURNAL_LIMIT_MIN;
+	// rewrite category files if some of them failed to load.
+	app->journal.compact = (n_cnodes != n_files);
+	app->journal.removed.length = 0;
+	ug_array_clear (&table);
+
+	// drop records that were not committed
+	journal_open (&app->journal, path_base);
+	if (app->journal.fd == -1)
+		return FALSE;
+	if (committed == 0) {
+		// no journal or it doesn't match category files
+		id = 0;
+		for (nth = 0;  nth < n_cnodes;  nth++)
+			id += cnodes[nth]->n_children;
+		journal_reset (app->journal.fd, "base", id);
+		return valid;
+	}
+	ug_truncate (app->journal.fd, committed);
+	ug_seek (app->journal.fd, 0, SEEK_END);
+	return TRUE;
+}
@@ -0,0 +1,807 @@
+/*
+ *
+ *   Copyright (C) 2012-2018 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  In addition, as a special exception, the copyright holders give
+ *  permission to link the code of portions of this program with the
+ *  OpenSSL library under certain conditions as described in each
+ *  individual source file, and distribute linked combinations
+ *  including the two.
+ *  You must obey the GNU Lesser General Public License in all respects
+ *  for all of the code used other than OpenSSL.  If you modify
+ *  file(s) with this exception, you may extend this exception to your
+ *  version of the file(s), but you are not obligated to do so.  If you
+ *  do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source
+ *  files in the program, then also delete it here.
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <UgUtil.h>
+#include <UgString.h>
+#include <UgStdio.h>
+#include <UgFileUtil.h>
+#include <UgJson-custom.h>
+#include <UgEntry.h>
+#include <UgData.h>
+#include <UgetApp.h>
+
+#define SNAPSHOT_FILE       "snapshot.bin"
+#define SNAPSHOT_TEMP       "snapshot.temp"
+#define SNAPSHOT_VERSION    2
+#define SNAPSHOT_BYTE_ORDER 0x01020304
+#define SNAPSHOT_NULL       0xFFFFFFFF   // string is NULL
+#define SNAPSHOT_NONE       0xFFFFFFFE   // value was not written
+
+/* ----------------------------------------------------------------------------
+   Snapshot file layout (native byte order):
+
+   UgetSnapshotHeader
+   int64_t   size, modified time of NNNN.json * n_files
+   uint32_t  name, signature of group * n_groups
+   strings:  uint32_t length, characters, '\0'  (same string is stored once)
+             size of string table is multiple of 4.
+   records:  node = uint32_t n_groups, (uint32_t group, fields...) * n_groups,
+                    uint32_t n_children, node * n_children
+             category nodes are stored in order.
+
+   Fields of group are stored in the order of it's UgEntry:
+   BOOL, INT, UINT          uint32_t
+   INT64, UINT64, DOUBLE    8 bytes  (time_t is INT64)
+   STRING                   uint32_t offset of string
+   OBJECT                   fields of object
+   ARRAY, CUSTOM            uint32_t offset of JSON string {"name":value}
+ */
+
+typedef struct UgetSnapshotHeader  UgetSnapshotHeader;
+
+struct UgetSnapshotHeader
+{
+	char      magic[8];      // "UGETSNAP"
+	uint32_t  version;
+	uint32_t  byte_order;
+	uint32_t  n_files;
+	uint32_t  n_groups;
+	uint32_t  strings;       // offset of string table
+	uint32_t  strings_size;
+	uint32_t  records;       // offset of records
+	uint32_t  records_size;
+	uint32_t  checksum;      // checksum of strings and records
+};
+
+static const char  snapshot_magic[8] = {'U','G','E','T','S','N','A','P'};
+
+// ----------------------------------------------------------------------------
+// signature of UgEntry. Snapshot is invalid if layout of group changed.
+
+static uint32_t  hash_string (uint32_t hash, const char* string)
+{
+	// FNV-1a
+	if (string) {
+		for (;  *string;  string++)
+			hash = (hash ^ (uint8_t) *string) * 16777619u;
+	}
+	return hash;
+}
+
+static uint32_t  hash_entry (uint32_t hash, const UgEntry* entry)
+{
+	for (;  entry->type;  entry++) {
+		hash = hash_string (hash, entry->name);
+		hash = (hash ^ entry->type) * 16777619u;
+		hash = (hash ^ entry->offset) * 16777619u;
+		if (entry->type == UG_ENTRY_OBJECT)
+			hash = hash_entry (hash, entry->param1);
+	}
+	return hash;
+}
+
+static uint32_t  group_signature (const UgGroupDataInfo* info)
+{
+	uint32_t  hash = 2166136261u;
+
+	hash = hash_string (hash, info->name);
+	hash = (hash ^ info->size) * 16777619u;
+	return hash_entry (hash, info->entry);
+}
+
+// 'length' must be multiple of 4 except the last call.
+static uint32_t  checksum (uint32_t hash, const char* data, uint32_t length)
+{
+	uint32_t  word;
+
+	for (;  length >= 4;  length -= 4, data += 4) {
+		memcpy (&word, data, 4);
+		hash = (hash ^ word) * 16777619u;
+	}
+	for (;  length > 0;  length--, data++)
+		hash = (hash ^ (uint8_t) *data) * 16777619u;
+	return hash;
+}
+
+// ----------------------------------------------------------------------------
+// UgetSnapshotWriter
+
+struct UgetSnapshotWriter
+{
+	UgBuffer*   records;
+	UgBuffer*   strings;
+	UgArrayPtr* groups;       // UgGroupDataInfo
+
+	UgBuffer    blob;       // JSON of ARRAY and CUSTOM
+	UgJson      json;
+
+	// hash table for string -> offset in strings
+	uint32_t*   table;
+	uint32_t    table_size;   // power of 2
+	uint32_t    n_strings;
+};
+
+static void  reuse_strings (UgetSnapshotWriter* writer);
+
+static void  writer_init (UgetSnapshotWriter* writer, UgBuffer* strings,
+                          UgBuffer* records, UgArrayPtr* groups)
+{
+	writer->records = records;
+	writer->strings = strings;
+	writer->groups = groups;
+	ug_buffer_init (&writer->blob, 1024);
+	ug_json_init (&writer->json);
+	writer->table_size = 4096;
+	writer->table = ug_malloc (writer->table_size * sizeof (uint32_t));
+	memset (writer->table, 0xFF, writer->table_size * sizeof (uint32_t));
+	writer->n_strings = 0;
+	if (strings->beg)
+		reuse_strings (writer);
+}
+
+static void  writer_final (UgetSnapshotWriter* writer)
+{
+	ug_buffer_clear (&writer->blob, TRUE);
+	ug_json_final (&writer->json);
+	ug_free (writer->table);
+}
+
+static void  write_u32 (UgBuffer* buffer, uint32_t value)
+{
+	ug_buffer_write_data (buffer, (char*) &value, sizeof (value));
+}
+
+static const char*  string_at (UgBuffer* strings, uint32_t offset, uint32_t* length)
+{
+	memcpy (length, strings->beg + offset, sizeof (uint32_t));
+	return strings->beg + offset + sizeof (uint32_t);
+}
+
+static uint32_t  hash_stored (const char* string, uint32_t length)
+{
+	uint32_t  hash = 2166136261u;
+
+	for (;  length > 0;  length--)
+		hash = (hash ^ (uint8_t) *string++) * 16777619u;
+	return hash;
+}
+
+// return slot that has offset of 'string' or empty slot.
+static uint32_t*  find_string (UgetSnapshotWriter* writer, const char* string, uint32_t length)
+{
+	const char* stored;
+	uint32_t    stored_len;
+	uint32_t    index, offset;
+
+	for (index = hash_stored (string, length) & (writer->table_size - 1);  ;
+	     index = (index + 1) & (writer->table_size - 1))
+	{
+		offset = writer->table[index];
+		if (offset == SNAPSHOT_NULL)
+			break;
+		stored = string_at (writer->strings, offset, &stored_len);
+		if (stored_len == length && memcmp (stored, string, length) == 0)
+			break;
+	}
+	return writer->table + index;
+}
+
+static void  insert_string (UgetSnapshotWriter* writer, uint32_t* slot, uint32_t offset)
+{
+	const char* stored;
+	uint32_t    stored_len;
+	uint32_t    index, hash;
+	uint32_t*   table;
+
+	*slot = offset;
+	// keep load factor below 0.5
+	if (++writer->n_strings * 2 > writer->table_size) {
+		table = writer->table;
+		writer->table_size *= 2;
+		writer->table = ug_malloc (writer->table_size * sizeof (uint32_t));
+		memset (writer->table, 0xFF, writer->table_size * sizeof (uint32_t));
+		for (index = 0;  index < writer->table_size / 2;  index++) {
+			if (table[index] == SNAPSHOT_NULL)
+				continue;
+			stored = string_at (writer->strings, table[index], &stored_len);
+			hash = hash_stored (stored, stored_len);
+			for (hash &= writer->table_size - 1;  writer->table[hash] != SNAPSHOT_NULL;  )
+				hash = (hash + 1) & (writer->table_size - 1);
+			writer->table[hash] = table[index];
+		}
+		ug_free (table);
+	}
+}
+
+static uint32_t  add_string (UgetSnapshotWriter* writer, const char* string, uint32_t length)
+{
+	uint32_t*   slot;
+	uint32_t    offset;
+
+	slot = find_string (writer, string, length);
+	if (*slot != SNAPSHOT_NULL)
+		return *slot;
+
+	offset = ug_buffer_length (writer->strings);
+	write_u32 (writer->strings, length);
+	ug_buffer_write_data (writer->strings, string, length);
+	ug_buffer_write_char (writer->strings, 0);
+	insert_string (writer, slot, offset);
+	return offset;
+}
+
+// strings that were written by other writer can be shared, too.
+static void  reuse_strings (UgetSnapshotWriter* writer)
+{
+	const char* stored;
+	uint32_t    stored_len;
+	uint32_t    offset;
+	uint32_t*   slot;
+
+	for (offset = 0;  offset < (uint32_t) ug_buffer_length (writer->strings);  ) {
+		stored = string_at (writer->strings, offset, &stored_len);
+		slot = find_string (writer, stored, stored_len);
+		if (*slot == SNAPSHOT_NULL)
+			insert_string (writer, slot, offset);
+		offset += sizeof (uint32_t) + stored_len + 1;
+	}
+}
+
+static uint32_t  group_index (UgetSnapshotWriter* writer, const UgGroupDataInfo* info)
+{
+	int  index;
+
+	for (index = 0;  index < writer->groups->length;  index++) {
+		if (writer->groups->at[index] == info)
+			return index;
+	}
+	*(const void**) ug_array_alloc (writer->groups, 1) = info;
+	return index;
+}
+
+// write value of ARRAY or CUSTOM entry as JSON object {"name":value}
+static uint32_t  write_blob (UgetSnapshotWriter* writer, void* src, const UgEntry* entry)
+{
+	UgEntry   one[2];
+	UgBuffer* blob = &writer->blob;
+	int       name_len;
+
+	one[0] = *entry;
+	one[0].offset = 0;
+	memset (one + 1, 0, sizeof (UgEntry));
+
+	blob->cur = blob->beg;
+	ug_json_begin_write (&writer->json, UG_JSON_FORMAT_UTF8, blob);
+	ug_json_write_object_head (&writer->json);
+	ug_json_write_entry (&writer->json, src, one);
+	ug_json_write_object_tail (&writer->json);
+	ug_json_end_write (&writer->json);
+
+	// don't store empty array: {"name":[]}
+	name_len = (entry->name) ? (int) strlen (entry->name) : 0;
+	if (ug_buffer_length (blob) == name_len + 7 && blob->cur[-2] == ']')
+		return SNAPSHOT_NONE;
+	return add_string (writer, blob->beg, ug_buffer_length (blob));
+}
+
+static void  write_entry (UgetSnapshotWriter* writer, void* src, const UgEntry* entry)
+{
+	UgBuffer*  records = writer->records;
+	char*      field;
+	char*      string;
+	int64_t    time_value;
+
+	for (;  entry->type;  entry++) {
+		field = (char*) src + entry->offset;
+
+		switch (entry->type) {
+		case UG_ENTRY_BOOL:
+		case UG_ENTRY_INT:
+		case UG_ENTRY_UINT:
+			ug_buffer_write_data (records, field, sizeof (int));
+			break;
+
+		case UG_ENTRY_INT64:
+		case UG_ENTRY_UINT64:
+		case UG_ENTRY_DOUBLE:
+			ug_buffer_write_data (records, field, 8);
+			break;
+
+		case UG_ENTRY_STRING:
+			string = *(char**) field;
+			if (string)
+				write_u32 (records, add_string (writer, string, (uint32_t) strlen (string)));
+			else if (entry->param2 == UG_ENTRY_NO_NULL)
+				write_u32 (records, SNAPSHOT_NONE);
+			else
+				write_u32 (records, SNAPSHOT_NULL);
+			break;
+
+		case UG_ENTRY_OBJECT:
+			write_entry (writer, field, entry->param1);
+			break;
+
+		case UG_ENTRY_ARRAY:
+		case UG_ENTRY_CUSTOM:
+			if (entry->param2 == (void*) ug_json_write_time_t) {
+				time_value = *(time_t*) field;
+				ug_buffer_write_data (records, (char*) &time_value, 8);
+			}
+			else if (entry->param2 == NULL)
+				write_u32 (records, SNAPSHOT_NONE);
+			else
+				write_u32 (records, write_blob (writer, field, entry));
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+
+static void  write_node (UgetSnapshotWriter* writer, UgetNode* node)
+{
+	UgGroupDataInfo*  info;
+	UgPair*   cur;
+	UgPair*   end;
+	uint32_t  n_groups;
+
+	for (n_groups = 0, cur = node->data->at, end = cur + node->data->length;  cur < end;  cur++) {
+		if (cur->data && ((UgGroupDataInfo*) cur->key)->entry)
+			n_groups++;
+	}
+	write_u32 (writer->records, n_groups);
+	for (cur = node->data->at;  cur < end;  cur++) {
+		info = cur->key;
+		if (cur->data == NULL || info->entry == NULL)
+			continue;
+		write_u32 (writer->records, group_index (writer, info));
+		write_entry (writer, cur->data, info->entry);
+	}
+
+	write_u32 (writer->records, node->n_children);
+	for (node = node->children;  node;  node = node->next)
+		write_node (writer, node);
+}
+
+int   uget_app_snapshot_save (UgetSnapshotWriter* writer, const char* path_base,
+                              const int64_t* stamps, int n_files)
+{
+	UgetSnapshotHeader  header;
+	UgGroupDataInfo*    info;
+	UgBuffer*   records = writer->records;
+	UgBuffer*   strings = writer->strings;
+	UgArrayPtr* groups  = writer->groups;
+	uint32_t*   values;
+	char*       path;
+	char*       path_temp;
+	int         fd, index, result;
+
+	// name and signature of groups
+	values = ug_malloc (groups->length * sizeof (uint32_t) * 2 + 1);
+	for (index = 0;  index < groups->length;  index++) {
+		info = groups->at[index];
+		values[index*2]   = add_string (writer, info->name, (uint32_t) strlen (info->name));
+		values[index*2+1] = group_signature (info);
+	}
+
+	while (ug_buffer_length (strings) & 3)
+		ug_buffer_write_char (strings, 0);
+
+	memcpy (header.magic, snapshot_magic, sizeof (header.magic));
+	header.version = SNAPSHOT_VERSION;
+	header.byte_order = SNAPSHOT_BYTE_ORDER;
+	header.n_files = n_files;
+	header.n_groups = groups->length;
+	header.strings = sizeof (header) + n_files * sizeof (int64_t) * 2 +
+	                 groups->length * sizeof (uint32_t) * 2;
+	header.strings_size = ug_buffer_length (strings);
+	header.records = header.strings + header.strings_size;
+	header.records_size = ug_buffer_length (records);
+	header.checksum = checksum (2166136261u, strings->beg, header.strings_size);
+	header.checksum = checksum (header.checksum, records->beg, header.records_size);
+
+	path_temp = ug_build_filename (path_base, SNAPSHOT_TEMP, NULL);
+	fd = ug_open (path_temp, UG_O_CREAT | UG_O_WRONLY | UG_O_TRUNC | UG_O_BINARY,
+			UG_S_IREAD | UG_S_IWRITE | UG_S_IRGRP | UG_S_IROTH);
+	if (fd != -1) {
+		result = ug_write (fd, &header, sizeof (header)) == sizeof (header);
+		if (n_files > 0)
+			ug_write (fd, stamps, n_files * sizeof (int64_t) * 2);
+		if (groups->length > 0)
+			ug_write (fd, values, groups->length * sizeof (uint32_t) * 2);
+		ug_write (fd, strings->beg, header.strings_size);
+		if (ug_write (fd, records->beg, header.records_size) != (int) header.records_size)
+			result = FALSE;
+		ug_close (fd);
+	}
+	ug_free (values);
+	if (fd == -1) {
+		ug_free (path_temp);
+		return FALSE;
+	}
+
+	path = ug_build_filename (path_base, SNAPSHOT_FILE, NULL);
+	if (result) {
+		ug_unlink (path);
+		ug_rename (path_temp, path);
+	}
+	else
+		ug_unlink (path_temp);
+	ug_free (path);
+	ug_free (path_temp);
+	return result;
+}
+
+void  uget_app_snapshot_remove (const char* path_base)
+{
+	char*  path;
+
+	path = ug_build_filename (path_base, SNAPSHOT_FILE, NULL);
+	ug_unlink (path);
+	ug_free (path);
+}
+
+// ----------------------------------------------------------------------------
+// UgetSnapshotReader
+
+typedef struct
+{
+	const char*  cur;
+	const char*  end;
+	const char*  strings;
+	uint32_t     strings_size;
+	int          error;
+
+	const UgGroupDataInfo**  groups;
+	uint32_t     n_groups;
+	UgJson       json;
+	UgSlice*     slice;     // arena of nodes
+} UgetSnapshotReader;
+
+static int  read_data (UgetSnapshotReader* reader, void* data, int length)
+{
+	if (reader->end - reader->cur < length) {
+		reader->error = TRUE;
+		memset (data, 0, length);
+		return FALSE;
+	}
+	memcpy (data, reader->cur, length);
+	reader->cur += length;
+	return TRUE;
+}
+
+static uint32_t  read_u32 (UgetSnapshotReader* reader)
+{
+	uint32_t  value;
+
+	read_data (reader, &value, sizeof (value));
+	return value;
+}
+
+// return pointer to characters and set 'length'. return NULL if error.
+static const char*  read_string (UgetSnapshotReader* reader, uint32_t offset, uint32_t* length)
+{
+	if (reader->strings_size < sizeof (uint32_t) ||
+	    offset > reader->strings_size - sizeof (uint32_t))
+	{
+		reader->error = TRUE;
+		return NULL;
+	}
+	memcpy (length, reader->strings + offset, sizeof (uint32_t));
+	if (*length >= reader->strings_size - offset - sizeof (uint32_t)) {
+		reader->error = TRUE;
+		return NULL;
+	}
+	return reader->strings + offset + sizeof (uint32_t);
+}
+
+static void  read_blob (UgetSnapshotReader* reader, uint32_t offset,
+                        void* dest, const UgEntry* entry)
+{
+	const char* blob;
+	uint32_t    length;
+
+	blob = read_string (reader, offset, &length);
+	if (blob == NULL)
+		return;
+
+	// parse from 'entry' to the end of its array, entry's own name matches first.
+	dest = (char*) dest - entry->offset;
+	ug_json_begin_parse (&reader->json);
+	ug_json_push (&reader->json, ug_json_parse_entry, dest, (void*) entry);
+	ug_json_push (&reader->json, ug_json_parse_object, NULL, NULL);
+	if (ug_json_parse (&reader->json, blob, length) != UG_JSON_ERROR_NONE)
+		reader->error = TRUE;
+	if (ug_json_end_parse (&reader->json) != UG_JSON_ERROR_NONE)
+		reader->error = TRUE;
+}
+
+static void  read_entry (UgetSnapshotReader* reader, void* dest, const UgEntry* entry)
+{
+	const char* string;
+	char*       temp;
+	char*       field;
+	uint32_t    offset, length;
+	int64_t     time_value;
+
+	for (;  entry->type && reader->error == FALSE;  entry++) {
+		field = (char*) dest + entry->offset;
+
+		switch (entry->type) {
+		case UG_ENTRY_BOOL:
+		case UG_ENTRY_INT:
+		case UG_ENTRY_UINT:
+			read_data (reader, field, sizeof (int));
+			break;
+
+		case UG_ENTRY_INT64:
+		case UG_ENTRY_UINT64:
+		case UG_ENTRY_DOUBLE:
+			read_data (reader, field, 8);
+			break;
+
+		case UG_ENTRY_STRING:
+			offset = read_u32 (reader);
+			if (offset == SNAPSHOT_NULL)
+				*(char**) field = NULL;
+			else if (offset != SNAPSHOT_NONE) {
+				string = read_string (reader, offset, &length);
+				if (string == NULL)
+					break;
+				// UgEntry.param1 can share string, e.g. ug_str_intern()
+				if (entry->param1 == NULL)
+					*(char**) field = ug_strndup (string, length);
+				else if (string[length] == 0)
+					*(char**) field = ((UgStrdupFunc) entry->param1) (string);
+				else {
+					temp = ug_strndup (string, length);
+					*(char**) field = ((UgStrdupFunc) entry->param1) (temp);
+					ug_free (temp);
+				}
+			}
+			break;
+
+		case UG_ENTRY_OBJECT:
+			if (entry->param2)
+				((UgInitFunc) entry->param2) (field);
+			read_entry (reader, field, entry->param1);
+			break;
+
+		case UG_ENTRY_ARRAY:
+		case UG_ENTRY_CUSTOM:
+			if (entry->param2 == (void*) ug_json_write_time_t) {
+				read_data (reader, &time_value, 8);
+				*(time_t*) field = (time_t) time_value;
+				break;
+			}
+			offset = read_u32 (reader);
+			if (offset != SNAPSHOT_NONE)
+				read_blob (reader, offset, field, entry);
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+
+static UgetNode*  read_node (UgetSnapshotReader* reader)
+{
+	const UgGroupDataInfo*  info;
+	UgetNode*  node;
+	UgetNode*  child;
+	uint32_t   count, index;
+
+	node = uget_node_new_in (reader->slice);
+	count = read_u32 (reader);
+	for (;  count > 0 && reader->error == FALSE;  count--) {
+		index = read_u32 (reader);
+		if (index >= reader->n_groups) {
+			reader->error = TRUE;
+			break;
+		}
+		info = reader->groups[index];
+		read_entry (reader, ug_data_realloc (node->data, info), info->entry);
+	}
+
+	count = read_u32 (reader);
+	for (;  count > 0 && reader->error == FALSE;  count--) {
+		child = read_node (reader);
+		if (child)
+			uget_node_append (node, child);
+	}
+
+	if (reader->error) {
+		uget_node_free (node);
+		return NULL;
+	}
+	return node;
+}
+
+int   uget_app_snapshot_load (UgetApp* app, const char* path_base,
+                              const int64_t* stamps, int n_files,
+                              UgetNode** cnodes)
+{
+	UgetSnapshotReader  reader;
+	UgetSnapshotHeader  header;
+	UgRegistry*  registry;
+	UgPair*      pair;
+	const char*  name;
+	char*        map;
+	char*        path;
+	int64_t      map_size;
+	int64_t      stamp[2];
+	uint32_t     values[2], length;
+	int          count;
+
+	path = ug_build_filename (path_base, SNAPSHOT_FILE, NULL);
+	map = ug_file_map (path, &map_size);
+	ug_free (path);
+	if (map == NULL)
+		return 0;
+
+	memset (&reader, 0, sizeof (reader));
+	reader.cur = map;
+	reader.end = map + map_size;
+	read_data (&reader, &header, sizeof (header));
+	if (reader.error ||
+	    memcmp (header.magic, snapshot_magic, sizeof (header.magic)) != 0 ||
+	    header.version != SNAPSHOT_VERSION ||
+	    header.byte_order != SNAPSHOT_BYTE_ORDER ||
+	    header.n_files != (uint32_t) n_files ||
+	    header.strings < sizeof (header) ||
+	    header.strings_size > map_size - header.strings ||
+	    header.records != header.strings + header.strings_size ||
+	    header.records_size != map_size - header.records ||
+	    header.checksum != checksum (2166136261u, map + header.strings,
+	                                 header.strings_size + header.records_size))
+	{
+		ug_file_unmap (map, map_size);
+		return 0;
+	}
+
+	// NNNN.json files were changed after writing snapshot
+	for (count = 0;  count < n_files;  count++) {
+		read_data (&reader, stamp, sizeof (stamp));
+		if (reader.error || stamp[0] != stamps[count*2] ||
+		    stamp[1] != stamps[count*2+1])
+		{
+			ug_file_unmap (map, map_size);
+			return 0;
+		}
+	}
+
+	// groups must have the same layout
+	reader.strings = map + header.strings;
+	reader.strings_size = header.strings_size;
+	reader.n_groups = header.n_groups;
+	reader.groups = ug_malloc (sizeof (void*) * (header.n_groups + 1));
+	registry = ug_data_get_registry ();
+	if (registry && registry->sorted == FALSE)
+		ug_registry_sort (registry);
+	for (count = 0;  count < (int) header.n_groups;  count++) {
+		read_data (&reader, values, sizeof (values));
+		name = read_string (&reader, values[0], &length);
+		pair = (name && registry) ? ug_registry_find (registry, name, NULL) : NULL;
+		if (pair == NULL || group_signature (pair->data) != values[1]) {
+			reader.error = TRUE;
+			break;
+		}
+		reader.groups[count] = pair->data;
+	}
+
+	// decode records
+	ug_json_init (&reader.json);
+	reader.cur = map + header.records;
+	for (count = 0;  count < n_files && reader.error == FALSE;  count++) {
+		// each category has it's own arena
+		reader.slice = ug_slice_new ();
+		cnodes[count] = read_node (&reader);
+		ug_slice_unref (reader.slice);
+		if (cnodes[count] == NULL)
+			break;
+	}
+	ug_json_final (&reader.json);
+	ug_free (reader.groups);
+	ug_file_unmap (map, map_size);
+
+	if (reader.error) {
+		while (--count >= 0)
+			uget_node_free (cnodes[count]);
+		return 0;
+	}
+	return count;
+}
+
+// ----------------------------------------------------------------------------
+// pack nodes in memory (used by UgetApp-cold.c)
+
+UgetSnapshotWriter* uget_snapshot_writer_new (UgBuffer* strings, UgBuffer* records,
+                                              UgArrayPtr* groups)
+{
+	UgetSnapshotWriter*  writer;
+
+	writer = ug_malloc (sizeof (UgetSnapshotWriter));
+	writer_init (writer, strings, records, groups);
+	return writer;
+}
+
+void  uget_snapshot_writer_free (UgetSnapshotWriter* writer)
+{
+	writer_final (writer);
+	ug_free (writer);
+}
+
+uint32_t  uget_snapshot_write_string (UgetSnapshotWriter* writer, const char* string)
+{
+	return add_string (writer, string, (uint32_t) strlen (string));
+}
+
+uint32_t  uget_snapshot_write_node (UgetSnapshotWriter* writer, UgetNode* node)
+{
+	uint32_t  offset;
+
+	offset = ug_buffer_length (writer->records);
+	write_node (writer, node);
+	return offset;
+}
+
+UgetNode* uget_snapshot_read_node (UgBuffer* strings, UgBuffer* records,
+                                   UgArrayPtr* groups, uint32_t offset,
+                                   UgSlice* slice)
+{
+	UgetSnapshotReader  reader;
+	UgetNode*  node;
+
+	if (offset >= (uint32_t) ug_buffer_length (records))
+		return NULL;
+
+	memset (&reader, 0, sizeof (reader));
+	reader.cur = records->beg + offset;
+	reader.end = records->cur;
+	reader.strings = strings->beg;
+	reader.strings_size = ug_buffer_length (strings);
+	reader.groups = (const UgGroupDataInfo**) groups->at;
+	reader.n_groups = groups->length;
+	reader.slice = slice;
+	ug_json_init (&reader.json);
+	node = read_node (&reader);
+	ug_json_final (&reader.json);
+	return node;
+}
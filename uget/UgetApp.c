@@ -116,6 +116,27 @@ static struct UgetNodeControl  control_mix_split =
 };
 
 
+// add/remove UgEntry arrays of UgetNode and registered infos to name index.
+static void  uget_app_index_entry (UgetApp* app, int add)
+{
+	UgGroupDataInfo*  info;
+	int  index;
+
+	for (index = 0;  index < app->infos.length;  index++) {
+		info = (UgGroupDataInfo*) app->infos.at[index].data;
+		if (info->entry == NULL)
+			continue;
+		if (add)
+			ug_entry_index_add (info->entry);
+		else
+			ug_entry_index_remove (info->entry);
+	}
+	if (add)
+		ug_entry_index_add (UgetNodeEntry);
+	else
+		ug_entry_index_remove (UgetNodeEntry);
+}
+
 void  uget_app_init (UgetApp* app)
 {
 	UgetCommon* common;
@@ -134,6 +155,15 @@ void  uget_app_init (UgetApp* app)
 	app->sorted_split.control = &control_sorted_split;
 	app->mix.control = &control_mix;
 	app->mix_split.control = &control_mix_split;
+	// virtual roots except app->split are built by uget_app_ref_view()
+	uget_node_remove_fake (&app->mix, &app->mix_split);
+	uget_node_remove_fake (&app->real, &app->mix);
+	uget_node_remove_fake (&app->sorted, &app->sorted_split);
+	uget_node_remove_fake (&app->real, &app->sorted);
+	app->n_sorted_refs = 0;
+	app->n_sorted_split_refs = 0;
+	app->n_mix_refs = 0;
+	uget_app_journal_init (app);
 	// add virtual category - "All Category"
 	node = uget_node_new (NULL);
 	common = ug_data_realloc(node->data, UgetCommonInfo);
@@ -159,10 +189,13 @@ void  uget_app_init (UgetApp* app)
 	ug_registry_add (&app->infos, UgetCategoryInfo);
 	ug_registry_sort (&app->infos);
 	ug_data_set_registry (&app->infos);
+	// name index for loading categories and downloads
+	uget_app_index_entry (app, TRUE);
 }
 
 void  uget_app_final (UgetApp* app)
 {
+	uget_app_wait_categories (app);
 	ug_array_clear (&app->nodes);
 	uget_task_final (&app->task);
 	uget_app_clear_plugins (app);
@@ -173,11 +206,13 @@ void  uget_app_final (UgetApp* app)
 	uget_node_clear_children (&app->split);
 	uget_node_clear_children (&app->real);
 
+	uget_app_index_entry (app, FALSE);
 	ug_registry_final (&app->plugins);
 	ug_registry_final (&app->infos);
 
 	uget_uri_hash_free (app->uri_hash);
 	app->uri_hash = NULL;
+	uget_app_journal_final (app);
 }
 
 static UgArrayPtr* uget_app_store_nodes (UgetApp* app, UgetNode* parent)
@@ -213,21 +248,18 @@ static int  uget_app_activate (UgetApp* app, UgetNode* cnode, UgetCategory* cate
 	// program must store active nodes to array.
 	array = uget_app_store_nodes (app, category->active);
 
+	// sorting keys (speed, percent...) of active nodes may have changed.
+	// move fake nodes in sorted parent only if they moved past neighbours.
+	if (app->mix.control->sort.compare)
+		app->n_moved += uget_node_reposition_fake ((UgetNode**) array->at,
+		                                           array->length);
+
 	for (index = 0;  index < array->length;  index++) {
 		dnode = array->at[index];
 		uget_node_updated (dnode);
 		relation = ug_data_realloc(dnode->data, UgetRelationInfo);
-		if (relation->group & UGET_GROUP_ACTIVE) {
-			// remove node and insert it again to sort node
-			if (app->mix.control->sort.compare) {
-				sibling = dnode->next;
-				uget_node_remove (cnode, dnode);
-				uget_node_clear_fake (dnode);
-				uget_node_insert (cnode, sibling, dnode);
-				app->n_moved++;
-			}
+		if (relation->group & UGET_GROUP_ACTIVE)
 			continue;
-		}
 
 		uget_task_remove (&app->task, dnode);
 		uget_node_remove (cnode, dnode);
@@ -321,16 +353,27 @@ int   uget_app_trim(UgetApp* app)
 		category = ug_data_realloc(cnode->data, UgetCategoryInfo);
 		if (category == NULL)
 			continue;
-		while (category->finished->n_children > category->finished_limit) {
+		// oldest downloads may not be loaded, remove them without paging in
+		while (category->finished->n_children + category->cold.n_finished > category->finished_limit) {
+			if (uget_app_page_remove(app, cnode, UGET_GROUP_FINISHED)) {
+				app->n_deleted++;
+				continue;
+			}
 			dnode = category->finished->last->real;
 			uget_uri_hash_remove_download(app->uri_hash, dnode->data);
+			uget_app_journal_removed(app, dnode);
 			uget_node_remove(cnode, dnode);
 			uget_node_free(dnode);
 			app->n_deleted++;
 		}
-		while (category->recycled->n_children > category->recycled_limit) {
+		while (category->recycled->n_children + category->cold.n_recycled > category->recycled_limit) {
+			if (uget_app_page_remove(app, cnode, UGET_GROUP_RECYCLED)) {
+				app->n_deleted++;
+				continue;
+			}
 			dnode = category->recycled->last->real;
 			uget_uri_hash_remove_download(app->uri_hash, dnode->data);
+			uget_app_journal_removed(app, dnode);
 			uget_node_remove(cnode, dnode);
 			uget_node_free(dnode);
 			app->n_deleted++;
@@ -379,7 +422,7 @@ void  uget_app_set_sorting (UgetApp* app, UgCompareFunc compare, int reversed)
 		app->sorted_split.control->sort.compare = compare;
 		if (compare == NULL) {
 			// reorder first category in app->mix
-			for (real = app->real.last;  real;  real = real->prev)
+			for (real = app->real.last;  real && app->n_mix_refs;  real = real->prev)
 				uget_node_reorder_by_real (node, real);
 			// reorder each category in app->mix_split
 			for (node = app->mix_split.children;  node;  node = node->next) {
@@ -410,6 +453,48 @@ void  uget_app_set_sorting (UgetApp* app, UgCompareFunc compare, int reversed)
 	}
 }
 
+void  uget_app_ref_view (UgetApp* app, UgetNode* view)
+{
+	if (view == &app->sorted) {
+		if (app->n_sorted_refs++ == 0)
+			uget_node_attach_fake (&app->real, &app->sorted);
+	}
+	else if (view == &app->sorted_split) {
+		if (app->n_sorted_split_refs++ == 0) {
+			uget_app_ref_view (app, &app->sorted);
+			uget_node_attach_fake (&app->sorted, &app->sorted_split);
+		}
+	}
+	else if (view == &app->mix || view == &app->mix_split) {
+		// app->mix use app->mix_split to order downloads by group,
+		// so they are built together.
+		if (app->n_mix_refs++ == 0) {
+			uget_node_attach_fake (&app->mix, &app->mix_split);
+			uget_node_attach_fake (&app->real, &app->mix);
+		}
+	}
+}
+
+void  uget_app_unref_view (UgetApp* app, UgetNode* view)
+{
+	if (view == &app->sorted) {
+		if (--app->n_sorted_refs == 0)
+			uget_node_detach_fake (&app->real, &app->sorted);
+	}
+	else if (view == &app->sorted_split) {
+		if (--app->n_sorted_split_refs == 0) {
+			uget_node_detach_fake (&app->sorted, &app->sorted_split);
+			uget_app_unref_view (app, &app->sorted);
+		}
+	}
+	else if (view == &app->mix || view == &app->mix_split) {
+		if (--app->n_mix_refs == 0) {
+			uget_node_detach_fake (&app->mix, &app->mix_split);
+			uget_node_detach_fake (&app->real, &app->mix);
+		}
+	}
+}
+
 void  uget_app_set_notification (UgetApp* app, void* data,
                                  UgetNodeFunc inserted,
                                  UgetNodeFunc removed,
@@ -446,6 +531,17 @@ void  uget_app_set_notification (UgetApp* app, void* data,
 	control_mix_split.data              = data;
 }
 
+// If journal is used, order of category files and ids of downloads depend on
+// each other. Rewrite all category files when category was added or removed.
+static int  uget_app_rewrite_categories (UgetApp* app)
+{
+	if (app->journal.fd == -1)
+		return FALSE;
+	app->journal.compact = TRUE;
+	uget_app_save_categories (app, NULL);
+	return TRUE;
+}
+
 void  uget_app_add_category (UgetApp* app, UgetNode* cnode, int save_file)
 {
 	UgetCategory*  category;
@@ -480,7 +576,7 @@ void  uget_app_add_category (UgetApp* app, UgetNode* cnode, int save_file)
 	}
 
 	// save new category
-	if (save_file) {
+	if (save_file && uget_app_rewrite_categories (app) == FALSE) {
 		path_base = ug_build_filename (app->config_dir, "category", NULL);
 #if defined _WIN32 || defined _WIN64
 		path = ug_strdup_printf ("%s%c%.4d.json", path_base, '\\',
@@ -490,6 +586,7 @@ void  uget_app_add_category (UgetApp* app, UgetNode* cnode, int save_file)
 		                         uget_node_child_position (&app->real, cnode));
 #endif // defined
 		uget_app_save_category ((UgetApp*) app, cnode, path, NULL);
+		uget_app_snapshot_remove (path_base);
 		ug_free (path_base);
 		ug_free (path);
 	}
@@ -512,6 +609,8 @@ int  uget_app_move_category (UgetApp* app, UgetNode* cnode, UgetNode* position)
 	if (from_nth == -1 || to_nth == -1)
 		return FALSE;
 	uget_node_move (&app->real, position, cnode);
+	if (uget_app_rewrite_categories (app))
+		return TRUE;
 
 	if (app->config_dir == NULL)
 		path_base = ug_strdup ("category");
@@ -531,6 +630,7 @@ int  uget_app_move_category (UgetApp* app, UgetNode* cnode, UgetNode* position)
 	ug_rename (path1, path3);
 	ug_rename (path2, path1);
 	ug_rename (path3, path2);
+	uget_app_snapshot_remove (path_base);
 	ug_free (path1);
 	ug_free (path2);
 	ug_free (path3);
@@ -555,6 +655,8 @@ void  uget_app_delete_category (UgetApp* app, UgetNode* cnode)
 	uget_uri_hash_remove_category (app->uri_hash, cnode);
 	uget_node_remove (&app->real, cnode);
 	uget_node_free (cnode);
+	if (uget_app_rewrite_categories (app))
+		return;
 
 	if (app->config_dir == NULL)
 		path_base = ug_strdup ("category");
@@ -581,6 +683,7 @@ void  uget_app_delete_category (UgetApp* app, UgetNode* cnode)
 		ug_free (path2);
 	}
 
+	uget_app_snapshot_remove (path_base);
 	ug_free (path_base);
 }
 
@@ -786,7 +889,8 @@ int  uget_app_add_download (UgetApp* app, UgetNode* dnode, UgetNode* cnode, int
 			value = temp.common->keeping.enable;
 			temp.common->keeping.enable = TRUE;
 			temp.common->keeping.uri = TRUE;
-			ug_data_assign (dnode->data, cnode->data, UgetCategoryInfo);
+			// download share category settings until they are changed
+			ug_data_inherit (dnode->data, cnode->data, UgetCategoryInfo);
 			temp.common->keeping.enable = value;
 			relation_c = ug_data_realloc(cnode->data, UgetRelationInfo);
 			if (relation_c->group & UGET_GROUP_PAUSED)
@@ -918,6 +1022,7 @@ int  uget_app_delete_download (UgetApp* app, UgetNode* dnode, int delete_file)
 #endif
 	uget_uri_hash_remove_download(app->uri_hash, dnode->data);
 	files = ug_data_set(dnode->data, UgetFilesInfo, NULL);
+	uget_app_journal_removed(app, dnode);
 	uget_node_free(dnode);
 
 	if (delete_file == TRUE && files) {
@@ -947,6 +1052,7 @@ int  uget_app_recycle_download (UgetApp* app, UgetNode* dnode)
 
 	relation = ug_data_realloc(dnode->data, UgetRelationInfo);
 	if (relation->group & UGET_GROUP_RECYCLED) {
+		uget_app_journal_removed (app, dnode);
 		uget_node_free (dnode);
 		return FALSE;
 	}
@@ -989,19 +1095,14 @@ int   uget_app_activate_download (UgetApp* app, UgetNode* dnode)
 		// no plug-in support
 		uget_app_queue_download (app, dnode);
 		relation->group |= UGET_GROUP_ERROR;
-		ug_list_prepend (&log->messages,
-				(UgLink*) uget_event_new_error (
-						UGET_EVENT_ERROR_UNSUPPORTED_SCHEME, NULL));
+		uget_log_add (log, uget_event_new_error (
+				UGET_EVENT_ERROR_UNSUPPORTED_SCHEME, NULL));
 		uget_node_updated (dnode);
 		return FALSE;
 	}
 	else {
 		// clear event message before starting
-		ug_list_foreach (&log->messages,
-		                 (UgForeachFunc) uget_event_free, NULL);
-		log->messages.size = 0;
-		log->messages.head = NULL;
-		log->messages.tail = NULL;
+		uget_log_clear (log);
 	}
 	// start node with plug-in
 	cnode = dnode->parent;
@@ -1130,6 +1231,8 @@ void  uget_app_reset_download_name (UgetApp* app, UgetNode* dnode)
 	UgetNode*    sibling;
 	UgetNode*    cnode = NULL;
 
+	// data was edited by user
+	uget_app_journal_changed(app, dnode);
 	common = ug_data_realloc(dnode->data, UgetCommonInfo);
 	if (common->file) {
 		if (common->name && strcmp(common->file, common->name) == 0)
@@ -1168,23 +1271,39 @@ void  uget_app_use_uri_hash (UgetApp* app)
 
 void  uget_app_clear_attachment (UgetApp* app)
 {
+	UgetNode*   cnode;
 	UgetNode*   dnode;
 	UgetHttp*   http;
+	UgetCategory* category;
+	UgetColdRecord* record;
 	UgDir*      dir;
 	void*       hash;
 	const char* name;
 	char*       folder;
 	char*       path;
+	int         index;
 
 	hash = uget_uri_hash_new ();
 	// add attachment
-	for (dnode = app->mix.children->children;  dnode;  dnode = dnode->next) {
-		if ((http = ug_data_get (dnode->data, UgetHttpInfo)) == NULL)
-			continue;
-		if (http->cookie_file)
-			uget_uri_hash_add (hash, http->cookie_file);
-		if (http->post_file)
-			uget_uri_hash_add (hash, http->post_file);
+	for (cnode = app->real.children;  cnode;  cnode = cnode->next) {
+		category = ug_data_get (cnode->data, UgetCategoryInfo);
+		for (index = 0;  category && index < category->cold.records.length;  index++) {
+			record = category->cold.records.at + index;
+			if (record->cookie_file != UGET_COLD_NULL)
+				uget_uri_hash_add (hash, uget_cold_string (&category->cold,
+						record->cookie_file));
+			if (record->post_file != UGET_COLD_NULL)
+				uget_uri_hash_add (hash, uget_cold_string (&category->cold,
+						record->post_file));
+		}
+		for (dnode = cnode->children;  dnode;  dnode = dnode->next) {
+			if ((http = ug_data_get (dnode->data, UgetHttpInfo)) == NULL)
+				continue;
+			if (http->cookie_file)
+				uget_uri_hash_add (hash, http->cookie_file);
+			if (http->post_file)
+				uget_uri_hash_add (hash, http->post_file);
+		}
 	}
 
 	folder = ug_build_filename (app->config_dir, "attachment", NULL);
@@ -1364,124 +1483,419 @@ UgetNode* uget_app_load_category (UgetApp* app, const char* filename, void* json
 
 int   uget_app_save_category_fd (UgetApp* app, UgetNode* cnode, int fd, void* jsonfile)
 {
-	UgJsonFile*  jfile;
+	UgJsonFile*    jfile;
+	UgetCategory*  category;
+	int            resident = TRUE;
+	int            written;
+
+	// 'app' is NULL if it was called by thread
+	if (app) {
+		category = ug_data_get (cnode->data, UgetCategoryInfo);
+		if (category)
+			resident = category->cold.resident;
+		uget_app_page_in (app, cnode);
+	}
 
 	if (jsonfile == NULL)
 		jfile = ug_json_file_new (4096);
 	else
 		jfile = jsonfile;
 
-	if (ug_json_file_begin_write_fd (jfile, fd, UG_JSON_FORMAT_ALL) == FALSE) {
-		if (jsonfile == NULL)
-			ug_json_file_free (jfile);
-		return FALSE;
+	written = ug_json_file_begin_write_fd (jfile, fd, UG_JSON_FORMAT_ALL);
+	if (written) {
+		ug_json_write_object_head (&jfile->json);
+		ug_json_write_entry (&jfile->json, cnode, UgetNodeEntry);
+		ug_json_write_object_tail (&jfile->json);
+		ug_json_file_end_write (jfile);
 	}
-
-	ug_json_write_object_head (&jfile->json);
-	ug_json_write_entry (&jfile->json, cnode, UgetNodeEntry);
-	ug_json_write_object_tail (&jfile->json);
-
-	ug_json_file_end_write (jfile);
 	if (jsonfile == NULL)
 		ug_json_file_free (jfile);
-	return TRUE;
+
+	// writing file doesn't keep downloads in memory
+	if (resident == FALSE) {
+		category->cold.resident = FALSE;
+		uget_app_page_out (app, cnode);
+	}
+	return written;
 }
 
-UgetNode* uget_app_load_category_fd (UgetApp* app, int fd, void* jsonfile)
+static UgetNode* uget_app_parse_category_fd (UgetApp* app, int fd, UgJsonFile* jfile)
 {
-	UgJsonFile*  jfile;
 	UgJsonError  error;
 	UgetNode*    cnode;
+	UgSlice*     slice;
 
-	if (jsonfile == NULL)
-		jfile = ug_json_file_new (4096);
-	else
-		jfile = jsonfile;
-
-	if (ug_json_file_begin_parse_fd (jfile, fd) == FALSE) {
-		if (jsonfile == NULL)
-			ug_json_file_free (jfile);
-		return FALSE;
-	}
+	if (ug_json_file_begin_parse_fd (jfile, fd) == FALSE)
+		return NULL;
 
-	cnode = uget_node_new (NULL);
+	// category and it's downloads are allocated from the same arena
+	slice = ug_slice_new ();
+	cnode = uget_node_new_in (slice);
+	ug_slice_unref (slice);
 	ug_json_push (&jfile->json, ug_json_parse_entry,
 			cnode, (void*)UgetNodeEntry);
 	ug_json_push (&jfile->json, ug_json_parse_object,
 			NULL, NULL);
 
 	error = ug_json_file_end_parse (jfile);
-	if (jsonfile == NULL)
-		ug_json_file_free (jfile);
-
-	if (error == UG_JSON_ERROR_NONE) {
-		uget_app_add_category (app, cnode, FALSE);
-		// create fake node
-		uget_node_make_fake (cnode);
-		// move all downloads from active to queuing in this category
-		uget_app_stop_category (app, cnode);
-		// convert old format to new
-		remove_file_node(cnode);
-		return cnode;
-	}
-	else {
+	if (error != UG_JSON_ERROR_NONE) {
 		uget_node_free (cnode);
 		return NULL;
 	}
+	return cnode;
 }
 
-int   uget_app_save_categories (UgetApp* app, const char* folder)
+static void  uget_app_restore_category (UgetApp* app, UgetNode* cnode)
 {
-	int             count;
-	char*           path;
-	char*           path_base;
-	char*           path_new;
-	UgetNode*       cnode;
-	UgJsonFile*     jfile;
+	uget_app_add_category (app, cnode, FALSE);
+	// create fake node
+	uget_node_make_fake (cnode);
+	// move all downloads from active to queuing in this category
+	uget_app_stop_category (app, cnode);
+	// convert old format to new
+	remove_file_node(cnode);
+}
 
-	if (folder)
-		path_base = ug_build_filename (folder, "category", NULL);
-	else if (app->config_dir)
-		path_base = ug_build_filename (app->config_dir, "category", NULL);
+UgetNode* uget_app_load_category_fd (UgetApp* app, int fd, void* jsonfile)
+{
+	UgJsonFile*  jfile;
+	UgetNode*    cnode;
+
+	if (jsonfile == NULL)
+		jfile = ug_json_file_new (4096);
 	else
-		path_base = ug_strdup ("category");
-	ug_create_dir_all (path_base, -1);
+		jfile = jsonfile;
 
-	jfile = ug_json_file_new (4096);
-	cnode = app->real.children;
-	for (count = 0;  cnode;  cnode = cnode->next, count++) {
-#if defined _WIN32 || defined _WIN64
-		path = ug_strdup_printf ("%s%c%.4d.temp", path_base, '\\', count);
-#else
-		path = ug_strdup_printf ("%s%c%.4d.temp", path_base, '/',  count);
-#endif // _WIN32 || _WIN64
+	cnode = uget_app_parse_category_fd (app, fd, jfile);
+	if (jsonfile == NULL)
+		ug_json_file_free (jfile);
 
-		uget_app_save_category (app, cnode, path, jfile);
+	if (cnode) {
+		uget_app_restore_category (app, cnode);
+		// this category doesn't have file in journal's folder
+		app->journal.compact = TRUE;
+	}
+	return cnode;
+}
 
+// build path of category file. 'ext' is "json" or "temp".
+static char* uget_app_category_path (const char* path_base, int nth, const char* ext)
+{
 #if defined _WIN32 || defined _WIN64
-		path_new = ug_strdup_printf ("%s%c%.4d.json", path_base, '\\', count);
+	return ug_strdup_printf ("%s%c%.4d.%s", path_base, '\\', nth, ext);
 #else
-		path_new = ug_strdup_printf ("%s%c%.4d.json", path_base, '/',  count);
+	return ug_strdup_printf ("%s%c%.4d.%s", path_base, '/',  nth, ext);
 #endif // _WIN32 || _WIN64
+}
+
+// get size of NNNN.json. if 'fd' is -1, open file by path_base and nth.
+// stamp[0] = file size, stamp[1] = modified time. They are -1 if error.
+static void  uget_app_category_stamp (const char* path_base, int nth, int fd,
+                                      int64_t* stamp)
+{
+	char*    path;
+
+	if (fd == -1) {
+		path = uget_app_category_path (path_base, nth, "json");
+		fd = ug_open (path, UG_O_RDONLY | UG_O_TEXT, 0);
+		ug_free (path);
+		if (fd == -1) {
+			stamp[0] = -1;
+			stamp[1] = -1;
+			return;
+		}
+		stamp[0] = ug_seek (fd, 0, SEEK_END);
+		stamp[1] = ug_file_get_time (fd);
+		ug_close (fd);
+	}
+	else {
+		stamp[0] = ug_seek (fd, 0, SEEK_END);
+		stamp[1] = ug_file_get_time (fd);
+		ug_seek (fd, 0, SEEK_SET);
+	}
+}
+
+// ------------------------------------
+// parse and write category files in threads
+
+#define CATEGORY_THREADS_MAX    4
+
+typedef struct
+{
+	const char*  path_base;   // folder of *.temp files (saving)
+	UgetNode**   cnodes;      // result of parsing or nodes to write
+	int*         fds;         // files to parse (loading)
+	int          length;      // number of categories
+	int          next;        // index of next category
+	UgMutex      mutex;
+} UgetCategoryJob;
+
+static UgThreadResult  category_job_thread (UgetCategoryJob* job)
+{
+	UgJsonFile*  jfile;
+	char*        path;
+	int          index;
+
+	jfile = ug_json_file_new (4096);
+	for (;;) {
+		ug_mutex_lock (&job->mutex);
+		index = job->next++;
+		ug_mutex_unlock (&job->mutex);
+		if (index >= job->length)
+			break;
+
+		if (job->fds)
+			job->cnodes[index] = uget_app_parse_category_fd (NULL, job->fds[index], jfile);
+		else {
+			path = uget_app_category_path (job->path_base, index, "temp");
+			uget_app_save_category (NULL, job->cnodes[index], path, jfile);
+			ug_free (path);
+		}
+	}
+	ug_json_file_free (jfile);
+	return UG_THREAD_RESULT;
+}
+
+// categories are independent files, calling thread works with other threads.
+static void  category_job_run (UgetCategoryJob* job)
+{
+	UgThread  threads[CATEGORY_THREADS_MAX - 1];
+	int       n_threads, index;
+
+	job->next = 0;
+	ug_mutex_init (&job->mutex);
+	n_threads = (job->length < CATEGORY_THREADS_MAX) ? job->length : CATEGORY_THREADS_MAX;
+	for (index = 0;  index < n_threads - 1;  index++) {
+		if (ug_thread_create (threads + index, (UgThreadFunc) category_job_thread, job) != UG_THREAD_OK)
+			break;
+	}
+	n_threads = index;
+	category_job_thread (job);
+	for (index = 0;  index < n_threads;  index++)
+		ug_thread_join (threads + index);
+	ug_mutex_clear (&job->mutex);
+}
+
+// ------------------------------------
+// rewrite all category files in background
+
+typedef struct
+{
+	UgThread     thread;
+	UgMutex      mutex;
+	int          joinable;    // FALSE if thread can't be created
+	int          done;        // TRUE if thread finished
+	char*        path_base;
+	int          journal_fd;
+	int          journal_close;  // TRUE if journal_fd is in other folder
+	int          n_nodes;     // number of downloads, id of "base" record
+	int          length;      // number of categories
+	uint32_t*    offsets;     // offset of category nodes in 'records'
+	UgBuffer     strings;
+	UgBuffer     records;
+	UgArrayPtr   groups;
+	UgetSnapshotWriter*  writer;
+} UgetCategoryCompactor;
+
+static UgThreadResult  category_compactor_thread (UgetCategoryCompactor* compactor)
+{
+	UgetCategoryJob  job;
+	int64_t*   stamps;
+	char*      path;
+	char*      path_new;
+	int        index, count;
+
+	// decode packed categories. Nodes are used by this thread only.
+	count = compactor->length;
+	job.path_base = compactor->path_base;
+	job.cnodes = ug_malloc (sizeof (UgetNode*) * (count + 1));
+	job.fds = NULL;
+	job.length = count;
+	for (index = 0;  index < count;  index++) {
+		job.cnodes[index] = uget_snapshot_read_node (&compactor->strings,
+				&compactor->records, &compactor->groups, compactor->offsets[index],
+				NULL);
+		if (job.cnodes[index] == NULL)
+			job.cnodes[index] = uget_node_new (NULL);
+	}
+	// write all *.temp files before replacing any *.json file
+	category_job_run (&job);
+	for (index = 0;  index < count;  index++)
+		uget_node_free (job.cnodes[index]);
+	ug_free (job.cnodes);
+
+	// journal mark *.temp files complete, loader can replace *.json by them.
+	uget_app_journal_mark_compact (compactor->journal_fd);
+	uget_app_snapshot_remove (compactor->path_base);
+	for (index = 0;  index < count;  index++) {
+		path = uget_app_category_path (compactor->path_base, index, "temp");
+		path_new = uget_app_category_path (compactor->path_base, index, "json");
 		ug_unlink (path_new);
 		ug_rename (path, path_new);
-
 		ug_free (path_new);
 		ug_free (path);
 	}
+	// remove files of deleted categories
+	for (index = count;  ;  index++) {
+		path = uget_app_category_path (compactor->path_base, index, "json");
+		if (ug_unlink (path) == -1) {
+			ug_free (path);
+			break;
+		}
+		ug_free (path);
+	}
+	// binary snapshot for faster loading, it has the same packed nodes.
+	stamps = ug_malloc (sizeof (int64_t) * 2 * (count + 1));
+	for (index = 0;  index < count;  index++)
+		uget_app_category_stamp (compactor->path_base, index, -1, stamps + index*2);
+	uget_app_snapshot_save (compactor->writer, compactor->path_base, stamps, count);
+	ug_free (stamps);
+	uget_app_journal_end_compact (compactor->journal_fd, compactor->n_nodes);
+
+	ug_mutex_lock (&compactor->mutex);
+	compactor->done = TRUE;
+	ug_mutex_unlock (&compactor->mutex);
+	return UG_THREAD_RESULT;
+}
+
+// pack categories in calling thread, then write them in background.
+static void  category_compactor_start (UgetApp* app, const char* path_base)
+{
+	UgetCategoryCompactor*  compactor;
+	UgetCategory*  category;
+	UgetNode*  cnode;
+	int*       cold;
+	int        index;
+
+	compactor = ug_malloc0 (sizeof (UgetCategoryCompactor));
+	compactor->path_base = ug_strdup (path_base);
+	compactor->length = app->real.n_children;
+	compactor->offsets = ug_malloc (sizeof (uint32_t) * (compactor->length + 1));
+	ug_buffer_init (&compactor->strings, 65536);
+	ug_buffer_init (&compactor->records, 65536);
+	ug_array_init (&compactor->groups, sizeof (void*), 16);
+	compactor->writer = uget_snapshot_writer_new (&compactor->strings,
+			&compactor->records, &compactor->groups);
+
+	// page in downloads that are not loaded, give new ids to all downloads
+	// by order, then pack them and page out them.
+	ug_create_dir_all (path_base, -1);
+	// 'cold' is TRUE if category was not paged in by user.
+	cold = ug_malloc (sizeof (int) * (compactor->length + 1));
+	for (index = 0, cnode = app->real.children;  cnode;  cnode = cnode->next) {
+		category = ug_data_get (cnode->data, UgetCategoryInfo);
+		cold[index++] = (category && category->cold.resident == FALSE);
+		uget_app_page_in (app, cnode);
+	}
+	compactor->n_nodes = uget_app_journal_begin_compact (app, path_base,
+			&compactor->journal_fd);
+	compactor->journal_close = (compactor->journal_fd != app->journal.fd);
+	for (index = 0, cnode = app->real.children;  cnode;  cnode = cnode->next, index++) {
+		compactor->offsets[index] = uget_snapshot_write_node (compactor->writer, cnode);
+		if (cold[index]) {
+			category = ug_data_get (cnode->data, UgetCategoryInfo);
+			category->cold.resident = FALSE;
+			uget_app_page_out (app, cnode);
+		}
+	}
+	ug_free (cold);
+
+	ug_mutex_init (&compactor->mutex);
+	app->journal.compactor = compactor;
+	compactor->joinable = (ug_thread_create (&compactor->thread,
+			(UgThreadFunc) category_compactor_thread, compactor) == UG_THREAD_OK);
+	if (compactor->joinable == FALSE)
+		category_compactor_thread (compactor);
+}
+
+// return FALSE if compactor is still running and 'wait' is FALSE.
+static int  category_compactor_finish (UgetApp* app, int wait)
+{
+	UgetCategoryCompactor*  compactor;
+	int  done;
+
+	compactor = app->journal.compactor;
+	if (compactor == NULL)
+		return TRUE;
+	if (wait == FALSE) {
+		ug_mutex_lock (&compactor->mutex);
+		done = compactor->done;
+		ug_mutex_unlock (&compactor->mutex);
+		if (done == FALSE)
+			return FALSE;
+	}
+	if (compactor->joinable)
+		ug_thread_join (&compactor->thread);
+	app->journal.compactor = NULL;
+
+	if (compactor->journal_close && compactor->journal_fd != -1)
+		ug_close (compactor->journal_fd);
+	ug_mutex_clear (&compactor->mutex);
+	uget_snapshot_writer_free (compactor->writer);
+	ug_buffer_clear (&compactor->records, TRUE);
+	ug_buffer_clear (&compactor->strings, TRUE);
+	ug_array_clear (&compactor->groups);
+	ug_free (compactor->offsets);
+	ug_free (compactor->path_base);
+	ug_free (compactor);
+	return TRUE;
+}
+
+void  uget_app_wait_categories (UgetApp* app)
+{
+	category_compactor_finish (app, TRUE);
+}
+
+int   uget_app_save_categories (UgetApp* app, const char* folder)
+{
+	UgetCategoryCompactor*  compactor;
+	UgetNode*  cnode;
+	char*  path_base;
+
+	if (folder)
+		path_base = ug_build_filename (folder, "category", NULL);
+	else if (app->config_dir)
+		path_base = ug_build_filename (app->config_dir, "category", NULL);
+	else
+		path_base = ug_strdup ("category");
+
+	// Journal can't be used until category files are rewritten.
+	// Changes will be appended by next saving.
+	compactor = app->journal.compactor;
+	if (compactor && strcmp (compactor->path_base, path_base) == 0 &&
+	    category_compactor_finish (app, FALSE) == FALSE)
+	{
+		ug_free (path_base);
+		return app->real.n_children;
+	}
+	category_compactor_finish (app, TRUE);
+
+	// append changed downloads to journal if possible
+	if (uget_app_journal_append (app, path_base) &&
+	    app->journal.n_records <= app->journal.limit)
+	{
+		// journal has finished downloads now, page out them.
+		for (cnode = app->real.children;  cnode;  cnode = cnode->next)
+			uget_app_page_out (app, cnode);
+		ug_free (path_base);
+		return app->real.n_children;
+	}
 
+	category_compactor_start (app, path_base);
 	ug_free (path_base);
-	ug_json_file_free (jfile);
-	return count;
+	return app->real.n_children;
 }
 
 int   uget_app_load_categories (UgetApp* app, const char* folder)
 {
-	int             count, fd;
+	int             count, index, fd, compacting;
 	char*           path;
 	char*           path_base;
 	char*           path_temp;
-	UgJsonFile*     jfile;
+	UgetCategoryJob job;
+	UgArrayPtr      cnodes;
+	UgArrayInt      fds;
+	UgArrayInt64    stamps;
 
 	if (folder)
 		path_base = ug_build_filename (folder, "category", NULL);
@@ -1490,17 +1904,20 @@ int   uget_app_load_categories (UgetApp* app, const char* folder)
 	else
 		path_base = ug_strdup ("category");
 
-	jfile = ug_json_file_new (4096);
+	uget_app_wait_categories (app);
+	// program stopped while replacing *.json files, *.temp files are newer.
+	compacting = uget_app_journal_is_compacting (app, path_base);
 
+	ug_array_init (&fds, sizeof (int), 16);
+	ug_array_init (&stamps, sizeof (int64_t), 32);
 	for (count = 0;  ;  count++) {
-#if defined _WIN32 || defined _WIN64
-		path = ug_strdup_printf ("%s%c%.4d.json", path_base, '\\', count);
-		path_temp = ug_strdup_printf ("%s%c%.4d.temp", path_base, '\\', count);
-#else
-		path = ug_strdup_printf ("%s%c%.4d.json", path_base, '/',  count);
-		path_temp = ug_strdup_printf ("%s%c%.4d.temp", path_base, '/',  count);
-#endif // _WIN32 || _WIN64
+		path = uget_app_category_path (path_base, count, "json");
+		path_temp = uget_app_category_path (path_base, count, "temp");
 
+		if (compacting && ug_file_is_exist (path_temp)) {
+			ug_unlink (path);
+			ug_rename (path_temp, path);
+		}
 //		fd = open (filename, O_RDONLY, 0);
 		fd = ug_open (path, UG_O_RDONLY | UG_O_TEXT, 0);
 		if (fd != -1)
@@ -1511,11 +1928,45 @@ int   uget_app_load_categories (UgetApp* app, const char* folder)
 		ug_free (path);
 		if (fd == -1)
 			break;
+		*(int*) ug_array_alloc (&fds, 1) = fd;
+		uget_app_category_stamp (NULL, 0, fd, ug_array_alloc (&stamps, 2));
+	}
 
-		uget_app_load_category_fd (app, fd, jfile);
+	// use binary snapshot if it match NNNN.json files
+	ug_array_init (&cnodes, sizeof (void*), count + 1);
+	ug_array_alloc (&cnodes, count);
+	if (compacting == FALSE &&
+	    uget_app_snapshot_load (app, path_base, stamps.at, count,
+	                            (UgetNode**) cnodes.at) == count && count > 0)
+	{
+		for (index = 0;  index < fds.length;  index++)
+			ug_close (fds.at[index]);
+	}
+	else {
+		job.path_base = NULL;
+		job.cnodes = (UgetNode**) cnodes.at;
+		job.fds = fds.at;
+		job.length = fds.length;
+		category_job_run (&job);
+		// remove categories that failed to parse
+		for (cnodes.length = 0, index = 0;  index < fds.length;  index++) {
+			if (job.cnodes[index])
+				cnodes.at[cnodes.length++] = job.cnodes[index];
+		}
+	}
+	ug_array_clear (&fds);
+	ug_array_clear (&stamps);
+
+	// apply journal to categories before creating fake nodes
+	uget_app_journal_replay (app, path_base, (UgetNode**) cnodes.at,
+	                         cnodes.length, count);
+	for (index = 0;  index < cnodes.length;  index++) {
+		// finished and recycled downloads will be loaded on demand
+		uget_app_page_out (app, cnodes.at[index]);
+		uget_app_restore_category (app, cnodes.at[index]);
 	}
+	ug_array_clear (&cnodes);
 
-	ug_json_file_free (jfile);
 	ug_free (path_base);
 	return count;
 }
@@ -1570,7 +2021,7 @@ void  uget_node_set_keeping (UgetNode* node, int enable)
 		}
 	}
 
-	temp.proxy = ug_data_get (node->data, UgetProxyInfo);
+	temp.proxy = ug_data_get_writable (node->data, UgetProxyInfo);
 	if (temp.proxy) {
 		temp.proxy->keeping.enable = enable;
 		if (enable) {
@@ -1587,7 +2038,7 @@ void  uget_node_set_keeping (UgetNode* node, int enable)
 		}
 	}
 
-	temp.http = ug_data_get (node->data, UgetHttpInfo);
+	temp.http = ug_data_get_writable (node->data, UgetHttpInfo);
 	if (temp.http) {
 		temp.http->keeping.enable = enable;
 		if (enable) {
@@ -1612,7 +2063,7 @@ void  uget_node_set_keeping (UgetNode* node, int enable)
 		}
 	}
 
-	temp.ftp = ug_data_get (node->data, UgetFtpInfo);
+	temp.ftp = ug_data_get_writable (node->data, UgetFtpInfo);
 	if (temp.ftp) {
 		temp.ftp->keeping.enable = enable;
 		if (enable) {
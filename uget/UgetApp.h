@@ -49,6 +49,23 @@ extern "C" {
 #endif
 
 typedef struct  UgetApp          UgetApp;
+typedef struct  UgetAppJournal   UgetAppJournal;
+
+// ----------------------------------------------------------------------------
+// UgetAppJournal: uget_app_save_categories() append changes of downloads to
+//                 journal file instead of rewriting all category files.
+
+struct UgetAppJournal
+{
+	char*       path;       // path of journal file
+	int         fd;         // -1 if journal file is not opened
+	int         next_id;    // id for new download
+	int         n_records;  // number of records after rewriting categories
+	int         limit;      // rewrite categories if n_records > limit
+	int         compact;    // TRUE: rewrite categories in next saving
+	UgArrayInt  removed;    // id of removed downloads
+	void*       compactor;  // rewriting categories in background, see UgetApp.c
+};
 
 // ----------------------------------------------------------------------------
 // UgetApp
@@ -60,6 +77,10 @@ typedef struct  UgetApp          UgetApp;
 	UgetNode        sorted_split;   \
 	UgetNode        mix;            \
 	UgetNode        mix_split;      \
+	int             n_sorted_refs;  \
+	int             n_sorted_split_refs; \
+	int             n_mix_refs;     \
+	UgetAppJournal  journal;        \
 	UgRegistry      infos;          \
 	UgRegistry      plugins;        \
 	UgetPluginInfo* plugin_default; \
@@ -82,6 +103,10 @@ struct UgetApp
 	UgetNode        sorted_split;   // virtual root
 	UgetNode        mix;            // virtual root
 	UgetNode        mix_split;      // virtual root
+	int             n_sorted_refs;  // reference count of virtual roots,
+	int             n_sorted_split_refs; // see uget_app_ref_view()
+	int             n_mix_refs;     // (mix and mix_split)
+	UgetAppJournal  journal;
 	UgRegistry      infos;
 	UgRegistry      plugins;
 	UgetPluginInfo* plugin_default;
@@ -107,6 +132,12 @@ int   uget_app_grow (UgetApp* app, int no_queuing);
 int   uget_app_trim (UgetApp* app);
 
 void  uget_app_set_config_dir (UgetApp* app, const char* dir);
+
+// virtual roots (sorted, sorted_split, mix, and mix_split) are built when
+// they are referenced and dropped when no one reference them.
+// app->real and app->split are always available.
+void  uget_app_ref_view (UgetApp* app, UgetNode* view);
+void  uget_app_unref_view (UgetApp* app, UgetNode* view);
 void  uget_app_set_sorting (UgetApp* app, UgCompareFunc func, int reversed);
 void  uget_app_set_notification (UgetApp* app, void* data,
                                  UgetNodeFunc inserted,
@@ -163,8 +194,127 @@ UgetNode* uget_app_load_category (UgetApp* app, const char* filename, void* json
 int       uget_app_save_category_fd (UgetApp* app, UgetNode* cnode, int fd, void* jsonfile);
 UgetNode* uget_app_load_category_fd (UgetApp* app, int fd, void* jsonfile);
 // return number of category save/load
+// If all category files must be rewritten, uget_app_save_categories() pack
+// categories and write files in background. Changes are appended to journal
+// by next saving after it is done.
 int   uget_app_save_categories (UgetApp* app, const char* folder);
 int   uget_app_load_categories (UgetApp* app, const char* folder);
+// wait for category files that are written in background.
+void  uget_app_wait_categories (UgetApp* app);
+
+// ----------------------------------------------------------------------------
+// journal of categories, these functions implemented in UgetApp-journal.c
+/*
+   "category/journal.json" has one JSON object per line. Downloads in category
+   files get id by order, new downloads get id from journal. Each saving append
+   records and a "commit" record. Loader apply records before "commit" only.
+
+   {"op":"base",   "id":N}     <- first record. category files have N downloads.
+   {"op":"remove", "ids":[id, id...]}
+   {"op":"add",    "id":id, "category":nth, "after":id, "data":{...}}
+   {"op":"move",   "id":id, "category":nth, "after":id}
+   {"op":"update", "id":id, "data":{...}}
+   {"op":"commit"}
+   {"op":"compact"}           <- first record. NNNN.temp files are complete.
+ */
+
+void  uget_app_journal_init (UgetApp* app);
+void  uget_app_journal_final (UgetApp* app);
+// data of node changed by user (e.g. UI). If node is category,
+// all category files will be rewritten in next saving.
+void  uget_app_journal_changed (UgetApp* app, UgetNode* node);
+// dnode will be removed. (used by UgetApp.c)
+void  uget_app_journal_removed (UgetApp* app, UgetNode* dnode);
+
+// uget_app_journal_append() return FALSE if categories must be rewritten.
+// They should be rewritten too if journal.n_records > journal.limit.
+int   uget_app_journal_append (UgetApp* app, const char* path_base);
+// Rewriting categories (compaction) can run in other thread:
+// begin_compact() give new id to downloads by order of categories and return
+// number of downloads. Call it before packing categories. Other two only use
+// 'fd' that returned by begin_compact(), call mark_compact() after writing
+// NNNN.temp and before renaming them to NNNN.json, call end_compact() after
+// renaming.
+// If categories are written to other folder, journal is not changed and 'fd'
+// is new journal file in that folder, caller must close it.
+int   uget_app_journal_begin_compact (UgetApp* app, const char* path_base, int* fd);
+void  uget_app_journal_mark_compact (int fd);
+void  uget_app_journal_end_compact (int fd, int n_nodes);
+// return TRUE if NNNN.temp files are newer than NNNN.json
+int   uget_app_journal_is_compacting (UgetApp* app, const char* path_base);
+// apply journal to loaded (and not added) category nodes. 'n_files' is number
+// of category files, journal is dropped if some of them failed to load.
+// return FALSE if journal doesn't match category files.
+int   uget_app_journal_replay (UgetApp* app, const char* path_base,
+                               UgetNode** cnodes, int n_cnodes, int n_files);
+
+// ----------------------------------------------------------------------------
+// binary snapshot of categories, these functions implemented in UgetApp-snapshot.c
+/*
+   "category/snapshot.bin" is written after rewriting all NNNN.json files and
+   has the same nodes. It stores strings once in string table and fields of
+   UgData in fixed layout that decided by UgEntry. Loader map it to memory and
+   ignore it if size or modified time of any NNNN.json or layout of any group
+   was changed.
+   NNNN.json files are still used for importing, exporting and fallback.
+ */
+
+typedef struct UgetSnapshotWriter  UgetSnapshotWriter;
+
+// 'writer' has packed category nodes, one node per NNNN.json file.
+// 'stamps' has size and modified time of NNNN.json files, 2 values per file.
+int   uget_app_snapshot_save (UgetSnapshotWriter* writer, const char* path_base,
+                              const int64_t* stamps, int n_files);
+// decode category nodes to 'cnodes'. These nodes are not added to app.
+// return number of decoded nodes or 0 if snapshot doesn't match NNNN.json.
+int   uget_app_snapshot_load (UgetApp* app, const char* path_base,
+                              const int64_t* stamps, int n_files,
+                              UgetNode** cnodes);
+void  uget_app_snapshot_remove (const char* path_base);
+
+// pack nodes in memory with the layout of snapshot file. Strings are stored
+// once in 'strings', nodes are appended to 'records'. (used by UgetApp-cold.c)
+// If 'strings' is not empty, writer reuses strings in it.
+UgetSnapshotWriter* uget_snapshot_writer_new (UgBuffer* strings, UgBuffer* records,
+                                              UgArrayPtr* groups);
+void      uget_snapshot_writer_free (UgetSnapshotWriter* writer);
+// return offset of 'string' in 'strings'. 'string' can't be NULL.
+uint32_t  uget_snapshot_write_string (UgetSnapshotWriter* writer, const char* string);
+// return offset of node in 'records'.
+uint32_t  uget_snapshot_write_node (UgetSnapshotWriter* writer, UgetNode* node);
+// return NULL if data is broken. Nodes are allocated from arena 'slice'.
+UgetNode* uget_snapshot_read_node (UgBuffer* strings, UgBuffer* records,
+                                   UgArrayPtr* groups, uint32_t offset,
+                                   UgSlice* slice);
+
+// ----------------------------------------------------------------------------
+// finished and recycled downloads are loaded on demand,
+// these functions implemented in UgetApp-cold.c
+/*
+   Loader keep the tail of category that only has finished or recycled
+   downloads as compact records (UgetColdRecord) in UgetCategory::cold.
+   Record has summary of download and it's packed node, strings of category
+   are stored once. They are paged in when user views them or category is
+   written to file. trim() removes records without paging in, buffers are
+   packed again when most of records were removed.
+   Downloads that finished later are paged out after journal has them, until
+   user pages in the category.
+   Paged-in downloads are appended to category, but finished downloads are
+   inserted before loaded recycled downloads. Journal records their moves.
+ */
+
+// page out tail of category and put them before paged-out downloads.
+// It does nothing if category was paged in.
+// return number of paged-out downloads.
+int   uget_app_page_out (UgetApp* app, UgetNode* cnode);
+// page in downloads of category. If 'cnode' is NULL, page in all categories.
+// return number of paged-in downloads.
+int   uget_app_page_in (UgetApp* app, UgetNode* cnode);
+// remove last paged-out download that is in 'group'. return FALSE if not found.
+int   uget_app_page_remove (UgetApp* app, UgetNode* cnode, int group);
+// return number of paged-out downloads that are shown by 'node'. 'node' can be
+// category, "All Category" or status (split fake node) of them.
+int   uget_app_count_paged_out (UgetNode* node);
 
 // ----------------------------------------------------------------------------
 // keeping status
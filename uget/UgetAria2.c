@@ -275,7 +275,6 @@ static void  recycle_speed_request (UgetAria2* uaria2, UgJsonrpcObject* jreq)
 
 	jres = uget_aria2_respond (uaria2, jreq);
 	if (jres && jres->error.code == 0) {
-		ug_value_sort_name (&jres->result);
 		value = ug_value_find_name (&jres->result, "downloadSpeed");
 		uaria2->speed.download = ug_value_get_int (value);
 		value = ug_value_find_name (&jres->result, "uploadSpeed");
@@ -425,6 +424,8 @@ UgetAria2* uget_aria2_new (void)
 	value->type = UG_VALUE_STRING;
 	value->c.string = "followedBy";
 
+	// all responses are parsed by UgJsonrpcObjectEntry
+	ug_entry_index_add (UgJsonrpcObjectEntry);
 	return uaria2;
 }
 
@@ -445,6 +446,7 @@ void uget_aria2_unref (UgetAria2* uaria2)
 
 		ug_value_foreach (&uaria2->status_keys, ug_value_set_string, NULL);
 		ug_value_clear (&uaria2->status_keys);
+		ug_entry_index_remove (UgJsonrpcObjectEntry);
 
 		ug_mutex_clear (&uaria2->completed_mutex);
 		ug_mutex_clear (&uaria2->mutex);
@@ -689,6 +691,11 @@ UgJsonrpcObject*  uget_aria2_alloc (UgetAria2* uaria2, int is_request, int has_r
 		result = uaria2->recycled.at[--uaria2->recycled.length];
 	ug_mutex_unlock (&uaria2->mutex);
 
+	// response is parsed into arena. It is reset by uget_aria2_recycle() and
+	// stay warm in recycled objects.
+	if (is_request == FALSE && result->arena == NULL)
+		result->arena = ug_arena_new (0);
+
 	// RPC authorization secret token (aria2 v1.18.4)
 	if (is_request) {
 		ug_mutex_lock (&uaria2->mutex);
@@ -35,6 +35,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <UgString.h>
 #include <UgJson.h>
 #include <UgUtil.h>
@@ -58,7 +59,7 @@ static const UgEntry  UgetCommonEntry[] =
 	{"file",     offsetof(UgetCommon, file),     UG_ENTRY_STRING,
 			NULL, UG_ENTRY_NO_NULL},
 	{"folder",   offsetof(UgetCommon, folder),   UG_ENTRY_STRING,
-			NULL, UG_ENTRY_NO_NULL},
+			(void*) ug_str_intern, UG_ENTRY_NO_NULL},
 	{"user",     offsetof(UgetCommon, user),     UG_ENTRY_STRING,
 			NULL, UG_ENTRY_NO_NULL},
 	{"password", offsetof(UgetCommon, password), UG_ENTRY_STRING,
@@ -92,6 +93,7 @@ static const UgGroupDataInfo  UgetCommonInfoStatic =
 	(UgFinalFunc)  uget_common_final,
 	(UgAssignFunc) uget_common_assign,
 	UgetCommonEntry,
+	UGET_DATA_SLOT_COMMON,
 };
 // extern
 const UgGroupDataInfo*  UgetCommonInfo = &UgetCommonInfoStatic;
@@ -115,7 +117,7 @@ static void uget_common_final(UgetCommon* common)
 	ug_free(common->uri);
 	ug_free(common->mirrors);
 	ug_free(common->file);
-	ug_free(common->folder);
+	ug_str_unref(common->folder);
 	ug_free(common->user);
 	ug_free(common->password);
 }
@@ -145,8 +147,7 @@ static int  uget_common_assign(UgetCommon* common, UgetCommon* src)
 		common->keeping.file = src->keeping.file;
 	}
 	if (common->keeping.enable == FALSE || common->keeping.folder == FALSE) {
-		ug_free(common->folder);
-		common->folder = (src->folder) ? ug_strdup(src->folder) : NULL;
+		ug_str_set_shared(&common->folder, src->folder);
 		common->keeping.folder = src->keeping.folder;
 	}
 	if (common->keeping.enable == FALSE || common->keeping.user == FALSE) {
@@ -267,6 +268,7 @@ static const UgGroupDataInfo  UgetProgressInfoStatic =
 	(UgFinalFunc)  NULL,
 	(UgAssignFunc) NULL,
 	UgetProgressEntry,
+	UGET_DATA_SLOT_PROGRESS,
 };
 // extern
 const UgGroupDataInfo*  UgetProgressInfo = &UgetProgressInfoStatic;
@@ -294,7 +296,7 @@ static const UgEntry  UgetProxyPwmdEntry[] =
 static const UgEntry  UgetProxyEntry[] =
 {
 	{"host",     offsetof(UgetProxy, host),     UG_ENTRY_STRING,
-			NULL, UG_ENTRY_NO_NULL},
+			(void*) ug_str_intern, UG_ENTRY_NO_NULL},
 	{"port",     offsetof(UgetProxy, port),     UG_ENTRY_UINT,
 			NULL, NULL},
 	{"type",     offsetof(UgetProxy, type),     UG_ENTRY_UINT,
@@ -324,7 +326,7 @@ const UgGroupDataInfo*  UgetProxyInfo = &UgetProxyInfoStatic;
 
 static void  uget_proxy_final(UgetProxy* proxy)
 {
-	ug_free(proxy->host);
+	ug_str_unref(proxy->host);
 	ug_free(proxy->user);
 	ug_free(proxy->password);
 
@@ -339,8 +341,7 @@ static void  uget_proxy_final(UgetProxy* proxy)
 static int   uget_proxy_assign(UgetProxy* proxy, UgetProxy* src)
 {
 	if (proxy->keeping.enable == FALSE || proxy->keeping.host == FALSE) {
-		ug_free(proxy->host);
-		proxy->host = (src->host) ? ug_strdup(src->host) : NULL;
+		ug_str_set_shared(&proxy->host, src->host);
 		proxy->keeping.host = src->keeping.host;
 	}
 	if (proxy->keeping.enable == FALSE || proxy->keeping.port == FALSE) {
@@ -406,17 +407,17 @@ static const UgEntry  UgetHttpEntry[] =
 	{"password",          offsetof(UgetHttp, password),     UG_ENTRY_STRING,
 			NULL, UG_ENTRY_NO_NULL},
 	{"referrer",          offsetof(UgetHttp, referrer),     UG_ENTRY_STRING,
-			NULL, UG_ENTRY_NO_NULL},
+			(void*) ug_str_intern, UG_ENTRY_NO_NULL},
 	{"user-agent",        offsetof(UgetHttp, user_agent),   UG_ENTRY_STRING,
-			NULL, UG_ENTRY_NO_NULL},
+			(void*) ug_str_intern, UG_ENTRY_NO_NULL},
 	{"post-data",         offsetof(UgetHttp, post_data),    UG_ENTRY_STRING,
 			NULL, UG_ENTRY_NO_NULL},
 	{"post-file",         offsetof(UgetHttp, post_file),    UG_ENTRY_STRING,
-			NULL, UG_ENTRY_NO_NULL},
+			(void*) ug_str_intern, UG_ENTRY_NO_NULL},
 	{"cookie-data",       offsetof(UgetHttp, cookie_data),  UG_ENTRY_STRING,
 			NULL, UG_ENTRY_NO_NULL},
 	{"cookie-file",       offsetof(UgetHttp, cookie_file),  UG_ENTRY_STRING,
-			NULL, UG_ENTRY_NO_NULL},
+			(void*) ug_str_intern, UG_ENTRY_NO_NULL},
 	{"redirection-limit", offsetof(UgetHttp, redirection_limit),UG_ENTRY_UINT,
 			NULL, NULL},
 	{NULL},    // null-terminated
@@ -443,12 +444,12 @@ static void  uget_http_final(UgetHttp* http)
 {
 	ug_free(http->user);
 	ug_free(http->password);
-	ug_free(http->referrer);
-	ug_free(http->user_agent);
+	ug_str_unref(http->referrer);
+	ug_str_unref(http->user_agent);
 	ug_free(http->post_data);
-	ug_free(http->post_file);
+	ug_str_unref(http->post_file);
 	ug_free(http->cookie_data);
-	ug_free(http->cookie_file);
+	ug_str_unref(http->cookie_file);
 }
 
 static int   uget_http_assign(UgetHttp* http, UgetHttp* src)
@@ -464,13 +465,11 @@ static int   uget_http_assign(UgetHttp* http, UgetHttp* src)
 		http->keeping.password = src->keeping.password;
 	}
 	if (http->keeping.enable == FALSE || http->keeping.referrer == FALSE) {
-		ug_free(http->referrer);
-		http->referrer = (src->referrer) ? ug_strdup(src->referrer) : NULL;
+		ug_str_set_shared(&http->referrer, src->referrer);
 		http->keeping.referrer = src->keeping.referrer;
 	}
 	if (http->keeping.enable == FALSE || http->keeping.user_agent == FALSE) {
-		ug_free(http->user_agent);
-		http->user_agent = (src->user_agent) ? ug_strdup(src->user_agent) : NULL;
+		ug_str_set_shared(&http->user_agent, src->user_agent);
 		http->keeping.user_agent = src->keeping.user_agent;
 	}
 	if (http->keeping.enable == FALSE || http->keeping.post_data == FALSE) {
@@ -479,8 +478,7 @@ static int   uget_http_assign(UgetHttp* http, UgetHttp* src)
 		http->keeping.post_data = src->keeping.post_data;
 	}
 	if (http->keeping.enable == FALSE || http->keeping.post_file == FALSE) {
-		ug_free(http->post_file);
-		http->post_file = (src->post_file) ? ug_strdup(src->post_file) : NULL;
+		ug_str_set_shared(&http->post_file, src->post_file);
 		http->keeping.post_file = src->keeping.post_file;
 	}
 	if (http->keeping.enable == FALSE || http->keeping.cookie_data == FALSE) {
@@ -489,8 +487,7 @@ static int   uget_http_assign(UgetHttp* http, UgetHttp* src)
 		http->keeping.cookie_data = src->keeping.cookie_data;
 	}
 	if (http->keeping.enable == FALSE || http->keeping.cookie_file == FALSE) {
-		ug_free(http->cookie_file);
-		http->cookie_file = (src->cookie_file) ? ug_strdup(src->cookie_file) : NULL;
+		ug_str_set_shared(&http->cookie_file, src->cookie_file);
 		http->keeping.cookie_file = src->keeping.cookie_file;
 	}
 	if (http->keeping.enable == FALSE || http->keeping.redirection_limit == FALSE) {
@@ -591,15 +588,64 @@ static const UgGroupDataInfo  UgetLogInfoStatic =
 	(UgFinalFunc)  uget_log_final,
 	(UgAssignFunc) NULL,
 	UgetLogEntry,      // entry
+	UGET_DATA_SLOT_LOG,
 };
 // extern
 const UgGroupDataInfo*  UgetLogInfo = &UgetLogInfoStatic;
 
+static int   uget_log_capacity = UGET_LOG_CAPACITY;
+
 static void  uget_log_final(UgetLog* log)
 {
 	ug_list_foreach(&log->messages, (UgForeachFunc) uget_event_free, NULL);
 }
 
+void  uget_log_set_capacity(int capacity)
+{
+	if (capacity < 1)
+		capacity = 1;
+	uget_log_capacity = capacity;
+}
+
+void  uget_log_add(UgetLog* log, UgetEvent* event)
+{
+	UgetEvent*  link;
+	int         count;
+
+	// find identical message in recent messages
+	link = (UgetEvent*) log->messages.head;
+	for (count = 0;  link && count < UGET_LOG_RECENT;  count++, link = link->next) {
+		if (link->type != event->type || link->value.code != event->value.code)
+			continue;
+		if (link->string == event->string || (link->string && event->string &&
+		    strcmp(link->string, event->string) == 0))
+		{
+			if (link->repeats == 0)
+				link->first_time = link->time;
+			link->repeats++;
+			link->time = event->time;
+			uget_event_free(event);
+			// it become the newest one
+			ug_list_remove(&log->messages, (UgLink*) link);
+			ug_list_prepend(&log->messages, (UgLink*) link);
+			return;
+		}
+	}
+
+	ug_list_prepend(&log->messages, (UgLink*) event);
+	while (log->messages.size > uget_log_capacity) {
+		link = (UgetEvent*) log->messages.tail;
+		ug_list_remove(&log->messages, (UgLink*) link);
+		uget_event_free(link);
+	}
+}
+
+void  uget_log_clear(UgetLog* log)
+{
+	ug_list_foreach(&log->messages, (UgForeachFunc) uget_event_free, NULL);
+	ug_list_init(&log->messages);
+}
+
 static UgJsonError ug_json_parse_list_message(UgJson* json, const char* name,
                                               const char* value,
                                               void* list, void* none)
@@ -608,6 +654,11 @@ static UgJsonError ug_json_parse_list_message(UgJson* json, const char* name,
 
 	if (json->type != UG_JSON_OBJECT)
 		return UG_JSON_ERROR_TYPE_NOT_MATCH;
+	// messages are newest first, skip older one that over capacity.
+	if (((UgList*) list)->size >= uget_log_capacity) {
+		ug_json_push(json, ug_json_parse_unknown, NULL, NULL);
+		return UG_JSON_ERROR_NONE;
+	}
 
 	event = uget_event_new(UGET_EVENT_EMPTY);
 	ug_list_append(list, (UgLink*) event);
@@ -622,6 +673,13 @@ void  ug_json_write_list_message(UgJson* json, UgList* list)
 	for (link = (void*)list->head;  link;  link = link->next) {
 		ug_json_write_object_head(json);
 		ug_json_write_entry(json, link, UgetEventEntry);
+		// UgetEventEntry doesn't write these
+		if (link->repeats > 0) {
+			ug_json_write_string(json, "repeats");
+			ug_json_write_int(json, link->repeats);
+			ug_json_write_string(json, "first-time");
+			ug_json_write_time_t(json, &link->first_time);
+		}
 		ug_json_write_object_tail(json);
 	}
 }
@@ -663,6 +721,7 @@ static const UgGroupDataInfo  UgetRelationInfoStatic =
 	(UgFinalFunc)  uget_relation_final,
 	(UgAssignFunc) NULL,
 	UgetRelationEntry,
+	UGET_DATA_SLOT_RELATION,
 };
 // extern
 const UgGroupDataInfo*  UgetRelationInfo = &UgetRelationInfoStatic;
@@ -722,6 +781,15 @@ static void  uget_category_init(UgetCategory* category)
 	category->active_limit = 3;
 	category->finished_limit = 300;
 	category->recycled_limit = 300;
+
+	ug_array_init(&category->cold.records, sizeof(UgetColdRecord), 0);
+	memset(&category->cold.strings, 0, sizeof(UgBuffer));
+	memset(&category->cold.nodes, 0, sizeof(UgBuffer));
+	ug_array_init(&category->cold.groups, sizeof(void*), 0);
+	category->cold.n_finished = 0;
+	category->cold.n_recycled = 0;
+	category->cold.n_packed = 0;
+	category->cold.resident = FALSE;
 }
 
 static void  uget_category_final(UgetCategory* category)
@@ -732,6 +800,11 @@ static void  uget_category_final(UgetCategory* category)
 	ug_array_clear(&category->hosts);
 	ug_array_clear(&category->schemes);
 	ug_array_clear(&category->file_exts);
+
+	ug_array_clear(&category->cold.records);
+	ug_buffer_clear(&category->cold.strings, TRUE);
+	ug_buffer_clear(&category->cold.nodes, TRUE);
+	ug_array_clear(&category->cold.groups);
 }
 
 static int   uget_category_assign(UgetCategory* category, UgetCategory* src)
@@ -66,6 +66,14 @@ extern const UgGroupDataInfo*   UgetLogInfo;
 extern const UgGroupDataInfo*   UgetRelationInfo;
 extern const UgGroupDataInfo*   UgetCategoryInfo;
 
+// UgGroupDataInfo.slot of frequently used group. UgetNode::data has slots for
+// them, so ug_data_get() doesn't need search.
+#define UGET_DATA_SLOT_RELATION    1
+#define UGET_DATA_SLOT_PROGRESS    2
+#define UGET_DATA_SLOT_COMMON      3
+#define UGET_DATA_SLOT_LOG         4
+#define UGET_DATA_N_SLOTS          4
+
 /* ----------------------------------------------------------------------------
    UgetCommon: It derived from UgGroupData and store in UgData.
 
@@ -85,7 +93,7 @@ struct UgetCommon
 	char*   uri;
 	char*   mirrors;
 	char*   file;
-	char*   folder;
+	char*   folder;     // shared string, set it by ug_str_set_shared()
 	char*   user;
 	char*   password;
 
@@ -194,7 +202,7 @@ struct UgetProxy
 	UG_GROUP_DATA_MEMBERS;
 //	const UgGroupDataInfo*  info;    // UgGroupData(UgType) member
 
-	char*          host;
+	char*          host;    // shared string, set it by ug_str_set_shared()
 	unsigned int   port;
 	UgetProxyType  type;
 
@@ -246,13 +254,13 @@ struct UgetHttp
 
 	char*  user;
 	char*  password;
-	char*  referrer;
-	char*  user_agent;
+	char*  referrer;      // shared string, set it by ug_str_set_shared()
+	char*  user_agent;    // shared string
 
 	char*  post_data;
-	char*  post_file;
+	char*  post_file;     // shared string
 	char*  cookie_data;
-	char*  cookie_file;
+	char*  cookie_file;   // shared string
 
 	unsigned int  redirection_limit;    // limit of redirection_count
 	unsigned int  redirection_count;    // count of redirection
@@ -320,9 +328,22 @@ struct UgetLog
 	time_t  added_time;
 	time_t  completed_time;
 
-	UgList  messages;          // List for UgetEvent
+	UgList  messages;          // List for UgetEvent, newest first.
 };
 
+// UgetLog.messages keep at most 'capacity' UgetEvent, the oldest one will be
+// dropped. If identical message is in the newest UGET_LOG_RECENT messages,
+// new one will be coalesced into it and it become the newest.
+#define UGET_LOG_CAPACITY    16
+#define UGET_LOG_RECENT      4
+
+// uget_log_set_capacity() set capacity of all UgetLog, default is
+// UGET_LOG_CAPACITY. It apply to UgetLog when new message is added or loaded.
+void  uget_log_set_capacity (int capacity);
+// uget_log_add() take ownership of 'event', it may free 'event'.
+void  uget_log_add (UgetLog* log, UgetEvent* event);
+void  uget_log_clear (UgetLog* log);
+
 /* ----------------------------------------------------------------------------
    UgetRelation: It derived from UgGroupData and store in UgData.
 
@@ -358,6 +379,14 @@ struct UgetRelation
 		int          limit[2];   // current speed limit
 	} task;
 
+	// used by journal of UgetApp (UgetApp-journal.c)
+	struct UgetRelationJournal {
+		int          id;         // 0 if node is not written yet
+		int          prev;       // id of previous node when it was written
+		int          group;      // group when it was written
+		int          dirty;      // TRUE if data changed after written
+	} journal;
+
 	// call destroy.func(destroy.data) when destroying.
 	struct {
 		UgNotifyFunc func;
@@ -373,6 +402,38 @@ struct UgetRelation
 	} user;
 };
 
+/* ----------------------------------------------------------------------------
+   UgetColdRecord: compact and read-only record of finished or recycled
+                   download that is not loaded. It is used by UgetCategory.
+ */
+
+#define UGET_COLD_NULL    0xFFFFFFFF
+
+// get string of UgetColdRecord by offset
+#define uget_cold_string(cold, offset)    \
+		(((offset) == UGET_COLD_NULL) ? NULL : (cold)->strings.beg + (offset) + sizeof (uint32_t))
+
+typedef struct UgetColdRecord   UgetColdRecord;
+
+struct UgetColdRecord
+{
+	// offset of string in UgetCategory::cold.strings or UGET_COLD_NULL
+	uint32_t  name;
+	uint32_t  uri;
+	uint32_t  folder;
+	uint32_t  file;
+	uint32_t  cookie_file;      // UgetHttp::cookie_file (attachment)
+	uint32_t  post_file;        // UgetHttp::post_file (attachment)
+
+	int       group;            // UgetRelation::group
+	int       id;               // UgetRelation::journal.id
+	int64_t   total;            // UgetProgress::total
+	int64_t   added_time;       // UgetLog::added_time
+	int64_t   completed_time;   // UgetLog::completed_time
+
+	uint32_t  node;             // offset of node in UgetCategory::cold.nodes
+};
+
 /* ----------------------------------------------------------------------------
    UgetCategory: It derived from UgGroupData and store in UgData.
 
@@ -403,6 +464,20 @@ struct UgetCategory
 	UgetNode*  queuing;
 	UgetNode*  finished;
 	UgetNode*  recycled;
+
+	// finished and recycled downloads that are not loaded (UgetApp-cold.c)
+	struct UgetCategoryCold {
+		UG_ARRAY(UgetColdRecord)  records;
+
+		UgBuffer     strings;    // strings of records and nodes are stored once
+		UgBuffer     nodes;      // packed nodes (UgetApp-snapshot.c)
+		UgArrayPtr   groups;     // UgGroupDataInfo of packed nodes
+
+		int          n_finished;
+		int          n_recycled;
+		int          n_packed;   // number of records when nodes were packed
+		int          resident;   // paged in, keep downloads in memory
+	} cold;
 };
 
 
@@ -101,6 +101,9 @@ const UgEntry  UgetEventEntry[] =
 	{"string", offsetof (UgetEvent, string), UG_ENTRY_STRING, NULL, NULL},
 	{"type",   offsetof (UgetEvent, type),   UG_ENTRY_INT,    NULL, NULL},
 	{"time",   offsetof (UgetEvent, time),   UG_ENTRY_CUSTOM, ug_json_parse_time_t, ug_json_write_time_t},
+	// parse only, ug_json_write_list_message() writes them if repeats > 0
+	{"repeats",    offsetof (UgetEvent, repeats),    UG_ENTRY_CUSTOM, ug_json_parse_int32, NULL},
+	{"first-time", offsetof (UgetEvent, first_time), UG_ENTRY_CUSTOM, ug_json_parse_time_t, NULL},
 	{NULL}    // null-terminated
 };
 
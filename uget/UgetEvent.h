@@ -127,7 +127,7 @@ struct UgetEvent
  */
 
 	int     type;   // UgetEventType
-	time_t  time;   // date & time (seconds)
+	time_t  time;   // date & time (seconds), last time if it repeated.
 	char*   string; // User readable string or name parameter for UGET_EVENT_RENAME.
 
 	// extra data
@@ -136,6 +136,10 @@ struct UgetEvent
 		int        code;     // UGET_EVENT_ERROR, UGET_EVENT_WARNING, UGET_EVENT_NORMAL
 	} value;
 //	} value[3];
+
+	// uget_log_add() coalesce identical messages into one UgetEvent.
+	int     repeats;     // number of times it repeated after first_time
+	time_t  first_time;  // date & time of first one if it repeated.
 };
 
 UgetEvent* uget_event_new (UgetEventType type, ...);
@@ -118,8 +118,8 @@ int  uget_files_sync(UgetFiles* files, UgetFiles* src)
 	// sync element from 'src'
 	for (index_src = 0;  index_src < src->collection.length;  index_src++) {
 		element_src = src->collection.at + index_src;
-		element = ug_array_find_sorted(&files->collection, &element_src->path,
-		                               ug_array_compare_string, &index);
+		element = ug_array_find_sorted_str(&files->collection,
+		                                   element_src->path, &index);
 		// add new element in files
 		if (element == NULL) {
 			element = ug_array_insert(&files->collection, index, 1);
@@ -152,8 +152,7 @@ UgetFile* uget_files_realloc(UgetFiles* files, const char* path)
 	UgetFile* element;
 	int       index;
 
-	element = ug_array_find_sorted(&files->collection, &path,
-	                               ug_array_compare_string, &index);
+	element = ug_array_find_sorted_str(&files->collection, path, &index);
     if (element == NULL) {
 		element = ug_array_insert(&files->collection, index, 1);
 		element->path  = ug_strdup(path);
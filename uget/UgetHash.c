@@ -33,516 +33,406 @@
  *  files in the program, then also delete it here.
  *
  */
-
+#include <string.h>
+#include <stdint.h>
 #include <UgDefine.h>
 #include <UgString.h>
+#include <UgUri.h>
 #include <UgetData.h>
 #include <UgetHash.h>
 
 #ifdef NO_URI_HASH
 #else
 
-#if defined HAVE_GLIB
-
-#define ug_hash_table_destroy    g_hash_table_destroy
-#define ug_hash_table_lookup     g_hash_table_lookup
-#define ug_hash_table_insert     g_hash_table_insert
-#define ug_hash_table_remove     g_hash_table_remove
-
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define URI_HASH_SSE2           1
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>             // _BitScanForward
+#endif
+
+#if defined(__GNUC__)
+#define URI_HASH_PREFETCH(addr)     __builtin_prefetch (addr)
+#elif defined(URI_HASH_SSE2)
+#define URI_HASH_PREFETCH(addr)     _mm_prefetch ((const char*) (addr), _MM_HINT_T0)
 #else
-
-// modify GHashTable from GLib
-#include <string.h>
-#include <stdint.h>
-#include <memory.h>
-
-typedef struct UgHashTable    UgHashTable;
-typedef unsigned int (*UgHashFunc) (const void* v);
-
-UgHashTable*  ug_hash_table_new (UgHashFunc hash, UgCompareFunc compare);
-
-void   ug_hash_table_destroy (UgHashTable* hash_table);
-void*  ug_hash_table_lookup (UgHashTable* hash_table, const void* key);
-void   ug_hash_table_insert (UgHashTable* hash_table, void* key, void* value);
-int    ug_hash_table_remove (UgHashTable* hash_table, const void* key);
-
-unsigned int  ug_hash_str (const void* v);
-
-// port GHashTable to Android...
-struct UgHashTable
-{
-	int             size;
-	int             mod;
-	unsigned int    mask;
-	int             nnodes;
-	int             noccupied;  // nnodes + tombstones
-
-	void**          keys;
-	void**          values;
-	unsigned int*   hashes;
-
-	int             ref_count;
-
-	UgHashFunc      hash_func;
-	UgCompareFunc   compare_func;
-
-	UgNotifyFunc    key_destroy_func;
-	UgNotifyFunc    value_destroy_func;
-};
+#define URI_HASH_PREFETCH(addr)
+#endif
 
 // ----------------------------------------------------------------------------
-
-#undef	MAX
-#define MAX(a, b)  (((a) > (b)) ? (a) : (b))
-
-#define HASH_TABLE_MIN_SHIFT 3  // 1 << 3 == 8 buckets
-
-#define UNUSED_HASH_VALUE 0
-#define TOMBSTONE_HASH_VALUE 1
-#define HASH_IS_UNUSED(h_) ((h_) == UNUSED_HASH_VALUE)
-#define HASH_IS_TOMBSTONE(h_) ((h_) == TOMBSTONE_HASH_VALUE)
-#define HASH_IS_REAL(h_) ((h_) >= 2)
-
-static const int prime_mod [] =
+// UriHash: open addressing hash table (Swiss table style)
+//
+// Slots are divided into groups of 16. Each slot has a control byte that
+// holds 7 bits of hash (or EMPTY/DELETED), so one SIMD compare finds all
+// candidates in a group. Groups are probed by triangular numbers.
+// URI is interned in UriEntry with its full hash, length, and counts.
+// Key of URI is canonical form from ug_uri_canonicalize(), so URIs that
+// differ only in case of host, default port, or tracking query fields match.
+
+#define GROUP_WIDTH             16
+#define CTRL_EMPTY              ((int8_t) -128)
+#define CTRL_DELETED            ((int8_t) -2)
+
+typedef struct UriEntry         UriEntry;
+typedef struct UriHash          UriHash;
+
+struct UriEntry
 {
-  1,          /* For 1 << 0 */
-  2,
-  3,
-  7,
-  13,
-  31,
-  61,
-  127,
-  251,
-  509,
-  1021,
-  2039,
-  4093,
-  8191,
-  16381,
-  32749,
-  65521,      /* For 1 << 16 */
-  131071,
-  262139,
-  524287,
-  1048573,
-  2097143,
-  4194301,
-  8388593,
-  16777213,
-  33554393,
-  67108859,
-  134217689,
-  268435399,
-  536870909,
-  1073741789,
-  2147483647  /* For 1 << 31 */
+	uint64_t    hash;
+	uintptr_t   counts;
+	size_t      length;
+	char        uri[1];
 };
 
-static void
-ug_hash_table_set_shift (UgHashTable *hash_table, int shift)
+struct UriHash
 {
-	int i;
-	unsigned int mask = 0;
-
-	hash_table->size = 1 << shift;
-	hash_table->mod  = prime_mod [shift];
+	int8_t*     ctrl;
+	UriEntry**  slots;
+	size_t      group_mask;     // number of groups - 1
+	size_t      n_entries;
+	size_t      growth_left;    // EMPTY slots that can be used before resize
+	char**      query_fields;   // query fields that removed from key
+};
 
-	for (i = 0; i < shift; i++) {
-		mask <<= 1;
-		mask |= 1;
-	}
+// URI key that shorter than this is built on stack
+#define URI_KEY_SIZE            1024
 
-	hash_table->mask = mask;
-}
+// tracking query fields that don't change downloaded content
+static char*  default_query_fields[] =
+{
+	"utm_*",
+	"fbclid",
+	"gclid",
+	"dclid",
+	"msclkid",
+	"mc_cid",
+	"mc_eid",
+	"yclid",
+	NULL
+};
 
-static int
-ug_hash_table_find_closest_shift (int n)
+static inline int  lowest_bit (unsigned int mask)
 {
-	int i;
+#if defined(_MSC_VER)
+	unsigned long  index;
 
-	for (i = 0; n; i++)
-		n >>= 1;
+	_BitScanForward (&index, mask);
+	return (int) index;
+#elif defined(__GNUC__)
+	return __builtin_ctz (mask);
+#else
+	int  index;
 
-	return i;
+	for (index = 0;  (mask & 1) == 0;  index++)
+		mask >>= 1;
+	return index;
+#endif
 }
 
-static void
-ug_hash_table_set_shift_from_size (UgHashTable *hash_table, int size)
+// return bit mask of slots that control byte equal 'h2'
+static inline unsigned int  group_match (const int8_t* ctrl, int8_t h2)
 {
-	int shift;
+#ifdef URI_HASH_SSE2
+	__m128i  group = _mm_loadu_si128 ((const __m128i*) ctrl);
 
-	shift = ug_hash_table_find_closest_shift (size);
-	shift = MAX (shift, HASH_TABLE_MIN_SHIFT);
+	return (unsigned int) _mm_movemask_epi8 (
+			_mm_cmpeq_epi8 (group, _mm_set1_epi8 (h2)));
+#else
+	unsigned int  mask = 0;
+	int           index;
 
-	ug_hash_table_set_shift (hash_table, shift);
+	for (index = 0;  index < GROUP_WIDTH;  index++) {
+		if (ctrl[index] == h2)
+			mask |= 1u << index;
+	}
+	return mask;
+#endif
 }
 
-static unsigned int
-ug_hash_table_lookup_node (UgHashTable*   hash_table,
-                           const void*    key,
-                           unsigned int*  hash_return)
+// return bit mask of EMPTY or DELETED slots (high bit is set)
+static inline unsigned int  group_match_free (const int8_t* ctrl)
 {
-	unsigned int node_index;
-	unsigned int node_hash;
-	unsigned int hash_value;
-	unsigned int first_tombstone = 0;
-	int          have_tombstone = FALSE;
-	unsigned int step = 0;
-
-	hash_value = hash_table->hash_func (key);
-	if (!HASH_IS_REAL (hash_value))
-		hash_value = 2;
-
-	*hash_return = hash_value;
-
-	node_index = hash_value % hash_table->mod;
-	node_hash = hash_table->hashes[node_index];
-
-	while (!HASH_IS_UNUSED (node_hash)) {
-      /* We first check if our full hash values
-       * are equal so we can avoid calling the full-blown
-       * key equality function in most cases.
-       */
-		if (node_hash == hash_value) {
-			void* node_key = hash_table->keys[node_index];
-
-			if (hash_table->compare_func) {
-				if (hash_table->compare_func (node_key, key) == 0)
-					return node_index;
-			}
-			else if (node_key == key) {
-				return node_index;
-			}
-		}
-		else if (HASH_IS_TOMBSTONE (node_hash) && !have_tombstone) {
-			first_tombstone = node_index;
-			have_tombstone = TRUE;
-		}
+#ifdef URI_HASH_SSE2
+	return (unsigned int) _mm_movemask_epi8 (
+			_mm_loadu_si128 ((const __m128i*) ctrl));
+#else
+	unsigned int  mask = 0;
+	int           index;
 
-		step++;
-		node_index += step;
-		node_index &= hash_table->mask;
-		node_hash = hash_table->hashes[node_index];
+	for (index = 0;  index < GROUP_WIDTH;  index++) {
+		if (ctrl[index] < 0)
+			mask |= 1u << index;
 	}
-
-	if (have_tombstone)
-		return first_tombstone;
-
-	return node_index;
+	return mask;
+#endif
 }
 
-static void
-ug_hash_table_remove_node (UgHashTable* hash_table,
-                           int          i,
-                           int          notify)
-{
-	void* key;
-	void* value;
-
-	key = hash_table->keys[i];
-	value = hash_table->values[i];
+#define group_match_empty(ctrl)    group_match (ctrl, CTRL_EMPTY)
 
-	/* Erect tombstone */
-	hash_table->hashes[i] = TOMBSTONE_HASH_VALUE;
-
-	/* Be GC friendly */
-	hash_table->keys[i] = NULL;
-	hash_table->values[i] = NULL;
-
-	hash_table->nnodes--;
-
-	if (notify && hash_table->key_destroy_func)
-		hash_table->key_destroy_func (key);
-
-	if (notify && hash_table->value_destroy_func)
-		hash_table->value_destroy_func (value);
-}
-
-static void
-ug_hash_table_remove_all_nodes (UgHashTable* hash_table,
-                                int          notify)
+// hash 8 bytes at a time by multiply and xorshift, then finalize it.
+static uint64_t  uri_hash_string (const char* uri, size_t length)
 {
-	int   i;
-	void* key;
-	void* value;
-
-	hash_table->nnodes = 0;
-	hash_table->noccupied = 0;
+	uint64_t  hash = 0x9E3779B97F4A7C15ULL ^ length;
+	uint64_t  value;
 
-	if (!notify ||
-	    (hash_table->key_destroy_func == NULL &&
-	     hash_table->value_destroy_func == NULL))
-	{
-		memset (hash_table->hashes, 0, hash_table->size * sizeof (unsigned int));
-		memset (hash_table->keys,   0, hash_table->size * sizeof (void*));
-		memset (hash_table->values, 0, hash_table->size * sizeof (void*));
-
-		return;
-    }
-
-	for (i = 0; i < hash_table->size; i++) {
-		if (HASH_IS_REAL (hash_table->hashes[i])) {
-			key = hash_table->keys[i];
-			value = hash_table->values[i];
-
-			hash_table->hashes[i] = UNUSED_HASH_VALUE;
-			hash_table->keys[i] = NULL;
-			hash_table->values[i] = NULL;
-
-			if (hash_table->key_destroy_func != NULL)
-				hash_table->key_destroy_func (key);
-
-			if (hash_table->value_destroy_func != NULL)
-				hash_table->value_destroy_func (value);
-		}
-		else if (HASH_IS_TOMBSTONE (hash_table->hashes[i])) {
-			hash_table->hashes[i] = UNUSED_HASH_VALUE;
-		}
+	for (;  length >= 8;  length -= 8, uri += 8) {
+		memcpy (&value, uri, 8);
+		hash = (hash ^ value) * 0x9FB21C651E98DF25ULL;
+		hash ^= hash >> 29;
+	}
+	if (length > 0) {
+		value = 0;
+		memcpy (&value, uri, length);
+		hash = (hash ^ value) * 0x9FB21C651E98DF25ULL;
+		hash ^= hash >> 29;
 	}
+	// fmix64 from MurmurHash3
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDULL;
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53ULL;
+	hash ^= hash >> 33;
+	return hash;
 }
 
-static void
-ug_hash_table_resize (UgHashTable *hash_table)
-{
-  void**        new_keys;
-  void**        new_values;
-  unsigned int* new_hashes;
-  int old_size;
-  int i;
-
-  old_size = hash_table->size;
-  ug_hash_table_set_shift_from_size (hash_table, hash_table->nnodes * 2);
-
-  new_keys = ug_malloc0 (sizeof (void*) * hash_table->size);
-  if (hash_table->keys == hash_table->values)
-    new_values = new_keys;
-  else
-    new_values = ug_malloc0 (sizeof (void*) * hash_table->size);
-  new_hashes = ug_malloc0 (sizeof (unsigned int) * hash_table->size);
-
-  for (i = 0; i < old_size; i++)
-    {
-      unsigned int node_hash = hash_table->hashes[i];
-      unsigned int hash_val;
-      unsigned int step = 0;
-
-      if (!HASH_IS_REAL (node_hash))
-        continue;
-
-      hash_val = node_hash % hash_table->mod;
-
-      while (!HASH_IS_UNUSED (new_hashes[hash_val]))
-        {
-          step++;
-          hash_val += step;
-          hash_val &= hash_table->mask;
-        }
-
-      new_hashes[hash_val] = hash_table->hashes[i];
-      new_keys[hash_val] = hash_table->keys[i];
-      new_values[hash_val] = hash_table->values[i];
-    }
-
-  if (hash_table->keys != hash_table->values)
-    ug_free (hash_table->values);
-
-  ug_free (hash_table->keys);
-  ug_free (hash_table->hashes);
-
-  hash_table->keys = new_keys;
-  hash_table->values = new_values;
-  hash_table->hashes = new_hashes;
-
-  hash_table->noccupied = hash_table->nnodes;
-}
+#define HASH_H1(hash)           ((size_t) ((hash) >> 7))
+#define HASH_H2(hash)           ((int8_t) ((hash) & 0x7F))
 
-static inline void
-ug_hash_table_maybe_resize (UgHashTable *hash_table)
+static void  uri_hash_alloc (UriHash* uhash, size_t n_groups)
 {
-  int noccupied = hash_table->noccupied;
-  int size = hash_table->size;
-
-  if ((size > hash_table->nnodes * 4 && size > 1 << HASH_TABLE_MIN_SHIFT) ||
-      (size <= noccupied + (noccupied / 16)))
-    ug_hash_table_resize (hash_table);
+	size_t  n_slots = n_groups * GROUP_WIDTH;
+
+	uhash->ctrl  = ug_malloc (n_slots);
+	uhash->slots = ug_malloc (sizeof (UriEntry*) * n_slots);
+	memset (uhash->ctrl, CTRL_EMPTY, n_slots);
+	uhash->group_mask = n_groups - 1;
+	// max load factor is 7/8
+	uhash->growth_left = n_slots - n_slots / 8 - uhash->n_entries;
 }
 
-UgHashTable*  ug_hash_table_new (UgHashFunc hash_func, UgCompareFunc compare_func)
+// find EMPTY or DELETED slot for 'hash'
+static size_t  uri_hash_find_free (UriHash* uhash, uint64_t hash)
 {
-  UgHashTable*  hash_table;
-
-  hash_table = ug_malloc (sizeof (UgHashTable));
-  ug_hash_table_set_shift (hash_table, HASH_TABLE_MIN_SHIFT);
-  hash_table->nnodes             = 0;
-  hash_table->noccupied          = 0;
-  hash_table->hash_func          = hash_func ? hash_func : NULL;
-  hash_table->compare_func       = compare_func;
-  hash_table->ref_count          = 1;
-  hash_table->key_destroy_func   = NULL;
-  hash_table->value_destroy_func = NULL;
-  hash_table->keys               = ug_malloc0 (sizeof (void*) * hash_table->size);
-  hash_table->values             = hash_table->keys;
-  hash_table->hashes             = ug_malloc0 (sizeof (unsigned int) * hash_table->size);
-
-  return hash_table;
+	size_t        group;
+	size_t        step;
+	unsigned int  mask;
+
+	group = HASH_H1 (hash) & uhash->group_mask;
+	for (step = 1;  ;  step++) {
+		mask = group_match_free (uhash->ctrl + group * GROUP_WIDTH);
+		if (mask)
+			return group * GROUP_WIDTH + lowest_bit (mask);
+		group = (group + step) & uhash->group_mask;
+	}
 }
 
-static void
-ug_hash_table_insert_node (UgHashTable* hash_table,
-                           unsigned int node_index,
-                           unsigned int key_hash,
-                           void*        key,
-                           void*        value,
-                           int          keep_new_key,
-                           int          reusing_key)
+static void  uri_hash_resize (UriHash* uhash, size_t n_groups)
 {
-  unsigned int old_hash;
-  void*        old_key;
-  void*        old_value;
-
-  if (hash_table->keys == hash_table->values && key != value) {
-    hash_table->values = ug_malloc0 (sizeof (void*) * hash_table->size);
-    memcpy (hash_table->values, hash_table->keys, sizeof (void*) * hash_table->size);
-  }
-
-  old_hash = hash_table->hashes[node_index];
-  old_key = hash_table->keys[node_index];
-  old_value = hash_table->values[node_index];
-
-  if (HASH_IS_REAL (old_hash))
-    {
-      if (keep_new_key)
-        hash_table->keys[node_index] = key;
-      hash_table->values[node_index] = value;
-    }
-  else
-    {
-      hash_table->keys[node_index] = key;
-      hash_table->values[node_index] = value;
-      hash_table->hashes[node_index] = key_hash;
-
-      hash_table->nnodes++;
-
-      if (HASH_IS_UNUSED (old_hash))
-        {
-          /* We replaced an empty node, and not a tombstone */
-          hash_table->noccupied++;
-          ug_hash_table_maybe_resize (hash_table);
-        }
-
-    }
-
-  if (HASH_IS_REAL (old_hash))
-    {
-      if (hash_table->key_destroy_func && !reusing_key)
-        hash_table->key_destroy_func (keep_new_key ? old_key : key);
-      if (hash_table->value_destroy_func)
-        hash_table->value_destroy_func (old_value);
-    }
+	int8_t*     old_ctrl  = uhash->ctrl;
+	UriEntry**  old_slots = uhash->slots;
+	size_t      old_size  = (uhash->group_mask + 1) * GROUP_WIDTH;
+	size_t      index;
+	size_t      slot;
+
+	uri_hash_alloc (uhash, n_groups);
+	// UriEntry keeps full hash, don't hash URI again.
+	for (index = 0;  index < old_size;  index++) {
+		if (old_ctrl[index] < 0)
+			continue;
+		slot = uri_hash_find_free (uhash, old_slots[index]->hash);
+		uhash->ctrl[slot]  = old_ctrl[index];
+		uhash->slots[slot] = old_slots[index];
+	}
+	ug_free (old_ctrl);
+	ug_free (old_slots);
 }
 
-void
-ug_hash_table_destroy (UgHashTable *hash_table)
+// return slot index of 'uri' or -1 if not found
+static intptr_t  uri_hash_lookup (UriHash* uhash, const char* uri,
+                                  size_t length, uint64_t hash)
 {
-//  ug_hash_table_remove_all (hash_table);
-  ug_hash_table_remove_all_nodes (hash_table, TRUE);
-  ug_hash_table_maybe_resize (hash_table);
-
-//  ug_hash_table_unref (hash_table);
-  ug_hash_table_remove_all_nodes (hash_table, TRUE);
-  if (hash_table->keys != hash_table->values)
-     ug_free (hash_table->values);
-  ug_free (hash_table->keys);
-  ug_free (hash_table->hashes);
-  ug_free (hash_table);
+	const int8_t*  ctrl;
+	UriEntry*      entry;
+	size_t         group;
+	size_t         step;
+	size_t         slot;
+	unsigned int   mask;
+
+	group = HASH_H1 (hash) & uhash->group_mask;
+	// load slots of first group while matching control bytes
+	URI_HASH_PREFETCH (uhash->slots + group * GROUP_WIDTH);
+	URI_HASH_PREFETCH (uhash->slots + group * GROUP_WIDTH + GROUP_WIDTH / 2);
+	for (step = 1;  ;  step++) {
+		ctrl = uhash->ctrl + group * GROUP_WIDTH;
+		for (mask = group_match (ctrl, HASH_H2 (hash));  mask;  mask &= mask - 1) {
+			slot = group * GROUP_WIDTH + lowest_bit (mask);
+			entry = uhash->slots[slot];
+			if (entry->hash == hash && entry->length == length &&
+			    memcmp (entry->uri, uri, length) == 0)
+			{
+				return (intptr_t) slot;
+			}
+		}
+		// probe stop at group that has EMPTY slot
+		if (group_match_empty (ctrl))
+			return -1;
+		group = (group + step) & uhash->group_mask;
+	}
 }
 
-void*
-ug_hash_table_lookup (UgHashTable*   hash_table,
-                      const void*    key)
+// build canonical key of 'uri' in 'buffer'. If URI is too long,
+// return allocated key and caller must free it.
+static char*  uri_hash_key (UriHash* uhash, const char* uri,
+                            char* buffer, size_t* length)
 {
-  unsigned int node_index;
-  unsigned int node_hash;
-
-  node_index = ug_hash_table_lookup_node (hash_table, key, &node_hash);
+	UgUri  uuri;
+	char*  key;
 
-  return HASH_IS_REAL (hash_table->hashes[node_index])
-    ? hash_table->values[node_index]
-    : NULL;
+	if (strlen (uri) + 2 > URI_KEY_SIZE)
+		key = ug_malloc (strlen (uri) + 2);
+	else
+		key = buffer;
+	ug_uri_init (&uuri, uri);
+	*length = ug_uri_canonicalize (&uuri, uhash->query_fields, key);
+	return key;
 }
 
-void
-ug_hash_table_insert (UgHashTable *hash_table,
-                      void*        key,
-                      void*        value)
+static void  uri_hash_add_key (UriHash* uhash, const char* uri, size_t length)
 {
-//  g_hash_table_insert_internal (hash_table, key, value, FALSE);
-  unsigned int key_hash;
-  unsigned int node_index;
-
-  node_index = ug_hash_table_lookup_node (hash_table, key, &key_hash);
+	UriEntry*  entry;
+	uint64_t   hash;
+	size_t     n_slots;
+	intptr_t   slot;
+
+	hash = uri_hash_string (uri, length);
+	slot = uri_hash_lookup (uhash, uri, length, hash);
+	if (slot >= 0) {
+		uhash->slots[slot]->counts++;
+		return;
+	}
 
-//  g_hash_table_insert_node (hash_table, node_index, key_hash, key, value, keep_new_key, FALSE);
-  ug_hash_table_insert_node (hash_table, node_index, key_hash, key, value, FALSE, FALSE);
+	slot = uri_hash_find_free (uhash, hash);
+	if (uhash->ctrl[slot] == CTRL_EMPTY && uhash->growth_left == 0) {
+		n_slots = (uhash->group_mask + 1) * GROUP_WIDTH;
+		// drop DELETED slots if table is less than half full
+		if (uhash->n_entries * 2 <= n_slots - n_slots / 8)
+			uri_hash_resize (uhash, uhash->group_mask + 1);
+		else
+			uri_hash_resize (uhash, (uhash->group_mask + 1) * 2);
+		slot = uri_hash_find_free (uhash, hash);
+	}
+	if (uhash->ctrl[slot] == CTRL_EMPTY)
+		uhash->growth_left--;
+
+	entry = ug_malloc (sizeof (UriEntry) + length);
+	entry->hash = hash;
+	entry->counts = 1;
+	entry->length = length;
+	memcpy (entry->uri, uri, length + 1);
+	uhash->ctrl[slot] = HASH_H2 (hash);
+	uhash->slots[slot] = entry;
+	uhash->n_entries++;
 }
 
-int
-ug_hash_table_remove (UgHashTable*   hash_table,
-                      const void*    key)
+static void  uri_hash_remove_key (UriHash* uhash, const char* uri, size_t length)
 {
-//  return g_hash_table_remove_internal (hash_table, key, TRUE);
-  unsigned int node_index;
-  unsigned int node_hash;
-
-  node_index = ug_hash_table_lookup_node (hash_table, key, &node_hash);
+	const int8_t*  group;
+	intptr_t       slot;
 
-  if (!HASH_IS_REAL (hash_table->hashes[node_index]))
-    return FALSE;
-
-  ug_hash_table_remove_node (hash_table, node_index, TRUE);
-  ug_hash_table_maybe_resize (hash_table);
+	slot = uri_hash_lookup (uhash, uri, length, uri_hash_string (uri, length));
+	if (slot < 0)
+		return;
+	if (--uhash->slots[slot]->counts > 0)
+		return;
 
-  return TRUE;
+	ug_free (uhash->slots[slot]);
+	uhash->n_entries--;
+	// If group has EMPTY slot, no probe has passed through it.
+	group = uhash->ctrl + (slot & ~(intptr_t) (GROUP_WIDTH - 1));
+	if (group_match_empty (group)) {
+		uhash->ctrl[slot] = CTRL_EMPTY;
+		uhash->growth_left++;
+	}
+	else
+		uhash->ctrl[slot] = CTRL_DELETED;
 }
 
-
-unsigned int  ug_hash_str (const void* v)
+static void  uri_hash_add (UriHash* uhash, const char* uri)
 {
-	const signed char *p;
-	uint32_t  h = 5381;
-
-	for (p = v; *p != '\0'; p++)
-		h = (h << 5) + h + *p;
+	char    buffer[URI_KEY_SIZE];
+	char*   key;
+	size_t  length;
+
+	key = uri_hash_key (uhash, uri, buffer, &length);
+	uri_hash_add_key (uhash, key, length);
+	if (key != buffer)
+		ug_free (key);
+}
 
-	return h;
+static void  uri_hash_remove (UriHash* uhash, const char* uri)
+{
+	char    buffer[URI_KEY_SIZE];
+	char*   key;
+	size_t  length;
+
+	key = uri_hash_key (uhash, uri, buffer, &length);
+	uri_hash_remove_key (uhash, key, length);
+	if (key != buffer)
+		ug_free (key);
 }
-#endif // HAVE_GLIB
 
 // ----------------------------------------------------------------------------
 
 void* uget_uri_hash_new (void)
 {
-#if defined HAVE_GLIB
-	return g_hash_table_new_full (g_str_hash, g_str_equal, ug_free, NULL);
-#else
-	UgHashTable*  uuhash;
+	UriHash*  uhash;
 
-	uuhash = ug_hash_table_new (ug_hash_str, (UgCompareFunc) strcmp);
-	uuhash->key_destroy_func = ug_free;
-	return uuhash;
-#endif // HAVE_GLIB
+	uhash = ug_malloc (sizeof (UriHash));
+	uhash->n_entries = 0;
+	uhash->query_fields = default_query_fields;
+	uri_hash_alloc (uhash, 1);
+	return uhash;
 }
 
-void  uget_uri_hash_free (void* uuhash)
+void  uget_uri_hash_set_query_fields (void* uuhash, char** query_fields)
 {
 	if (uuhash)
-		ug_hash_table_destroy (uuhash);
+		((UriHash*) uuhash)->query_fields = query_fields;
+}
+
+void  uget_uri_hash_free (void* uuhash)
+{
+	UriHash*  uhash = uuhash;
+	size_t    index;
+	size_t    n_slots;
+
+	if (uhash == NULL)
+		return;
+	n_slots = (uhash->group_mask + 1) * GROUP_WIDTH;
+	for (index = 0;  index < n_slots;  index++) {
+		if (uhash->ctrl[index] >= 0)
+			ug_free (uhash->slots[index]);
+	}
+	ug_free (uhash->ctrl);
+	ug_free (uhash->slots);
+	ug_free (uhash);
 }
 
 int   uget_uri_hash_find (void* uuhash, const char* uri)
 {
-	if (uuhash && ug_hash_table_lookup (uuhash, uri))
+	char      buffer[URI_KEY_SIZE];
+	char*     key;
+	size_t    length;
+	intptr_t  slot;
+
+	if (uuhash == NULL)
+		return FALSE;
+	key = uri_hash_key (uuhash, uri, buffer, &length);
+	slot = uri_hash_lookup (uuhash, key, length, uri_hash_string (key, length));
+	if (key != buffer)
+		ug_free (key);
+	if (slot >= 0)
 		return TRUE;
 	else
 		return FALSE;
@@ -550,71 +440,58 @@ int   uget_uri_hash_find (void* uuhash, const char* uri)
 
 void  uget_uri_hash_add (void* uuhash, const char* uri)
 {
-	uintptr_t   counts;
-
-	if (uri) {
-		counts = (uintptr_t) ug_hash_table_lookup (uuhash, uri);
-		ug_hash_table_insert (uuhash, ug_strdup (uri), (void*) (++counts));
-	}
+	if (uri)
+		uri_hash_add (uuhash, uri);
 }
 
 void  uget_uri_hash_remove (void* uuhash, const char* uri)
 {
-	uintptr_t   counts;
-
-	if (uri) {
-		counts = (uintptr_t) ug_hash_table_lookup (uuhash, uri);
-		if (counts > 1)
-			ug_hash_table_insert (uuhash, ug_strdup (uri), (void*) (--counts));
-		else
-			ug_hash_table_remove (uuhash, uri);
-	}
+	if (uri)
+		uri_hash_remove (uuhash, uri);
 }
 
 void  uget_uri_hash_add_download (void* uuhash, UgData* dnode_data)
 {
 	UgetCommon* common;
-	uintptr_t   counts;
 
 	if (uuhash == NULL)
 		return;
 	common = ug_data_get(dnode_data, UgetCommonInfo);
-	if (common && common->uri) {
-		counts = (uintptr_t) ug_hash_table_lookup (uuhash, common->uri);
-		ug_hash_table_insert (uuhash, ug_strdup (common->uri), (void*) (++counts));
-	}
+	if (common && common->uri)
+		uri_hash_add (uuhash, common->uri);
 }
 
 void  uget_uri_hash_remove_download (void* uuhash, UgData* dnode_data)
 {
 	UgetCommon* common;
-	uintptr_t   counts;
 
 	if (uuhash == NULL)
 		return;
 	common = ug_data_get(dnode_data, UgetCommonInfo);
-	if (common && common->uri) {
-		counts = (uintptr_t) ug_hash_table_lookup (uuhash, common->uri);
-		if (counts > 1)
-			ug_hash_table_insert (uuhash, ug_strdup (common->uri), (void*) (--counts));
-		else
-			ug_hash_table_remove (uuhash, common->uri);
-	}
+	if (common && common->uri)
+		uri_hash_remove (uuhash, common->uri);
 }
 
 void  uget_uri_hash_add_category (void* uuhash, UgetNode* cnode)
 {
 	UgetNode*   dnode;
 	UgetCommon* common;
-	uintptr_t   counts;
+	UgetCategory* category;
+	int         index;
 
 	if (uuhash == NULL)
 		return;
 	for (dnode = cnode->children;  dnode;  dnode = dnode->next) {
 		common = ug_data_get (dnode->data, UgetCommonInfo);
-		if (common && common->uri) {
-			counts = (uintptr_t) ug_hash_table_lookup (uuhash, common->uri);
-			ug_hash_table_insert (uuhash, ug_strdup (common->uri), (void*) (++counts));
+		if (common && common->uri)
+			uri_hash_add (uuhash, common->uri);
+	}
+	// downloads that are not loaded (UgetApp-cold.c)
+	category = ug_data_get (cnode->data, UgetCategoryInfo);
+	if (category) {
+		for (index = 0;  index < category->cold.records.length;  index++) {
+			uget_uri_hash_add (uuhash, uget_cold_string (&category->cold,
+					category->cold.records.at[index].uri));
 		}
 	}
 }
@@ -623,18 +500,22 @@ void  uget_uri_hash_remove_category (void* uuhash, UgetNode* cnode)
 {
 	UgetNode*   dnode;
 	UgetCommon* common;
-	uintptr_t   counts;
+	UgetCategory* category;
+	int         index;
 
 	if (uuhash == NULL)
 		return;
 	for (dnode = cnode->children;  dnode;  dnode = dnode->next) {
 		common = ug_data_get (dnode->data, UgetCommonInfo);
-		if (common && common->uri) {
-			counts = (uintptr_t) ug_hash_table_lookup (uuhash, common->uri);
-			if (counts > 1)
-				ug_hash_table_insert (uuhash, ug_strdup (common->uri), (void*) (--counts));
-			else
-				ug_hash_table_remove (uuhash, common->uri);
+		if (common && common->uri)
+			uri_hash_remove (uuhash, common->uri);
+	}
+	// downloads that are not loaded (UgetApp-cold.c)
+	category = ug_data_get (cnode->data, UgetCategoryInfo);
+	if (category) {
+		for (index = 0;  index < category->cold.records.length;  index++) {
+			uget_uri_hash_remove (uuhash, uget_cold_string (&category->cold,
+					category->cold.records.at[index].uri));
 		}
 	}
 }
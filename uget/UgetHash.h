@@ -50,6 +50,7 @@ extern "C" {
 
 #define uget_uri_hash_new()
 #define uget_uri_hash_free(uuhash)
+#define uget_uri_hash_set_query_fields(uuhash, query_fields)
 
 #define uget_uri_hash_find(uuhash, uri)
 #define uget_uri_hash_add(uuhash, uri)      FALSE
@@ -66,6 +67,12 @@ extern "C" {
 void* uget_uri_hash_new (void);
 void  uget_uri_hash_free (void* uuhash);
 
+// URIs are compared by canonical form (see ug_uri_canonicalize()).
+// 'query_fields' are removed from URI before comparing. It must be
+// null-terminated and kept until hash is freed. Set it before adding URIs.
+// Default is tracking fields: {"utm_*", "fbclid", "gclid", ... , NULL}
+void  uget_uri_hash_set_query_fields (void* uuhash, char** query_fields);
+
 int   uget_uri_hash_find (void* uuhash, const char* uri);
 void  uget_uri_hash_add (void* uuhash, const char* uri);
 void  uget_uri_hash_remove (void* uuhash, const char* uri);
@@ -34,6 +34,8 @@
  *
  */
 
+#include <stddef.h>     // offsetof()
+#include <stdlib.h>     // qsort()
 #include <string.h>
 #include <UgDefine.h>
 #include <UgetNode.h>
@@ -51,7 +53,7 @@ int   uget_node_compare_name (UgetNode* node1, UgetNode* node2)
 	common2 = ug_data_get(node2->data, UgetCommonInfo);
 
 	if (common1 && common1->name) {
-		if (common2->name == NULL)
+		if (common2 == NULL || common2->name == NULL)
 			return 1;
 	}
 	else {
@@ -88,7 +90,7 @@ int   uget_node_compare_complete (UgetNode* node1, UgetNode* node2)
 		return uget_node_compare_name (node1, node2);
 	// return diff of complete
 	else
-		return (int)(progress1->complete - progress2->complete);
+		return (progress1->complete > progress2->complete) ? 1 : -1;
 }
 
 int   uget_node_compare_size (UgetNode* node1, UgetNode* node2)
@@ -116,7 +118,7 @@ int   uget_node_compare_size (UgetNode* node1, UgetNode* node2)
 		return uget_node_compare_name (node1, node2);
 	// return diff of total
 	else
-		return (int)(progress1->total - progress2->total);
+		return (progress1->total > progress2->total) ? 1 : -1;
 }
 
 int   uget_node_compare_percent (UgetNode* node1, UgetNode* node2)
@@ -172,7 +174,7 @@ int   uget_node_compare_elapsed (UgetNode* node1, UgetNode* node2)
 		return uget_node_compare_name (node1, node2);
 	// return diff of elapsed (consume time)
 	else
-		return (int)(progress1->elapsed - progress2->elapsed);
+		return (progress1->elapsed > progress2->elapsed) ? 1 : -1;
 }
 
 int   uget_node_compare_left (UgetNode* node1, UgetNode* node2)
@@ -200,7 +202,7 @@ int   uget_node_compare_left (UgetNode* node1, UgetNode* node2)
 		return uget_node_compare_name (node1, node2);
 	// return diff of left (remain time)
 	else
-		return (int)(progress1->left - progress2->left);
+		return (progress1->left > progress2->left) ? 1 : -1;
 }
 
 int   uget_node_compare_speed (UgetNode* node1, UgetNode* node2)
@@ -284,7 +286,7 @@ int   uget_node_compare_uploaded (UgetNode* node1, UgetNode* node2)
 		return uget_node_compare_name (node1, node2);
 	// return diff of uploaded
 	else
-		return (int)(progress1->uploaded - progress2->uploaded);
+		return (progress1->uploaded > progress2->uploaded) ? 1 : -1;
 }
 
 int   uget_node_compare_ratio (UgetNode* node1, UgetNode* node2)
@@ -312,7 +314,7 @@ int   uget_node_compare_ratio (UgetNode* node1, UgetNode* node2)
 		return uget_node_compare_name (node1, node2);
 	// return diff of ratio
 	else
-		return (int)(progress1->ratio - progress2->ratio);
+		return (progress1->ratio > progress2->ratio) ? 1 : -1;
 }
 
 int   uget_node_compare_retry (UgetNode* node1, UgetNode* node2)
@@ -367,6 +369,11 @@ int   uget_node_compare_uri (UgetNode* node1, UgetNode* node2)
 		else
 			return -1;
 	}
+	if (common1->uri == NULL || common2->uri == NULL) {
+		if (common1->uri)
+			return 1;
+		return (common2->uri) ? -1 : 0;
+	}
 	return strcmp (common1->uri, common2->uri);
 }
 
@@ -395,7 +402,7 @@ int   uget_node_compare_added_time (UgetNode* node1, UgetNode* node2)
 		return uget_node_compare_name (node1, node2);
 	// return diff of added_time
 	else
-		return (int)(log1->added_time - log2->added_time);
+		return (log1->added_time > log2->added_time) ? 1 : -1;
 }
 
 int   uget_node_compare_completed_time (UgetNode* node1, UgetNode* node2)
@@ -423,6 +430,252 @@ int   uget_node_compare_completed_time (UgetNode* node1, UgetNode* node2)
 		return uget_node_compare_name (node1, node2);
 	// return diff of completed_time
 	else
-		return (int)(log1->completed_time - log2->completed_time);
+		return (log1->completed_time > log2->completed_time) ? 1 : -1;
+}
+
+// ----------------------------------------------------------------------------
+// sort by precomputed keys
+// uget_node_sort_by_key() gather keys of nodes into contiguous array and sort
+// them without calling ug_data_get() in every comparison.
+
+enum UgetNodeKeyType
+{
+	UGET_NODE_KEY_NAME,
+	UGET_NODE_KEY_PARENT_NAME,
+	UGET_NODE_KEY_STRING,
+	UGET_NODE_KEY_INT,
+	UGET_NODE_KEY_INT64,
+	UGET_NODE_KEY_TIME,
+	UGET_NODE_KEY_DOUBLE,
+};
+
+typedef struct UgetNodeKey
+{
+	union {
+		int64_t      integer;
+		double       real;
+		const char*  string;
+	} value;
+	const char*  name;
+	int          rank;       // 0 if group data doesn't exist.
+	int          position;   // keep original order if keys are the same.
+	UgetNode*    node;
+} UgetNodeKey;
+
+static const struct UgetNodeKeyInfo
+{
+	UgCompareFunc             compare;
+	const UgGroupDataInfo**   info;
+	int                       offset;
+	int                       type;
+} key_infos[] =
+{
+	{(UgCompareFunc) uget_node_compare_name,         NULL,
+	 0,                                          UGET_NODE_KEY_NAME},
+	{(UgCompareFunc) uget_node_compare_parent_name,  NULL,
+	 0,                                          UGET_NODE_KEY_PARENT_NAME},
+	{(UgCompareFunc) uget_node_compare_complete,     &UgetProgressInfo,
+	 offsetof (UgetProgress, complete),          UGET_NODE_KEY_INT64},
+	{(UgCompareFunc) uget_node_compare_size,         &UgetProgressInfo,
+	 offsetof (UgetProgress, total),             UGET_NODE_KEY_INT64},
+	{(UgCompareFunc) uget_node_compare_percent,      &UgetProgressInfo,
+	 offsetof (UgetProgress, percent),           UGET_NODE_KEY_INT},
+	{(UgCompareFunc) uget_node_compare_elapsed,      &UgetProgressInfo,
+	 offsetof (UgetProgress, elapsed),           UGET_NODE_KEY_INT64},
+	{(UgCompareFunc) uget_node_compare_left,         &UgetProgressInfo,
+	 offsetof (UgetProgress, left),              UGET_NODE_KEY_INT64},
+	{(UgCompareFunc) uget_node_compare_speed,        &UgetProgressInfo,
+	 offsetof (UgetProgress, download_speed),    UGET_NODE_KEY_INT},
+	{(UgCompareFunc) uget_node_compare_upload_speed, &UgetProgressInfo,
+	 offsetof (UgetProgress, upload_speed),      UGET_NODE_KEY_INT},
+	{(UgCompareFunc) uget_node_compare_uploaded,     &UgetProgressInfo,
+	 offsetof (UgetProgress, uploaded),          UGET_NODE_KEY_INT64},
+	{(UgCompareFunc) uget_node_compare_ratio,        &UgetProgressInfo,
+	 offsetof (UgetProgress, ratio),             UGET_NODE_KEY_DOUBLE},
+	{(UgCompareFunc) uget_node_compare_retry,        &UgetCommonInfo,
+	 offsetof (UgetCommon, retry_count),         UGET_NODE_KEY_INT},
+	{(UgCompareFunc) uget_node_compare_uri,          &UgetCommonInfo,
+	 offsetof (UgetCommon, uri),                 UGET_NODE_KEY_STRING},
+	{(UgCompareFunc) uget_node_compare_added_time,   &UgetLogInfo,
+	 offsetof (UgetLog, added_time),             UGET_NODE_KEY_TIME},
+	{(UgCompareFunc) uget_node_compare_completed_time, &UgetLogInfo,
+	 offsetof (UgetLog, completed_time),         UGET_NODE_KEY_TIME},
+	{NULL}
+};
+
+static const char* uget_node_get_name (UgetNode* node)
+{
+	UgetCommon*  common;
+
+	common = ug_data_get (node->data, UgetCommonInfo);
+	if (common)
+		return common->name;
+	return NULL;
+}
+
+// the same as uget_node_compare_name()
+static int  compare_name (const char* name1, const char* name2)
+{
+	if (name1) {
+		if (name2 == NULL)
+			return 1;
+	}
+	else
+		return (name2) ? -1 : 0;
+	return strcmp (name1, name2);
+}
+
+#define COMPARE_POSITION(key1, key2)    \
+		( ((key1)->position > (key2)->position) ? 1 : -1 )
+
+static int  compare_key_name (const UgetNodeKey* key1, const UgetNodeKey* key2)
+{
+	int  diff;
+
+	diff = compare_name (key1->name, key2->name);
+	if (diff)
+		return diff;
+	return COMPARE_POSITION (key1, key2);
+}
+
+static int  compare_key_string (const UgetNodeKey* key1, const UgetNodeKey* key2)
+{
+	int  diff;
+
+	if (key1->rank != key2->rank)
+		return key1->rank - key2->rank;
+	if (key1->rank == 0)
+		diff = compare_name (key1->name, key2->name);
+	else
+		diff = compare_name (key1->value.string, key2->value.string);
+	if (diff)
+		return diff;
+	return COMPARE_POSITION (key1, key2);
+}
+
+static int  compare_key_integer (const UgetNodeKey* key1, const UgetNodeKey* key2)
+{
+	int  diff;
+
+	if (key1->rank != key2->rank)
+		return key1->rank - key2->rank;
+	if (key1->value.integer != key2->value.integer)
+		return (key1->value.integer > key2->value.integer) ? 1 : -1;
+	diff = compare_name (key1->name, key2->name);
+	if (diff)
+		return diff;
+	return COMPARE_POSITION (key1, key2);
+}
+
+static int  compare_key_double (const UgetNodeKey* key1, const UgetNodeKey* key2)
+{
+	int  diff;
+
+	if (key1->rank != key2->rank)
+		return key1->rank - key2->rank;
+	if (key1->value.real != key2->value.real)
+		return (key1->value.real > key2->value.real) ? 1 : -1;
+	diff = compare_name (key1->name, key2->name);
+	if (diff)
+		return diff;
+	return COMPARE_POSITION (key1, key2);
 }
 
+int   uget_node_sort_by_key (UgetNode** nodes, int length,
+                             UgCompareFunc compare, int reversed)
+{
+	const struct UgetNodeKeyInfo* kinfo;
+	UgCompareFunc  compare_key;
+	UgetNodeKey*   keys;
+	UgetNodeKey*   key;
+	UgetNode*      base;
+	char*          group;
+	int            index;
+
+	for (kinfo = key_infos;  kinfo->compare;  kinfo++) {
+		if (kinfo->compare == compare)
+			break;
+	}
+	if (kinfo->compare == NULL)
+		return FALSE;
+
+	switch (kinfo->type) {
+	case UGET_NODE_KEY_NAME:
+	case UGET_NODE_KEY_PARENT_NAME:
+		compare_key = (UgCompareFunc) compare_key_name;
+		break;
+
+	case UGET_NODE_KEY_STRING:
+		compare_key = (UgCompareFunc) compare_key_string;
+		break;
+
+	case UGET_NODE_KEY_DOUBLE:
+		compare_key = (UgCompareFunc) compare_key_double;
+		break;
+
+	default:
+		compare_key = (UgCompareFunc) compare_key_integer;
+		break;
+	}
+
+	// gather keys
+	keys = ug_malloc (sizeof (UgetNodeKey) * length);
+	for (index = 0;  index < length;  index++) {
+		key = keys + index;
+		key->node = nodes[index];
+		// If array is reversed after sorting, nodes that have the same key
+		// must be placed in reverse order before it.
+		key->position = (reversed) ? -index : index;
+		key->value.integer = 0;
+		key->rank = 0;
+
+		base = key->node->base;
+		if (kinfo->type == UGET_NODE_KEY_PARENT_NAME) {
+			key->name = uget_node_get_name (base->parent);
+			continue;
+		}
+		key->name = uget_node_get_name (base);
+		if (kinfo->info == NULL)
+			continue;
+		group = ug_data_get (base->data, *kinfo->info);
+		if (group == NULL)
+			continue;
+		key->rank = 1;
+		switch (kinfo->type) {
+		case UGET_NODE_KEY_STRING:
+			key->value.string = *(char**) (group + kinfo->offset);
+			break;
+
+		case UGET_NODE_KEY_INT:
+			key->value.integer = *(int*) (group + kinfo->offset);
+			break;
+
+		case UGET_NODE_KEY_INT64:
+			key->value.integer = *(int64_t*) (group + kinfo->offset);
+			break;
+
+		case UGET_NODE_KEY_TIME:
+			key->value.integer = *(time_t*) (group + kinfo->offset);
+			break;
+
+		case UGET_NODE_KEY_DOUBLE:
+			key->value.real = *(double*) (group + kinfo->offset);
+			break;
+		}
+	}
+
+	qsort (keys, length, sizeof (UgetNodeKey), compare_key);
+
+	// write sorted nodes back
+	if (reversed == FALSE) {
+		for (index = 0;  index < length;  index++)
+			nodes[index] = keys[index].node;
+	}
+	else {
+		for (index = 0;  index < length;  index++)
+			nodes[length - index - 1] = keys[index].node;
+	}
+
+	ug_free (keys);
+	return TRUE;
+}
@@ -39,14 +39,13 @@
 #endif
 
 #include <UgString.h>
+#include <UgArray.h>
+#include <UgSlice.h>
 #include <UgetNode.h>
 #include <UgetData.h>
 
-#ifdef HAVE_GLIB
-#include <glib.h>    // g_slice_xxx
-#endif
-
 static void  uget_node_call_fake_filter (UgetNode* parent, UgetNode* sibling, UgetNode* child);
+static void  uget_node_init_in (UgetNode* node, UgetNode* node_real, UgSlice* slice);
 static UgJsonError  ug_json_parse_state2group (UgJson* json,
                                 const char* name, const char* value,
                                 void* node, void* none);
@@ -85,16 +84,28 @@ UgetNode*  uget_node_new (UgetNode* node_real)
 {
 	UgetNode*  node;
 
-#ifdef HAVE_GLIB
-	node = g_slice_alloc (sizeof (UgetNode));
-#else
-	node = ug_malloc (sizeof (UgetNode));
-#endif // HAVE_GLIB
+	if (node_real == NULL)
+		return uget_node_new_in (NULL);
+	node = ug_slice_alloc (node_real->data->slice, sizeof (UgetNode));
 	uget_node_init (node, node_real);
 	return node;
 }
 
+UgetNode*  uget_node_new_in (UgSlice* slice)
+{
+	UgetNode*  node;
+
+	node = ug_slice_alloc (slice, sizeof (UgetNode));
+	uget_node_init_in (node, NULL, slice);
+	return node;
+}
+
 void  uget_node_init  (UgetNode* node, UgetNode* node_real)
+{
+	uget_node_init_in (node, node_real, NULL);
+}
+
+static void  uget_node_init_in (UgetNode* node, UgetNode* node_real, UgSlice* slice)
 {
 	memset (node, 0, sizeof (UgetNode));
 
@@ -102,9 +113,7 @@ void  uget_node_init  (UgetNode* node, UgetNode* node_real)
 
 	if (node_real == NULL) {
 		node->base = node;    // pointer to self
-		node->data = ug_data_new(8, 2);
-		node->data->at[0].key = (void*) UgetRelationInfo;
-		node->data->at[1].key = (void*) UgetProgressInfo;
+		node->data = ug_data_new_in(slice, 6, UGET_DATA_N_SLOTS);
 	}
 	else {
 		// this is a fake node.
@@ -130,11 +139,7 @@ void  uget_node_free (UgetNode* node)
 //	ug_node_unlink ((UgNode*)node);
 	ug_data_unref(node->data);
 
-#ifdef HAVE_GLIB
-	g_slice_free1 (sizeof (UgetNode), node);
-#else
-	ug_free (node);
-#endif // HAVE_GLIB
+	ug_slice_free1 (sizeof (UgetNode), node);
 }
 
 void  uget_node_clear_children (UgetNode* node)
@@ -277,60 +282,228 @@ void  uget_node_prepend (UgetNode* node, UgetNode* child)
 	uget_node_call_fake_filter (node, sibling, child);
 }
 
-void  uget_node_sort (UgetNode* node, UgCompareFunc compare, int reversed)
+// stable merge sort for uget_node_sort()
+static void  uget_node_merge_sort (UgetNode** nodes, UgetNode** temp, int length,
+                                   UgCompareFunc compare, int reversed)
 {
-	UgetNode* beg;
-	UgetNode* cur;
-	UgetNode* unsorted;
+	UgetNode** left;
+	UgetNode** right;
+	int        n_left, n_right;
+	int        index, diff;
 
-	for (beg = node->children;  beg;  beg = unsorted->next) {
-		unsorted = beg;
-		if (reversed == FALSE) {
-			for (cur = beg->next;  cur;  cur = cur->next) {
-				if (compare (cur, unsorted) < 0)
-					unsorted = cur;
-			}
+	if (length < 2)
+		return;
+	n_left  = length >> 1;
+	n_right = length - n_left;
+	uget_node_merge_sort (nodes, temp, n_left, compare, reversed);
+	uget_node_merge_sort (nodes + n_left, temp, n_right, compare, reversed);
+
+	memcpy (temp, nodes, n_left * sizeof (UgetNode*));
+	left  = temp;
+	right = nodes + n_left;
+	for (index = 0;  n_left && n_right;  index++) {
+		if (reversed == FALSE)
+			diff = compare (left[0], right[0]);
+		else
+			diff = compare (right[0], left[0]);
+		if (diff <= 0) {
+			nodes[index] = *left++;
+			n_left--;
 		}
 		else {
-			for (cur = beg->next;  cur;  cur = cur->next) {
-				if (compare (unsorted, cur) < 0)
-					unsorted = cur;
+			nodes[index] = *right++;
+			n_right--;
+		}
+	}
+	// remaining right nodes are already in place
+	if (n_left)
+		memcpy (nodes + index, left, n_left * sizeof (UgetNode*));
+}
+
+void  uget_node_sort (UgetNode* node, UgCompareFunc compare, int reversed)
+{
+	UgArrayPtr  array;
+	UgetNode**  temp;
+	UgetNode*   cur;
+	int         indexed;
+	int         index;
+
+	if (node->n_children < 2)
+		return;
+
+	// store children to array and sort them in O(n log n)
+	ug_array_init (&array, sizeof (void*), node->n_children);
+	for (cur = node->children;  cur;  cur = cur->next)
+		*(UgetNode**) ug_array_alloc (&array, 1) = cur;
+	if (uget_node_sort_by_key ((UgetNode**) array.at, array.length,
+	                           compare, reversed) == FALSE)
+	{
+		temp = ug_malloc (sizeof (UgetNode*) * ((array.length >> 1) + 1));
+		uget_node_merge_sort ((UgetNode**) array.at, temp, array.length,
+		                      compare, reversed);
+		ug_free (temp);
+	}
+
+	// relink children by sorted array
+	indexed = (node->index_root) ? TRUE : FALSE;
+	if (indexed)
+		ug_node_index_free ((UgNode*) node);
+	for (index = 0;  index < array.length;  index++) {
+		cur = array.at[index];
+		ug_node_remove ((UgNode*) node, (UgNode*) cur);
+		ug_node_append ((UgNode*) node, (UgNode*) cur);
+	}
+	if (indexed)
+		ug_node_index_build ((UgNode*) node);
+	ug_array_clear (&array);
+}
+
+// TRUE if node1 can be placed before node2
+#define IN_ORDER(node1, node2)    \
+		( ((reverse) ? compare (node2, node1) : compare (node1, node2)) <= 0 )
+
+// return the first child that 'child' must be inserted before it.
+static UgetNode* uget_node_find_sorted (UgetNode* node, UgetNode* child,
+                                        UgCompareFunc compare, int reverse)
+{
+	UgNodeIndex*  record;
+	UgetNode*     sibling;
+	UgetNode*     cur;
+	int           diff;
+
+	if (node->index_root == NULL && node->n_children >= UG_NODE_INDEX_THRESHOLD)
+		ug_node_index_build ((UgNode*) node);
+
+	// binary search by index of children
+	if (node->index_root) {
+		sibling = NULL;
+		for (record = node->index_root;  record;  ) {
+			cur = (UgetNode*) record->node;
+			if (reverse == FALSE)
+				diff = compare (cur, child);
+			else
+				diff = compare (child, cur);
+			if (diff > 0) {
+				sibling = cur;
+				record = record->left;
 			}
+			else
+				record = record->right;
 		}
+		return sibling;
+	}
 
-		if (unsorted != beg)
-			uget_node_move (node, beg, unsorted);
+	if (reverse == FALSE) {
+		for (cur = node->children;  cur;  cur = cur->next) {
+			if (compare (cur, child) > 0)
+				return cur;
+		}
 	}
+	else {
+		for (cur = node->children;  cur;  cur = cur->next) {
+			if (compare (child, cur) > 0)
+				return cur;
+		}
+	}
+	return NULL;
 }
 
 void  uget_node_insert_sorted (UgetNode* node, UgetNode* child)
 {
 	UgCompareFunc  compare;
-	UgetNode*      cur;
-	int            reverse;
 
 	compare = node->control->sort.compare;
-	reverse = node->control->sort.reverse;
 	if (compare == NULL)
 		return;
 
-	if (reverse == FALSE) {
-		for (cur = node->children;  cur;  cur = cur->next) {
-			if (compare (cur, child) > 0) {
-				uget_node_insert (node, cur, child);
-				return;
-			}
-		}
+	uget_node_insert (node,
+	                  uget_node_find_sorted (node, child, compare,
+	                                         node->control->sort.reverse),
+	                  child);
+}
+
+// collect fake nodes that are in sorted parent.
+static void  uget_node_store_sorted_fake (UgetNode* node, UgArrayPtr* array)
+{
+	UgetNode*  fake;
+
+	for (fake = node->fake;  fake;  fake = fake->peer) {
+		if (fake->parent && fake->parent->control->sort.compare)
+			*(UgetNode**) ug_array_alloc (array, 1) = fake;
+		uget_node_store_sorted_fake (fake, array);
 	}
-	else {
-		for (cur = node->children;  cur;  cur = cur->next) {
-			if (compare (child, cur) > 0) {
-				uget_node_insert (node, cur, child);
-				return;
-			}
+}
+
+// TRUE if 'child' is in order with it's neighbours.
+static int  uget_node_is_in_order (UgetNode* child)
+{
+	UgCompareFunc  compare;
+	int            reverse;
+
+	compare = child->parent->control->sort.compare;
+	reverse = child->parent->control->sort.reverse;
+	if (child->prev && IN_ORDER (child->prev, child) == FALSE)
+		return FALSE;
+	if (child->next && IN_ORDER (child, child->next) == FALSE)
+		return FALSE;
+	return TRUE;
+}
+
+int   uget_node_reposition_fake (UgetNode** nodes, int n_nodes)
+{
+	UgArrayPtr     array;
+	UgArrayPtr     moved;
+	UgetNode*      parent;
+	UgetNode*      sibling;
+	UgetNode*      fake;
+	UgetNodeFunc   notify;
+	int            index;
+	int            n_moved;
+
+	ug_array_init (&array, sizeof (void*), 16);
+	ug_array_init (&moved, sizeof (void*), 16);
+	for (index = 0;  index < n_nodes;  index++)
+		uget_node_store_sorted_fake (nodes[index], &array);
+
+	// Only keys of these nodes have changed, other nodes are still sorted.
+	// Remove node that is out of order with neighbours until all remaining
+	// nodes are in order, then parent is sorted again.
+	do {
+		n_moved = moved.length;
+		for (index = 0;  index < array.length;  index++) {
+			fake = array.at[index];
+			if (fake == NULL || uget_node_is_in_order (fake))
+				continue;
+			parent = fake->parent;
+			sibling = fake->next;
+			ug_node_remove ((UgNode*) parent, (UgNode*) fake);
+			notify = parent->control->notifier.removed;
+			if (notify)
+				notify (parent, sibling, fake);
+			// store parent and removed node
+			*(UgetNode**) ug_array_alloc (&moved, 1) = parent;
+			*(UgetNode**) ug_array_alloc (&moved, 1) = fake;
+			array.at[index] = NULL;
 		}
+	} while (n_moved != moved.length);
+
+	// insert removed nodes by binary search
+	for (index = 0;  index < moved.length;  index += 2) {
+		parent = moved.at[index];
+		fake   = moved.at[index + 1];
+		sibling = uget_node_find_sorted (parent, fake,
+		                                 parent->control->sort.compare,
+		                                 parent->control->sort.reverse);
+		ug_node_insert ((UgNode*) parent, (UgNode*) sibling, (UgNode*) fake);
+		notify = parent->control->notifier.inserted;
+		if (notify)
+			notify (parent, sibling, fake);
 	}
-	uget_node_insert (node, NULL, child);
+
+	n_moved = moved.length / 2;
+	ug_array_clear (&array);
+	ug_array_clear (&moved);
+	return n_moved;
 }
 
 void  uget_node_reorder_by_real (UgetNode* node, UgetNode* real)
@@ -411,6 +584,47 @@ void  uget_node_make_fake (UgetNode* node)
 	}
 }
 
+void  uget_node_attach_fake (UgetNode* node, UgetNode* fake)
+{
+	UgetNode*    child;
+	UgetNode*    real;
+	UgetNodeFunc filter;
+
+	fake->real = node;
+	fake->peer = node->fake;
+	node->fake = fake;
+
+	filter = fake->control->filter;
+	if (filter == NULL)
+		return;
+	for (child = node->children;  child;  child = child->next)
+		filter (fake, NULL, child);
+	// filter grandchildren into fake nodes that filter created
+	for (child = fake->children;  child;  child = child->next) {
+		if (child->real == NULL)
+			continue;
+		filter = child->control->filter;
+		for (real = child->real->children;  real;  real = real->next)
+			filter (child, NULL, real);
+	}
+}
+
+void  uget_node_detach_fake (UgetNode* node, UgetNode* fake)
+{
+	UgetNode*  child;
+	UgetNode*  next;
+
+	for (child = fake->children;  child;  child = next) {
+		next = child->next;
+		// keep virtual node that has no real node. e.g. "All Category"
+		if (child->real)
+			uget_node_free (child);
+		else
+			uget_node_clear_children (child);
+	}
+	uget_node_remove_fake (node, fake);
+}
+
 // fake filter node from real.
 // If real node inserted a child node, all fake nodes call this to filter.
 static void  uget_node_call_fake_filter (UgetNode* parent, UgetNode* sibling, UgetNode* child)
@@ -479,7 +693,8 @@ UgJsonError ug_json_parse_uget_node_children (UgJson* json,
 		return UG_JSON_ERROR_TYPE_NOT_MATCH;
 	}
 
-	temp = uget_node_new (NULL);
+	// downloads use arena of their category
+	temp = uget_node_new_in (((UgetNode*) node)->data->slice);
 	uget_node_append (node, temp);
 	ug_json_push (json, ug_json_parse_entry, temp, (void*)UgetNodeEntry);
 	return UG_JSON_ERROR_NONE;
@@ -160,6 +160,8 @@ struct UgetNode
 	UgetNode*     children;
 	UgetNode*     last;
 	int           n_children;
+	UgNodeIndex*  index;
+	UgNodeIndex*  index_root;
  */
 
 	UgetNode*     real;
@@ -171,6 +173,9 @@ struct UgetNode
 };
 
 UgetNode*  uget_node_new (UgetNode* node_real);
+// new real node and it's data are allocated from arena 'slice'.
+// Fake nodes use arena of their real node.
+UgetNode*  uget_node_new_in (UgSlice* slice);
 void  uget_node_init (UgetNode* node, UgetNode* node_real);
 void  uget_node_free (UgetNode* node);
 
@@ -183,13 +188,22 @@ void  uget_node_remove (UgetNode* node, UgetNode* child);
 void  uget_node_append (UgetNode* node, UgetNode* child);
 void  uget_node_prepend (UgetNode* node, UgetNode* child);
 
+// uget_node_sort() doesn't reorder fake nodes, caller must reorder them by
+// uget_node_reorder_by_real().
 void  uget_node_sort (UgetNode* node, UgCompareFunc cmp_func, int is_reversed);
 void  uget_node_insert_sorted (UgetNode* node, UgetNode* child);
 void  uget_node_reorder_by_real (UgetNode* node, UgetNode* real);
+// sorting keys of 'nodes' have changed, move their fake nodes in sorted parent
+// if they moved past neighbours. return number of moved fake nodes.
+int   uget_node_reposition_fake (UgetNode** nodes, int n_nodes);
 void  uget_node_reorder_by_fake (UgetNode* node, UgetNode* fake);
 
 void  uget_node_remove_fake (UgetNode* node, UgetNode* fake);
 void  uget_node_make_fake (UgetNode* node);
+// link 'fake' to 'node' and filter existing children of 'node' into 'fake'.
+void  uget_node_attach_fake (UgetNode* node, UgetNode* fake);
+// free children that 'fake' filtered from 'node' and unlink 'fake'.
+void  uget_node_detach_fake (UgetNode* node, UgetNode* fake);
 
 #define uget_node_nth_child(node,nth)         \
 		(UgetNode*) ug_node_nth_child((UgNode*)node, nth)
@@ -230,6 +244,11 @@ int   uget_node_compare_uri          (UgetNode* node1, UgetNode* node2);
 int   uget_node_compare_added_time   (UgetNode* node1, UgetNode* node2);
 int   uget_node_compare_completed_time (UgetNode* node1, UgetNode* node2);
 
+// sort array of nodes by precomputed keys of above compare functions.
+// return FALSE if 'compare' is not one of above functions.
+int   uget_node_sort_by_key (UgetNode** nodes, int length,
+                             UgCompareFunc compare, int reversed);
+
 /* ----------------------------------------------------------------------------
    callback functions for UgetNode.control.filter (they are used by UgetApp)
    these function implemented in UgetNode-filter.c
@@ -39,6 +39,7 @@
 #endif
 
 //#include <UgStdio.h>
+#include <UgString.h>
 #include <UgetOption.h>
 #include <UgetData.h>
 
@@ -112,9 +113,9 @@ int  uget_option_value_to_data (UgetOptionValue* ivalue, UgData* data)
 		temp.common = ug_data_realloc(data, UgetCommonInfo);
 		temp.common->keeping.enable = TRUE;
 		if (ivalue->common.folder) {
-			ug_free(temp.common->folder);
-			temp.common->folder = ivalue->common.folder;
+			ug_str_set_shared(&temp.common->folder, ivalue->common.folder);
 			temp.common->keeping.folder = TRUE;
+			ug_free(ivalue->common.folder);
 			ivalue->common.folder = NULL;
 		}
 		if (ivalue->common.file) {
@@ -146,9 +147,9 @@ int  uget_option_value_to_data (UgetOptionValue* ivalue, UgData* data)
 			ivalue->proxy.type = 0;
 		}
 		if (ivalue->proxy.host) {
-			ug_free(temp.proxy->host);
-			temp.proxy->host = ivalue->proxy.host;
+			ug_str_set_shared(&temp.proxy->host, ivalue->proxy.host);
 			temp.proxy->keeping.host = TRUE;
+			ug_free(ivalue->proxy.host);
 			ivalue->proxy.host = NULL;
 		}
 		if (ivalue->proxy.port) {
@@ -186,15 +187,15 @@ int  uget_option_value_to_data (UgetOptionValue* ivalue, UgData* data)
 			ivalue->http.password = NULL;
 		}
 		if (ivalue->http.referrer) {
-			ug_free(temp.http->referrer);
-			temp.http->referrer = ivalue->http.referrer;
+			ug_str_set_shared(&temp.http->referrer, ivalue->http.referrer);
 			temp.http->keeping.referrer = TRUE;
+			ug_free(ivalue->http.referrer);
 			ivalue->http.referrer = NULL;
 		}
 		if (ivalue->http.user_agent) {
-			ug_free(temp.http->user_agent);
-			temp.http->user_agent = ivalue->http.user_agent;
+			ug_str_set_shared(&temp.http->user_agent, ivalue->http.user_agent);
 			temp.http->keeping.user_agent = TRUE;
+			ug_free(ivalue->http.user_agent);
 			ivalue->http.user_agent = NULL;
 		}
 		if (ivalue->http.cookie_data) {
@@ -204,9 +205,9 @@ int  uget_option_value_to_data (UgetOptionValue* ivalue, UgData* data)
 			ivalue->http.cookie_data = NULL;
 		}
 		if (ivalue->http.cookie_file) {
-			ug_free(temp.http->cookie_file);
-			temp.http->cookie_file = ivalue->http.cookie_file;
+			ug_str_set_shared(&temp.http->cookie_file, ivalue->http.cookie_file);
 			temp.http->keeping.cookie_file = TRUE;
+			ug_free(ivalue->http.cookie_file);
 			ivalue->http.cookie_file = NULL;
 		}
 		if (ivalue->http.post_data) {
@@ -216,9 +217,9 @@ int  uget_option_value_to_data (UgetOptionValue* ivalue, UgData* data)
 			ivalue->http.post_data = NULL;
 		}
 		if (ivalue->http.post_file) {
-			ug_free(temp.http->post_file);
-			temp.http->post_file = ivalue->http.post_file;
+			ug_str_set_shared(&temp.http->post_file, ivalue->http.post_file);
 			temp.http->keeping.post_file = TRUE;
+			ug_free(ivalue->http.post_file);
 			ivalue->http.post_file = NULL;
 		}
 	}
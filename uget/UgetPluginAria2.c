@@ -73,6 +73,7 @@ static UgJsonrpcObject*  alloc_speed_request(UgetPluginAria2* plugin);
 static void              recycle_speed_request(UgJsonrpcObject* object);
 static UgJsonrpcObject*  alloc_status_request(UgValue** gid);
 static void              recycle_status_request(UgJsonrpcObject* object);
+static void              index_status_entry(int add);
 
 static void* ug_file_to_base64(const char* file, int* length);
 static int   decide_file_type(UgetPluginAria2* plugin);
@@ -145,6 +146,7 @@ static UgetResult  global_init(void)
 	if (global.data == NULL) {
 		global.data = uget_aria2_new();
 		uget_aria2_start_thread(global.data);
+		index_status_entry(TRUE);
 	}
 	global.ref_count++;
 	return UGET_RESULT_OK;
@@ -162,6 +164,7 @@ static void  global_unref(void)
 
 	global.ref_count--;
 	if (global.ref_count == 0) {
+		index_status_entry(FALSE);
 		if (global.data->shutdown)
 			uget_aria2_shutdown(global.data);
 		uget_aria2_stop_thread(global.data);
@@ -648,14 +651,260 @@ static void  add_gids_by_value_array(UgArrayStr* gids, UgValueArray* varray)
 	// debug
 	printf("add %d gids\n", varray->length);
 #endif
+	// strings of response are in arena, copy them.
 	for (index = 0;  index < varray->length;  index++) {
 		value = varray->at + index;
-		*(char**) ug_array_alloc(gids, 1) = value->c.string;
-		value->c.string = NULL;
-		value->type = UG_VALUE_NONE;
+		*(char**) ug_array_alloc(gids, 1) = ug_strdup(value->c.string);
 	}
 }
 
+// ------------------------------------
+// parse "result" of aria2.tellStatus into Aria2Telled
+
+// Aria2Telled belongs to status request of plugin_thread(). The aria2 thread
+// parses "result" into it, then plugin_thread() copies it to UgetPluginAria2
+// after uget_aria2_respond() returned. The aria2 thread never touches plug-in.
+typedef struct Aria2TelledFile  Aria2TelledFile;
+typedef struct Aria2Telled      Aria2Telled;
+
+struct Aria2TelledFile
+{
+	char*      path;
+	int64_t    length;
+	int64_t    completedLength;
+};
+
+struct Aria2Telled
+{
+	int        status;
+	int        errorCode;
+	int64_t    totalLength;
+	int64_t    completedLength;
+	int64_t    uploadLength;
+	int        downloadSpeed;
+	int        uploadSpeed;
+	UgArrayStr gids;       // "followedBy"
+	UG_ARRAY(Aria2TelledFile)  files;
+};
+
+static UgJsonError  parse_status_string(UgJson* json,
+                                        const char* name, const char* value,
+                                        void* dest, void* none);
+static UgJsonError  parse_status_gid(UgJson* json,
+                                     const char* name, const char* value,
+                                     void* gids, void* none);
+static UgJsonError  parse_status_file(UgJson* json,
+                                      const char* name, const char* value,
+                                      void* files, void* none);
+
+static const UgEntry  Aria2StatusEntry[] =
+{
+	{"status",          offsetof(Aria2Telled, status),          UG_ENTRY_CUSTOM,
+			parse_status_string,        NULL},
+	{"errorCode",       offsetof(Aria2Telled, errorCode),       UG_ENTRY_CUSTOM,
+			ug_json_parse_int_string,   NULL},
+	{"totalLength",     offsetof(Aria2Telled, totalLength),     UG_ENTRY_CUSTOM,
+			ug_json_parse_int64_string, NULL},
+	{"completedLength", offsetof(Aria2Telled, completedLength), UG_ENTRY_CUSTOM,
+			ug_json_parse_int64_string, NULL},
+	{"uploadLength",    offsetof(Aria2Telled, uploadLength),    UG_ENTRY_CUSTOM,
+			ug_json_parse_int64_string, NULL},
+	{"downloadSpeed",   offsetof(Aria2Telled, downloadSpeed),   UG_ENTRY_CUSTOM,
+			ug_json_parse_int_string,   NULL},
+	{"uploadSpeed",     offsetof(Aria2Telled, uploadSpeed),     UG_ENTRY_CUSTOM,
+			ug_json_parse_int_string,   NULL},
+	{"followedBy",      offsetof(Aria2Telled, gids),            UG_ENTRY_ARRAY,
+			parse_status_gid,           NULL},
+	{"files",           offsetof(Aria2Telled, files),           UG_ENTRY_ARRAY,
+			parse_status_file,          NULL},
+	{NULL}
+};
+
+static const UgEntry  Aria2FileEntry[] =
+{
+	{"path",            offsetof(Aria2TelledFile, path),        UG_ENTRY_STRING,
+			NULL,                       NULL},
+	{"length",          offsetof(Aria2TelledFile, length),      UG_ENTRY_CUSTOM,
+			ug_json_parse_int64_string, NULL},
+	{"completedLength", offsetof(Aria2TelledFile, completedLength), UG_ENTRY_CUSTOM,
+			ug_json_parse_int64_string, NULL},
+	{NULL}
+};
+
+// status request is parsed every 0.5 second, add entries to name index.
+static void  index_status_entry(int add)
+{
+	if (add) {
+		ug_entry_index_add(Aria2StatusEntry);
+		ug_entry_index_add(Aria2FileEntry);
+	}
+	else {
+		ug_entry_index_remove(Aria2StatusEntry);
+		ug_entry_index_remove(Aria2FileEntry);
+	}
+}
+
+static void  telled_init(Aria2Telled* telled)
+{
+	ug_array_init(&telled->gids, sizeof(char*), 0);
+	ug_array_init(&telled->files, sizeof(Aria2TelledFile), 0);
+}
+
+// reset fields that status response may not have
+static void  telled_reset(Aria2Telled* telled)
+{
+	int  index;
+
+	telled->status = ARIA2_N_STATUS;
+	telled->errorCode = 0;
+	ug_array_foreach_str(&telled->gids, (UgForeachFunc) ug_free, NULL);
+	telled->gids.length = 0;
+	for (index = 0;  index < telled->files.length;  index++)
+		ug_free(telled->files.at[index].path);
+	telled->files.length = 0;
+}
+
+static void  telled_final(Aria2Telled* telled)
+{
+	telled_reset(telled);
+	ug_array_clear(&telled->gids);
+	ug_array_clear(&telled->files);
+}
+
+// UgJsonParseFunc for "result" of aria2.tellStatus
+static UgJsonError  parse_status(UgJson* json,
+                                 const char* name, const char* value,
+                                 void* telled, void* none)
+{
+	if (json->type != UG_JSON_OBJECT)
+		return UG_JSON_ERROR_TYPE_NOT_MATCH;
+	ug_json_push(json, ug_json_parse_entry, telled, (void*)Aria2StatusEntry);
+	return UG_JSON_ERROR_NONE;
+}
+
+// use this if "result" was parsed into UgValue.
+static void  parse_status_value(Aria2Telled* telled, UgValue* result)
+{
+	UgJson  json;
+
+	ug_json_init(&json);
+	ug_json_begin_parse(&json);
+	ug_json_push(&json, parse_status, telled, NULL);
+	ug_json_parse_by_value(&json, result);
+	ug_json_end_parse(&json);
+	ug_json_final(&json);
+}
+
+static UgJsonError  parse_status_string(UgJson* json,
+                                        const char* name, const char* value,
+                                        void* dest, void* none)
+{
+	if (json->type != UG_JSON_STRING)
+		return UG_JSON_ERROR_TYPE_NOT_MATCH;
+
+	switch (value[0]) {
+	case 'a':
+		*(int*)dest = ARIA2_STATUS_ACTIVE;
+		break;
+	case 'w':
+		*(int*)dest = ARIA2_STATUS_WAITING;
+		break;
+	case 'p':
+		*(int*)dest = ARIA2_STATUS_PAUSED;
+		break;
+	case 'e':
+		*(int*)dest = ARIA2_STATUS_ERROR;
+		break;
+	case 'c':
+		*(int*)dest = ARIA2_STATUS_COMPLETE;
+		break;
+	case 'r':
+		*(int*)dest = ARIA2_STATUS_REMOVED;
+		break;
+	default:
+		*(int*)dest = ARIA2_N_STATUS;
+		break;
+	}
+	return UG_JSON_ERROR_NONE;
+}
+
+// element of "followedBy"
+static UgJsonError  parse_status_gid(UgJson* json,
+                                     const char* name, const char* value,
+                                     void* gids, void* none)
+{
+	if (json->type != UG_JSON_STRING)
+		return UG_JSON_ERROR_TYPE_NOT_MATCH;
+	*(char**) ug_array_alloc(gids, 1) = ug_strdup(value);
+	return UG_JSON_ERROR_NONE;
+}
+
+// element of "files"
+static UgJsonError  parse_status_file(UgJson* json,
+                                      const char* name, const char* value,
+                                      void* files, void* none)
+{
+	Aria2TelledFile*  afile;
+
+	if (json->type != UG_JSON_OBJECT)
+		return UG_JSON_ERROR_TYPE_NOT_MATCH;
+	// the previous member is completed, pointer to it is no longer used.
+	afile = ug_array_alloc(files, 1);
+	memset(afile, 0, sizeof(Aria2TelledFile));
+	ug_json_push(json, ug_json_parse_entry, afile, (void*)Aria2FileEntry);
+	return UG_JSON_ERROR_NONE;
+}
+
+// copy parsed status to plug-in. This is called by plugin_thread().
+// Files that were added by previous status (index < files_per_gid) are
+// skipped, only new files are added by uget_files_realloc().
+static void  telled_apply(Aria2Telled* telled, UgetPluginAria2* plugin)
+{
+	Aria2TelledFile*  afile;
+	UgetFile*  ufile;
+	char*      string;
+	int        count;
+	int        index;
+
+	uget_plugin_lock(plugin);
+	plugin->status          = telled->status;
+	plugin->errorCode       = telled->errorCode;
+	plugin->totalLength     = telled->totalLength;
+	plugin->completedLength = telled->completedLength;
+	plugin->uploadLength    = telled->uploadLength;
+	plugin->downloadSpeed   = telled->downloadSpeed;
+	plugin->uploadSpeed     = telled->uploadSpeed;
+	// move strings of "followedBy" to plugin->gids
+	if (telled->gids.length > 0) {
+		memcpy(ug_array_alloc(&plugin->gids, telled->gids.length),
+		       telled->gids.at, sizeof(char*) * telled->gids.length);
+		telled->gids.length = 0;
+	}
+
+	for (count = 0, index = 0;  index < telled->files.length;  index++) {
+		afile = telled->files.at + index;
+		if (afile->path == NULL || afile->path[0] == 0)
+			continue;
+		// add .aria2 control file if there is only one file
+		if (count == 0 && index == telled->files.length - 1 &&
+		    plugin->files_per_gid != 1)
+		{
+			string = ug_strdup_printf("%s.aria2", afile->path);
+			ufile = uget_files_realloc(plugin->files, string);
+			ufile->type = UGET_FILE_TEMPORARY;
+			ug_free(string);
+		}
+		if (count >= plugin->files_per_gid) {
+			ufile = uget_files_realloc(plugin->files, afile->path);
+			ufile->complete = afile->completedLength;
+			ufile->total = afile->length;
+		}
+		count++;
+	}
+	plugin->files_per_gid = count;
+	uget_plugin_unlock(plugin);
+}
+
 static int  send_start_request(UgetPluginAria2* plugin)
 {
 	UgJsonrpcObject*  res;
@@ -711,11 +960,15 @@ static UgThreadResult  plugin_thread(UgetPluginAria2* plugin)
 	UgJsonrpcObject*  status_req;
 	UgValue*          status_gid;
 	UgValue*          value;
-	UgValue*          member;
+	Aria2Telled       telled;
 	int               count;
 
 	// create status_req and initialize status_gid
 	status_req = alloc_status_request(&status_gid);
+	// parse "result" of status response into telled directly
+	telled_init(&telled);
+	status_req->result_parser.func = parse_status;
+	status_req->result_parser.data = &telled;
 	// send start_request to server
 	plugin->restart = FALSE;
 	if (send_start_request(plugin) == FALSE)
@@ -745,6 +998,8 @@ static UgThreadResult  plugin_thread(UgetPluginAria2* plugin)
 		// set gid for status request
 //		status_req->params.c.array->at[0].c.string = plugin->gids.at[0];
 		status_gid->c.string = plugin->gids.at[0];
+		// reset fields that status response may not have
+		telled_reset(&telled);
 		// status request
 		uget_aria2_request(global.data, status_req);
 		// speed control : speed request & response
@@ -778,79 +1033,11 @@ static UgThreadResult  plugin_thread(UgetPluginAria2* plugin)
 		}
 
 		// parse status response --- start ---
-		ug_value_sort_name(&res->result);
-		value = ug_value_find_name(&res->result, "status");
-		switch (value->c.string[0]) {
-		case 'a':
-			plugin->status = ARIA2_STATUS_ACTIVE;
-			break;
-		case 'w':
-			plugin->status = ARIA2_STATUS_WAITING;
-			break;
-		case 'p':
-			plugin->status = ARIA2_STATUS_PAUSED;
-			break;
-		case 'e':
-			plugin->status = ARIA2_STATUS_ERROR;
-			break;
-		case 'c':
-			plugin->status = ARIA2_STATUS_COMPLETE;
-			break;
-		case 'r':
-			plugin->status = ARIA2_STATUS_REMOVED;
-			break;
-		default:
-			plugin->status = ARIA2_N_STATUS;
-			break;
-		}
-		value = ug_value_find_name(&res->result, "errorCode");
-		plugin->errorCode = (value) ? ug_value_get_int(value) : 0;
-		value = ug_value_find_name(&res->result, "totalLength");
-		plugin->totalLength = ug_value_get_int64(value);
-		value = ug_value_find_name(&res->result, "completedLength");
-		plugin->completedLength = ug_value_get_int64(value);
-		value = ug_value_find_name(&res->result, "uploadLength");
-		plugin->uploadLength = ug_value_get_int64(value);
-		value = ug_value_find_name(&res->result, "downloadSpeed");
-		plugin->downloadSpeed = ug_value_get_int(value);
-		value = ug_value_find_name(&res->result, "uploadSpeed");
-		plugin->uploadSpeed = ug_value_get_int(value);
-		value = ug_value_find_name(&res->result, "followedBy");
-		if (value)
-			add_gids_by_value_array(&plugin->gids, value->c.array);
-		value = ug_value_find_name(&res->result, "files");
-		if (value && ug_value_length(value) != plugin->files_per_gid) {
-			UgValueArray*  array;
-			UgetFile*      ufile;
-			char*          string;
-
-			array = value->c.array;
-			plugin->files_per_gid = ug_value_length(value);
-			for (count = 0;  count < array->length;  count++) {
-				value = array->at + count;
-				ug_value_sort_name(value);
-				member = ug_value_find_name(value, "path");
-				if (member == NULL || member->c.string[0] == '\0') {
-					plugin->files_per_gid--;
-					continue;
-				}
-				uget_plugin_lock(plugin);
-				// add .aria2 control file first
-				if (plugin->files_per_gid == 1) {
-					string = ug_strdup_printf("%s.aria2", member->c.string);
-					ufile = uget_files_realloc(plugin->files, string);
-					ufile->type = UGET_FILE_TEMPORARY;
-					ug_free(string);
-				}
-				// add downloading file
-				ufile = uget_files_realloc(plugin->files, member->c.string);
-				member = ug_value_find_name(value, "completedLength");
-				ufile->complete = ug_value_get_int64(member);
-				member = ug_value_find_name(value, "length");
-				ufile->total = ug_value_get_int64(member);
-				uget_plugin_unlock(plugin);
-			}
-		}
+		// "result" was parsed into telled by parse_status() if it is not in
+		// res->result.
+		if (res->result.type != UG_VALUE_NONE)
+			parse_status_value(&telled, &res->result);
+		telled_apply(&telled, plugin);
 		// parse status response --- end ---
 
 		// recycle status response
@@ -887,7 +1074,10 @@ static UgThreadResult  plugin_thread(UgetPluginAria2* plugin)
 	}
 
 exit:
+	// uget_aria2_respond() returns after aria2 thread finished status_req,
+	// even if it returns NULL. Nothing will write telled after this.
 	recycle_status_request(status_req);
+	telled_final(&telled);
 	plugin->stopped = TRUE;
 	uget_plugin_unref((UgetPlugin*)plugin);
 	return UG_THREAD_RESULT;
@@ -295,6 +295,7 @@ static UgThreadResult  plugin_thread(UgetPluginMedia* plugin)
 	UgetEvent*     msg;
 	const char*    type = NULL;
 	const char*    quality = NULL;
+	char*          str;
 
 	common = plugin->target_common;
 	umedia = uget_media_new(common->uri, 0);
@@ -332,8 +333,11 @@ static UgThreadResult  plugin_thread(UgetPluginMedia* plugin)
 
 	// set HTTP referrer
 	http = ug_data_realloc(plugin->target_data, UgetHttpInfo);
-	if (http->referrer == NULL)
-		http->referrer = ug_strdup_printf("%s%s", common->uri, "# ");
+	if (http->referrer == NULL) {
+		str = ug_strdup_printf("%s%s", common->uri, "# ");
+		ug_str_set_shared(&http->referrer, str);
+		ug_free(str);
+	}
 	// clear copied common URI
 	ug_free(common->uri);
 	common->uri = NULL;
@@ -524,8 +524,6 @@ static int  mega_parse_attributes(UgetPluginMega* plugin, char* attributes)
 
 	if (plugin->value.type != UG_VALUE_OBJECT)
 		return FALSE;
-	ug_value_sort(&plugin->value, ug_value_compare_name);
-
 	// get file name
 	member = ug_value_find_name(&plugin->value, "n");
 	if (member == NULL || member->type != UG_VALUE_STRING)
@@ -601,8 +599,6 @@ static int  mega_request_info(UgetPluginMega* plugin, const char* id)
 		return FALSE;
 	if (plugin->value.type != UG_VALUE_OBJECT)
 		return FALSE;
-	ug_value_sort(&plugin->value, ug_value_compare_name);
-
 	// get download URL
 	member = ug_value_find_name(&plugin->value, "g");
 	if (member == NULL || member->type != UG_VALUE_STRING)
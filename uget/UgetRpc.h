@@ -61,7 +61,7 @@ struct UgetRpc {
 /*	// ------ UgJsonrpcSocket members ------
 	UgJson           json;
 	UgJsonrpc        rpc;
-	UgBuffer         buffer;
+	UgBufferChain    chain;
 	int              socket;
  */
 
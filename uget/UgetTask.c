@@ -200,7 +200,7 @@ static int  uget_task_dispatch1(UgetTask* task, UgetNode* node, UgetPlugin* plug
 		case UGET_EVENT_WARNING:
 		case UGET_EVENT_NORMAL:
 			temp.log = ug_data_realloc(node->data, UgetLogInfo);
-			ug_list_prepend(&temp.log->messages, (UgLink*) event);
+			uget_log_add(temp.log, event);
 			break;
 
 		case UGET_EVENT_START:
@@ -12,6 +12,8 @@ LOCAL_SRC_FILES  := \
 	UgSocket.c  \
 	UgUtil.c  \
 	UgFileUtil.c  \
+	UgSlice.c  \
+	UgArena.c  \
 	UgArray.c  \
 	UgList.c  \
 	UgSLink.c  \
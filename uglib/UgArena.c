@@ -0,0 +1,178 @@
+/*
+ *
+ *   Copyright (C) 2012-2018 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  In addition, as a special exception, the copyright holders give
+ *  permission to link the code of portions of this program with the
+ *  OpenSSL library under certain conditions as described in each
+ *  individual source file, and distribute linked combinations
+ *  including the two.
+ *  You must obey the GNU Lesser General Public License in all respects
+ *  for all of the code used other than OpenSSL.  If you modify
+ *  file(s) with this exception, you may extend this exception to your
+ *  version of the file(s), but you are not obligated to do so.  If you
+ *  do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source
+ *  files in the program, then also delete it here.
+ *
+ */
+
+#include <string.h>
+#include <UgArena.h>
+
+// all allocations are aligned to ARENA_ALIGN, the same alignment as malloc()
+#define ARENA_ALIGN        (sizeof (void*) * 2)
+#define ARENA_CHUNK_SIZE   (4096 - ARENA_HEADER_SIZE)
+// ug_arena_reset() doesn't keep chunk that is larger than this.
+#define ARENA_KEEP_SIZE    (256 * 1024)
+
+struct UgArenaChunk
+{
+	UgArenaChunk*  next;
+	size_t         size;
+};
+
+#define ARENA_HEADER_SIZE  \
+		((sizeof (UgArenaChunk) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+#define ARENA_CHUNK_DATA(chunk)   ((char*) (chunk) + ARENA_HEADER_SIZE)
+
+static UgArenaChunk*  ug_arena_chunk_new (size_t size)
+{
+	UgArenaChunk*  chunk;
+
+	chunk = ug_malloc (ARENA_HEADER_SIZE + size);
+	chunk->size = size;
+	return chunk;
+}
+
+UgArena*  ug_arena_new (size_t chunk_size)
+{
+	UgArena*  arena;
+
+	arena = ug_malloc (sizeof (UgArena));
+	ug_arena_init (arena, chunk_size);
+	return arena;
+}
+
+void  ug_arena_free (UgArena* arena)
+{
+	ug_arena_final (arena);
+	ug_free (arena);
+}
+
+void  ug_arena_init (UgArena* arena, size_t chunk_size)
+{
+	if (chunk_size == 0)
+		chunk_size = ARENA_CHUNK_SIZE;
+	arena->chunks = NULL;
+	arena->cur = NULL;
+	arena->end = NULL;
+	arena->chunk_size = (chunk_size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+}
+
+void  ug_arena_final (UgArena* arena)
+{
+	UgArenaChunk*  chunk;
+
+	while (arena->chunks) {
+		chunk = arena->chunks;
+		arena->chunks = chunk->next;
+		ug_free (chunk);
+	}
+	arena->cur = NULL;
+	arena->end = NULL;
+}
+
+void  ug_arena_reset (UgArena* arena)
+{
+	UgArenaChunk*  chunk;
+	size_t         size;
+
+	chunk = arena->chunks;
+	if (chunk == NULL)
+		return;
+	// replace chunks by one chunk that can hold all of them.
+	if (chunk->next) {
+		for (size = 0;  chunk;  chunk = chunk->next)
+			size += chunk->size;
+		ug_arena_final (arena);
+		if (size > ARENA_KEEP_SIZE)
+			size = arena->chunk_size;
+		chunk = ug_arena_chunk_new (size);
+		chunk->next = NULL;
+		arena->chunks = chunk;
+	}
+	arena->cur = ARENA_CHUNK_DATA (chunk);
+	arena->end = arena->cur + chunk->size;
+}
+
+void*  ug_arena_alloc (UgArena* arena, size_t size)
+{
+	UgArenaChunk*  chunk;
+	char*          mem;
+
+	size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+	if (size > (size_t) (arena->end - arena->cur)) {
+		// large block has its own chunk, keep using space of the newest chunk.
+		if (size > arena->chunk_size / 2 && arena->chunks) {
+			chunk = ug_arena_chunk_new (size);
+			chunk->next = arena->chunks->next;
+			arena->chunks->next = chunk;
+			return ARENA_CHUNK_DATA (chunk);
+		}
+		chunk = ug_arena_chunk_new ((size > arena->chunk_size) ? size : arena->chunk_size);
+		chunk->next = arena->chunks;
+		arena->chunks = chunk;
+		arena->cur = ARENA_CHUNK_DATA (chunk);
+		arena->end = arena->cur + chunk->size;
+	}
+	mem = arena->cur;
+	arena->cur += size;
+	return mem;
+}
+
+char*  ug_arena_strdup (UgArena* arena, const char* string)
+{
+	char*   mem;
+	size_t  length;
+
+	if (string == NULL)
+		return NULL;
+	length = strlen (string) + 1;
+	mem = ug_arena_alloc (arena, length);
+	memcpy (mem, string, length);
+	return mem;
+}
+
+int   ug_arena_owns (UgArena* arena, const void* mem)
+{
+	UgArenaChunk*  chunk;
+	const char*    data;
+
+	if (mem == NULL)
+		return FALSE;
+	for (chunk = arena->chunks;  chunk;  chunk = chunk->next) {
+		data = ARENA_CHUNK_DATA (chunk);
+		if ((const char*) mem >= data && (const char*) mem < data + chunk->size)
+			return TRUE;
+	}
+	return FALSE;
+}
+
@@ -0,0 +1,86 @@
+/*
+ *
+ *   Copyright (C) 2012-2018 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  In addition, as a special exception, the copyright holders give
+ *  permission to link the code of portions of this program with the
+ *  OpenSSL library under certain conditions as described in each
+ *  individual source file, and distribute linked combinations
+ *  including the two.
+ *  You must obey the GNU Lesser General Public License in all respects
+ *  for all of the code used other than OpenSSL.  If you modify
+ *  file(s) with this exception, you may extend this exception to your
+ *  version of the file(s), but you are not obligated to do so.  If you
+ *  do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source
+ *  files in the program, then also delete it here.
+ *
+ */
+
+#ifndef UG_ARENA_H
+#define UG_ARENA_H
+
+#include <stddef.h>
+#include <UgDefine.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----------------------------------------------------------------------------
+   UgArena: bump allocator for data that is freed at the same time,
+            e.g. UgValue tree of JSON-RPC response.
+
+   Memory is carved from chunks and can't be freed one by one.
+   ug_arena_reset() releases all memory in O(1) and keeps one chunk that is
+   large enough for previous usage, so arena is warm when it is reused.
+ */
+
+typedef struct UgArena       UgArena;
+typedef struct UgArenaChunk  UgArenaChunk;
+
+struct UgArena
+{
+	UgArenaChunk*  chunks;    // the newest chunk is the first one
+	char*          cur;       // unused space of the newest chunk
+	char*          end;
+	size_t         chunk_size;
+};
+
+// param chunk_size: 0 = default size
+UgArena*  ug_arena_new (size_t chunk_size);
+void      ug_arena_free (UgArena* arena);
+
+void   ug_arena_init (UgArena* arena, size_t chunk_size);
+void   ug_arena_final (UgArena* arena);
+void   ug_arena_reset (UgArena* arena);
+
+void*  ug_arena_alloc (UgArena* arena, size_t size);
+char*  ug_arena_strdup (UgArena* arena, const char* string);
+
+// return TRUE if 'mem' was allocated from 'arena'.
+int    ug_arena_owns (UgArena* arena, const void* mem);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UG_ARENA_H
+
@@ -147,6 +147,148 @@ void* ug_array_find_sorted(void* array, const void* key,
 	return NULL;
 }
 
+// ----------------------------------------------------------------------------
+// Specialised sort and binary search.
+// Key is the first member of element and compare is inlined by macro.
+
+#define ARRAY_KEY(Type, index)  \
+		(*(Type*)(at + size * (index)))
+
+#define LESS_INT(key1, key2)    ((key1) < (key2))
+#define LESS_PTR(key1, key2)    ((uintptr_t)(key1) < (uintptr_t)(key2))
+#define LESS_STR(key1, key2)    (strcmp(key1, key2) < 0)
+
+// branchless binary search: it finds lower bound without early exit,
+// compiler can use conditional move to update 'base'.
+#define ARRAY_FIND_SORTED(Type, LESS)                                      \
+	char*  at     = ((UgArrayChar*)array)->at;                             \
+	int    size   = ((UgArrayChar*)array)->element_size;                   \
+	int    length = ((UgArrayChar*)array)->length;                         \
+	int    base   = 0;                                                     \
+	int    half;                                                           \
+	int    n;                                                              \
+                                                                           \
+	for (n = length;  n > 1;  n -= half) {                                 \
+		half = n >> 1;                                                     \
+		base = LESS(ARRAY_KEY(Type, base + half), key) ? base + half : base; \
+	}                                                                      \
+	if (length > 0 && LESS(ARRAY_KEY(Type, base), key))                    \
+		base++;                                                            \
+	if (inserted_index)                                                    \
+		inserted_index[0] = base;                                          \
+	if (base < length && LESS(key, ARRAY_KEY(Type, base)) == 0)            \
+		return at + size * base;                                           \
+	return NULL
+
+// quick sort with median of three, then insertion sort for small ranges.
+#define ARRAY_SORT_SMALL    8
+#define ARRAY_SORT(Type, LESS)                                             \
+	char*  at     = ((UgArrayChar*)array)->at;                             \
+	int    size   = ((UgArrayChar*)array)->element_size;                   \
+	int    length = ((UgArrayChar*)array)->length;                         \
+	int    stack[64];                                                      \
+	int    sp = 0;                                                         \
+	int    low, high, mid, i, j;                                           \
+	Type   pivot;                                                          \
+                                                                           \
+	stack[sp++] = 0;                                                       \
+	stack[sp++] = length - 1;                                              \
+	while (sp > 0) {                                                       \
+		high = stack[--sp];                                                \
+		low  = stack[--sp];                                                \
+		while (high - low > ARRAY_SORT_SMALL) {                            \
+			mid = low + ((high - low) >> 1);                               \
+			if (LESS(ARRAY_KEY(Type, mid), ARRAY_KEY(Type, low)))          \
+				array_swap(at, size, mid, low);                            \
+			if (LESS(ARRAY_KEY(Type, high), ARRAY_KEY(Type, low)))         \
+				array_swap(at, size, high, low);                           \
+			if (LESS(ARRAY_KEY(Type, high), ARRAY_KEY(Type, mid)))         \
+				array_swap(at, size, high, mid);                           \
+			pivot = ARRAY_KEY(Type, mid);                                  \
+			for (i = low - 1, j = high + 1;  ;  ) {                        \
+				do { i++; } while (LESS(ARRAY_KEY(Type, i), pivot));       \
+				do { j--; } while (LESS(pivot, ARRAY_KEY(Type, j)));       \
+				if (i >= j)                                                \
+					break;                                                 \
+				array_swap(at, size, i, j);                                \
+			}                                                              \
+			/* push larger range, continue with smaller one */             \
+			if (j - low > high - j) {                                      \
+				stack[sp++] = low;                                         \
+				stack[sp++] = j;                                           \
+				low = j + 1;                                               \
+			}                                                              \
+			else {                                                         \
+				stack[sp++] = j + 1;                                       \
+				stack[sp++] = high;                                        \
+				high = j;                                                  \
+			}                                                              \
+		}                                                                  \
+	}                                                                      \
+	for (i = 1;  i < length;  i++) {                                       \
+		for (j = i;  j > 0;  j--) {                                        \
+			if (LESS(ARRAY_KEY(Type, j), ARRAY_KEY(Type, j - 1)) == 0)     \
+				break;                                                     \
+			array_swap(at, size, j, j - 1);                                \
+		}                                                                  \
+	}
+
+static void  array_swap(char* at, int size, int index1, int index2)
+{
+	char*  cur1 = at + size * index1;
+	char*  cur2 = at + size * index2;
+	char*  end;
+	char   ch;
+
+	if ((size & (sizeof(void*) - 1)) == 0) {
+		void*  temp;
+
+		// element contains pointer, swap it by pointer size
+		for (end = cur1 + size;  cur1 < end;  cur1 += sizeof(void*), cur2 += sizeof(void*)) {
+			temp = *(void**)cur1;
+			*(void**)cur1 = *(void**)cur2;
+			*(void**)cur2 = temp;
+		}
+		return;
+	}
+
+	for (end = cur1 + size;  cur1 < end;  cur1++, cur2++) {
+		ch = *cur1;
+		*cur1 = *cur2;
+		*cur2 = ch;
+	}
+}
+
+void  ug_array_sort_int(void* array)
+{
+	ARRAY_SORT(int, LESS_INT)
+}
+
+void  ug_array_sort_ptr(void* array)
+{
+	ARRAY_SORT(void*, LESS_PTR)
+}
+
+void  ug_array_sort_str(void* array)
+{
+	ARRAY_SORT(char*, LESS_STR)
+}
+
+void* ug_array_find_sorted_int(void* array, int key, int* inserted_index)
+{
+	ARRAY_FIND_SORTED(int, LESS_INT);
+}
+
+void* ug_array_find_sorted_ptr(void* array, const void* key, int* inserted_index)
+{
+	ARRAY_FIND_SORTED(void*, LESS_PTR);
+}
+
+void* ug_array_find_sorted_str(void* array, const char* key, int* inserted_index)
+{
+	ARRAY_FIND_SORTED(char*, LESS_STR);
+}
+
 #if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L)
 // C99 or C++ inline functions in UgArray.h
 #else
@@ -187,7 +329,8 @@ int  ug_array_compare_string(const void *s1, const void *s2)
 
 int  ug_array_compare_pointer(const void *s1, const void *s2)
 {
-	return *(char**)s1 - *(char**)s2;
+	// don't truncate pointer difference to int
+	return (*(uintptr_t*)s1 > *(uintptr_t*)s2) - (*(uintptr_t*)s1 < *(uintptr_t*)s2);
 }
 
 // ----------------------------------------------------------------------------
@@ -61,6 +61,15 @@ void    ug_array_foreach_ptr(void* array, UgForeachFunc func, void* data);
 void*   ug_array_find_sorted(void* array, const void* key,
                              UgCompareFunc func, int* index);
 
+// Specialised sort and binary search with inlined compare.
+// Key must be the first member of element. e.g. UgPair.key, UgetFile.path
+void    ug_array_sort_int(void* array);
+void    ug_array_sort_ptr(void* array);
+void    ug_array_sort_str(void* array);
+void*   ug_array_find_sorted_int(void* array, int key, int* index);
+void*   ug_array_find_sorted_ptr(void* array, const void* key, int* index);
+void*   ug_array_find_sorted_str(void* array, const char* key, int* index);
+
 #define ug_array_foreach_str    ug_array_foreach_ptr
 
 #define ug_array_count(array, length)  \
@@ -142,33 +151,32 @@ template<class Type> struct UgArrayMethod
 // template specialization
 template<> inline void UgArrayMethod<int>::sort()
 {
-	ug_array_sort(this, ug_array_compare_int);
+	ug_array_sort_int(this);
 };
 
 template<> inline int* UgArrayMethod<int>::findSorted(int key, int* index)
 {
-	int value = key;
-	return (int*) ug_array_find_sorted(this, &value, ug_array_compare_int, index);
+	return (int*) ug_array_find_sorted_int(this, key, index);
 };
 
 template<> inline void UgArrayMethod<char*>::sort()
 {
-	ug_array_sort(this, ug_array_compare_string);
+	ug_array_sort_str(this);
 };
 
 template<> inline char** UgArrayMethod<char*>::findSorted(char* key, int* index)
 {
-	return (char**) ug_array_find_sorted(this, &key, ug_array_compare_string, index);
+	return (char**) ug_array_find_sorted_str(this, key, index);
 };
 
 template<> inline void UgArrayMethod<void*>::sort()
 {
-	ug_array_sort(this, ug_array_compare_pointer);
+	ug_array_sort_ptr(this);
 };
 
 template<> inline void** UgArrayMethod<void*>::findSorted(void* key, int* index)
 {
-	return (void**) ug_array_find_sorted(this, &key, ug_array_compare_pointer, index);
+	return (void**) ug_array_find_sorted_ptr(this, key, index);
 };
 #endif // __cplusplus
 
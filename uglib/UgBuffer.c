@@ -39,6 +39,13 @@
 #include <UgDefine.h>
 #include <UgBuffer.h>
 
+#if defined _WIN32 || defined _WIN64
+#include <UgStdio.h>      // ug_write()
+#else
+#include <errno.h>
+#include <sys/uio.h>      // writev()
+#endif
+
 void  ug_buffer_init_external(UgBuffer* buffer, char* exbuf, int length)
 {
 	buffer->beg = exbuf;
@@ -137,13 +144,21 @@ int  ug_buffer_write(UgBuffer* buffer, const char* string, int length)
 
 void  ug_buffer_write_data(UgBuffer* buffer, const char* binary, int length)
 {
-	const char*  end;
+	int  count;
 
-	end = binary + length;
-	while (binary < end) {
+	while (length > 0) {
 		if (buffer->cur == buffer->end)
 			buffer->more(buffer);
-		*buffer->cur++ = *binary++;
+		// copy as much as possible at once
+		count = (int)(buffer->end - buffer->cur);
+		if (count <= 0)
+			break;    // UgBuffer.more() failed
+		if (count > length)
+			count = length;
+		memcpy(buffer->cur, binary, count);
+		buffer->cur += count;
+		binary += count;
+		length -= count;
 	}
 }
 
@@ -157,3 +172,215 @@ void  ug_buffer_write_char(UgBuffer* buffer, char ch)
 	*(buffer)->cur++ = (char)(ch);
 }
 #endif  // __STDC_VERSION__
+
+// ----------------------------------------------------------------------------
+// UgBufferChain
+
+#define CHAIN_SPARE_MAX     16
+#define CHAIN_IOV_MAX       64
+
+static UgBufferBlock*  chain_take_block(UgBufferChain* chain)
+{
+	UgBufferBlock*  block;
+
+	block = chain->spare;
+	if (block) {
+		chain->spare = block->next;
+		chain->n_spare--;
+	}
+	else
+		block = ug_malloc(sizeof(UgBufferBlock) + chain->block_size - 1);
+	block->next = NULL;
+	block->length = 0;
+	return block;
+}
+
+static void  chain_use_block(UgBufferChain* chain, UgBufferBlock* block)
+{
+	chain->buffer.beg = block->data;
+	chain->buffer.cur = block->data;
+	chain->buffer.end = block->data + chain->block_size;
+}
+
+static void  chain_release_block(UgBufferChain* chain, UgBufferBlock* block)
+{
+	if (chain->n_spare < CHAIN_SPARE_MAX) {
+		block->next = chain->spare;
+		chain->spare = block;
+		chain->n_spare++;
+	}
+	else
+		ug_free(block);
+}
+
+// remove 'length' bytes that have been written from beginning of chain.
+// UgBufferBlock.length of last block must be set.
+static void  chain_drop(UgBufferChain* chain, int length)
+{
+	UgBufferBlock*  block;
+
+	for (block = chain->first;  block != chain->last;  block = chain->first) {
+		if (length < block->length)
+			break;
+		length -= block->length;
+		chain->first = block->next;
+		chain->n_blocks--;
+		chain_release_block(chain, block);
+	}
+	if (length > 0) {
+		memmove(block->data, block->data + length, block->length - length);
+		block->length -= length;
+		if (block == chain->last)
+			chain->buffer.cur -= length;
+	}
+}
+
+void  ug_buffer_chain_init(UgBufferChain* chain, int block_size)
+{
+	if (block_size <= 0)
+		block_size = 4096;
+	chain->block_size = block_size;
+	chain->spare = NULL;
+	chain->n_spare = 0;
+	chain->first = chain_take_block(chain);
+	chain->last = chain->first;
+	chain->n_blocks = 1;
+	chain->flush = NULL;
+	chain->data = NULL;
+	chain->limit = 0;
+	chain_use_block(chain, chain->first);
+	chain->buffer.more = ug_buffer_chain_expand;
+	chain->buffer.data = chain;
+}
+
+void  ug_buffer_chain_final(UgBufferChain* chain)
+{
+	UgBufferBlock*  block;
+
+	ug_buffer_chain_reset(chain);
+	ug_free(chain->first);
+	for (block = chain->spare;  block;  block = chain->spare) {
+		chain->spare = block->next;
+		ug_free(block);
+	}
+	chain->first = NULL;
+	chain->last = NULL;
+	chain->n_spare = 0;
+	chain->n_blocks = 0;
+	ug_buffer_clear(&chain->buffer, FALSE);
+}
+
+void  ug_buffer_chain_reset(UgBufferChain* chain)
+{
+	UgBufferBlock*  block;
+	UgBufferBlock*  next;
+
+	for (block = chain->first->next;  block;  block = next) {
+		next = block->next;
+		chain_release_block(chain, block);
+	}
+	chain->first->next = NULL;
+	chain->first->length = 0;
+	chain->last = chain->first;
+	chain->n_blocks = 1;
+	chain_use_block(chain, chain->first);
+}
+
+int   ug_buffer_chain_length(UgBufferChain* chain)
+{
+	UgBufferBlock*  block;
+	int             length = 0;
+
+	chain->last->length = ug_buffer_length(&chain->buffer);
+	for (block = chain->first;  block;  block = block->next)
+		length += block->length;
+	return length;
+}
+
+// UgBuffer.more() default function for UgBufferChain.
+int   ug_buffer_chain_expand(UgBuffer* buffer)
+{
+	UgBufferChain*  chain;
+	UgBufferBlock*  block;
+
+	chain = buffer->data;
+	chain->last->length = ug_buffer_length(buffer);
+	if (chain->flush && chain->n_blocks >= chain->limit) {
+		chain->flush(chain);
+		// if flush() failed and chain was not reset, append new block.
+		if (buffer->cur < buffer->end)
+			return 1;
+	}
+
+	block = chain_take_block(chain);
+	chain->last->next = block;
+	chain->last = block;
+	chain->n_blocks++;
+	chain_use_block(chain, block);
+	return 1;
+}
+
+int   ug_buffer_chain_write_fd(UgBufferChain* chain, int fd)
+{
+	UgBufferBlock*  block;
+	int             total = 0;
+	int             error = FALSE;
+#if defined _WIN32 || defined _WIN64
+	int             offset, n;
+
+	ug_buffer_chain_length(chain);
+	for (block = chain->first;  block && error == FALSE;  block = block->next) {
+		// ug_write() may write partially
+		for (offset = 0;  offset < block->length;  offset += n) {
+			n = ug_write(fd, block->data + offset, block->length - offset);
+			if (n <= 0) {
+				error = TRUE;
+				break;
+			}
+			total += n;
+		}
+	}
+#else
+	struct iovec    iov[CHAIN_IOV_MAX];
+	struct iovec*   cur;
+	int             n_iov;
+	ssize_t         n;
+
+	ug_buffer_chain_length(chain);
+	for (block = chain->first;  block && error == FALSE;  ) {
+		// gather at most CHAIN_IOV_MAX blocks
+		for (n_iov = 0;  block && n_iov < CHAIN_IOV_MAX;  block = block->next) {
+			if (block->length == 0)
+				continue;
+			iov[n_iov].iov_base = block->data;
+			iov[n_iov].iov_len  = block->length;
+			n_iov++;
+		}
+		// writev() may write partially
+		for (cur = iov;  n_iov > 0;  ) {
+			n = writev(fd, cur, n_iov);
+			if (n <= 0) {
+				if (n == -1 && errno == EINTR)
+					continue;
+				error = TRUE;
+				break;
+			}
+			total += (int) n;
+			for (;  n_iov > 0 && (size_t) n >= cur->iov_len;  cur++, n_iov--)
+				n -= cur->iov_len;
+			if (n_iov > 0) {
+				cur->iov_base = (char*) cur->iov_base + n;
+				cur->iov_len -= n;
+			}
+		}
+	}
+#endif  // _WIN32 || _WIN64
+
+	if (error) {
+		// keep data that was not written
+		chain_drop(chain, total);
+		return -1;
+	}
+	ug_buffer_chain_reset(chain);
+	return total;
+}
@@ -152,6 +152,63 @@ void  ug_buffer_write_char(UgBuffer* buffer, char ch);
 
 #endif  // __STDC_VERSION__ || __cplusplus
 
+// ----------------------------------------------------------------------------
+// UgBufferChain: UgBuffer that writes to a chain of fixed-size blocks.
+//                Written data is never moved and blocks can be flushed at
+//                once by writev() or sendmsg().
+
+typedef struct UgBufferBlock    UgBufferBlock;
+typedef struct UgBufferChain    UgBufferChain;
+typedef int  (*UgBufferChainFunc) (UgBufferChain* chain);
+
+struct UgBufferBlock
+{
+	UgBufferBlock*  next;
+	int             length;    // used bytes
+	char            data[1];
+};
+
+struct UgBufferChain
+{
+	UgBuffer        buffer;    // write to last block
+	UgBufferBlock*  first;
+	UgBufferBlock*  last;
+	UgBufferBlock*  spare;     // unused blocks
+	int             n_spare;
+	int             n_blocks;
+	int             block_size;
+
+	// if 'flush' is not NULL, ug_buffer_chain_expand() call it when chain
+	// has 'limit' blocks. It must write data and reset chain.
+	UgBufferChainFunc  flush;
+	void*              data;   // extra data for UgBufferChain.flush()
+	int                limit;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void  ug_buffer_chain_init(UgBufferChain* chain, int block_size);
+void  ug_buffer_chain_final(UgBufferChain* chain);
+// drop all written data and keep first block for writing
+void  ug_buffer_chain_reset(UgBufferChain* chain);
+
+// return total length. It also set UgBufferBlock.length of last block.
+int   ug_buffer_chain_length(UgBufferChain* chain);
+
+// UgBuffer.more() default function for UgBufferChain.
+int   ug_buffer_chain_expand(UgBuffer* buffer);
+
+// write all blocks to 'fd' and reset chain. It retry partial write.
+// return number of bytes written or -1 if error. If error occurred, written
+// data is removed and the rest is kept in chain.
+int   ug_buffer_chain_write_fd(UgBufferChain* chain, int fd);
+
+#ifdef __cplusplus
+}
+#endif
+
 // ----------------------------------------------------------------------------
 // C++11 standard-layout
 
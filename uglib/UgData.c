@@ -36,6 +36,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <UgSlice.h>
 #include <UgData.h>
 
 // ----------------------------------------------------------------------------
@@ -57,15 +58,17 @@ void  ug_data_set_registry(UgRegistry* registry)
 // UgData
 
 UgData* ug_data_new(int allocated_length, int cache_length)
+{
+	return ug_data_new_in(NULL, allocated_length, cache_length);
+}
+
+UgData* ug_data_new_in(UgSlice* slice, int allocated_length, int cache_length)
 {
 	UgData*  data;
 
-#ifdef HAVE_GLIB
-	data = g_slice_alloc(sizeof(UgData));
-#else
-	data = ug_malloc(sizeof(UgData));
-#endif // HAVE_GLIB
+	data = ug_slice_alloc(slice, sizeof(UgData));
 	ug_data_init(data, allocated_length, cache_length);
+	data->slice = slice;
 	return data;
 }
 
@@ -78,11 +81,7 @@ void    ug_data_unref(UgData* data)
 {
 	if (--data->ref_count == 0) {
 		ug_data_final(data);
-#ifdef HAVE_GLIB
-		g_slice_free1(sizeof(UgData), data);
-#else
-		ug_free(data);
-#endif // HAVE_GLIB
+		ug_slice_free1(sizeof(UgData), data);
 	}
 }
 
@@ -94,6 +93,7 @@ void  ug_data_init(UgData* data, int allocated_length, int cache_length)
 	data->length       = cache_length;
 	data->cache_length = cache_length;
 	data->ref_count    = 1;
+	data->slice        = NULL;
 
 	// clear cache
 	for (index = 0;  index < data->length;  index++) {
@@ -102,6 +102,24 @@ void  ug_data_init(UgData* data, int allocated_length, int cache_length)
 	}
 }
 
+// free UgGroupData if no other UgData share it.
+static void  ug_data_release_group(UgGroupData* group_data)
+{
+	if (group_data->shared > 0)
+		group_data->shared--;
+	else
+		ug_group_data_free(group_data);
+}
+
+// copy shared UgGroupData before changing it.
+static void* ug_data_unshare_group(UgGroupData* group_data)
+{
+	if (group_data->shared == 0)
+		return group_data;
+	group_data->shared--;
+	return ug_group_data_copy(group_data);
+}
+
 void  ug_data_final(UgData* data)
 {
 	UgPair* cur;
@@ -111,7 +129,7 @@ void  ug_data_final(UgData* data)
 		if (cur->key == NULL)
 			continue;
 		if (cur->data)
-			ug_group_data_free(cur->data);
+			ug_data_release_group(cur->data);
 	}
 
 	ug_array_clear(data);
@@ -121,6 +139,20 @@ UgPair* ug_data_find(UgData* data, const UgGroupDataInfo* key, int* index)
 {
 	UgPair*   end;
 	UgPair*   cur;
+	int       slot;
+
+	// fixed slot in cache space
+	slot = key->slot - 1;
+	if (slot >= 0 && slot < data->cache_length) {
+		cur = data->at + slot;
+		if (cur->key == key)
+			return cur;
+		if (cur->key == NULL) {
+			if (index)
+				index[0] = slot;
+			return NULL;
+		}
+	}
 
 	// find key in cache space
 	for (cur = data->at, end = cur + data->cache_length;  cur < end;  cur++) {
@@ -131,7 +163,7 @@ UgPair* ug_data_find(UgData* data, const UgGroupDataInfo* key, int* index)
 	// find key without cache space
 	data->at     += data->cache_length;
     data->length -= data->cache_length;
-    cur = ug_array_find_sorted(data, &key, ug_array_compare_pointer, index);
+    cur = ug_array_find_sorted_ptr(data, key, index);
 	data->at     -= data->cache_length;
     data->length += data->cache_length;
 	if (index)
@@ -139,6 +171,20 @@ UgPair* ug_data_find(UgData* data, const UgGroupDataInfo* key, int* index)
 	return cur;
 }
 
+// add key at 'index' that returned by ug_data_find()
+static UgPair* ug_data_insert(UgData* data, const UgGroupDataInfo* key, int index)
+{
+	UgPair* cur;
+
+	if (index < data->cache_length)
+		cur = data->at + index;    // empty slot
+	else
+		cur = ug_array_insert(data, index, 1);
+	cur->key = (void*) key;
+	cur->data = NULL;
+	return cur;
+}
+
 void*  ug_data_realloc(UgData* data, const UgGroupDataInfo* key)
 {
 	UgPair* cur;
@@ -146,12 +192,13 @@ void*  ug_data_realloc(UgData* data, const UgGroupDataInfo* key)
 
 	cur = ug_data_find(data, key, &index);
 	if (cur == NULL) {
-		cur = ug_array_insert(data, index, 1);
-		cur->key = (void*) key;
-		cur->data = ug_group_data_new(key);
+		cur = ug_data_insert(data, key, index);
+		cur->data = ug_type_new_in(data->slice, key);
 	}
 	else if (cur->data == NULL)
-		cur->data = ug_group_data_new(key);
+		cur->data = ug_type_new_in(data->slice, key);
+	else
+		cur->data = ug_data_unshare_group(cur->data);
 	return cur->data;
 }
 
@@ -161,7 +208,7 @@ void  ug_data_remove(UgData* data, const UgGroupDataInfo* key)
 
 	cur = ug_data_find(data, key, NULL);
 	if (cur && cur->data) {
-		ug_group_data_free(cur->data);
+		ug_data_release_group(cur->data);
 		cur->data = NULL;
 	}
 }
@@ -173,13 +220,12 @@ void*   ug_data_set(UgData* data, const UgGroupDataInfo* key, void* group_data)
 	void*   result;
 
 	cur = ug_data_find(data, key, &index);
-	if (cur == NULL) {
-		cur = ug_array_insert(data, index, 1);
-		cur->key = (void*) key;
-		cur->data = NULL;
-	}
+	if (cur == NULL)
+		cur = ug_data_insert(data, key, index);
 	result = cur->data;
 	cur->data = group_data;
+	if (result)
+		result = ug_data_unshare_group(result);
 	return result;
 }
 
@@ -193,6 +239,18 @@ void* ug_data_get(UgData* data, const UgGroupDataInfo* key)
 	return cur->data;
 }
 
+void* ug_data_get_writable(UgData* data, const UgGroupDataInfo* key)
+{
+	UgPair* cur;
+
+	cur = ug_data_find(data, key, NULL);
+	if (cur == NULL || cur->data == NULL)
+		return NULL;
+	// caller will change it
+	cur->data = ug_data_unshare_group(cur->data);
+	return cur->data;
+}
+
 void  ug_data_assign(UgData* data, UgData* src, const UgGroupDataInfo* exclude_info)
 {
 	int           index;
@@ -210,6 +268,37 @@ void  ug_data_assign(UgData* data, UgData* src, const UgGroupDataInfo* exclude_i
 	}
 }
 
+void  ug_data_inherit(UgData* data, UgData* src, const UgGroupDataInfo* exclude_info)
+{
+	int           index;
+	int           inserted_index;
+	UgPair*       pair;
+	UgPair*       cur;
+	UgGroupData*  group_data;
+
+	for (index = 0;  index < src->length;  index++) {
+		pair = src->at + index;
+		if (pair->key == NULL || pair->data == NULL)
+			continue;
+		if (pair->key == exclude_info)
+			continue;
+		cur = ug_data_find(data, pair->key, &inserted_index);
+		if (cur == NULL)
+			cur = ug_data_insert(data, pair->key, inserted_index);
+		// UgGroupData can't be copied if it has no UgAssignFunc
+		if (cur->data == NULL && ((UgGroupDataInfo*)pair->key)->assign) {
+			// share it until one of them is changed
+			group_data = pair->data;
+			group_data->shared++;
+			cur->data = group_data;
+		}
+		else {
+			group_data = ug_data_realloc(data, pair->key);
+			ug_group_data_assign(group_data, pair->data);
+		}
+	}
+}
+
 // UgJsonParseFunc for key/data pairs in UgData
 static UgJsonError ug_json_parse_data_reg(UgJson* json,
                                 const char* name, const char* value,
@@ -62,9 +62,15 @@ void         ug_data_set_registry(UgRegistry* registry);
           - It uses UgGroupDataInfo to get/alloc UgGroupData.
      key  pointer to UgGroupDataInfo
      data pointer to UgGroupData
+
+   The first 'cache_length' pairs are cache space. If UgGroupDataInfo.slot
+   is N (1 ~ cache_length), it's UgGroupData is stored in pair N-1, so
+   finding it doesn't need search. Others are sorted by UgGroupDataInfo.
  */
 
 UgData* ug_data_new(int allocated_length, int cache_length);
+// allocate UgData and it's UgGroupData from arena 'slice', see UgSlice.h
+UgData* ug_data_new_in(UgSlice* slice, int allocated_length, int cache_length);
 void    ug_data_ref(UgData* data);
 void    ug_data_unref(UgData* data);
 
@@ -76,11 +82,22 @@ void    ug_data_final(UgData* data);
 void*   ug_data_realloc(UgData* data, const UgGroupDataInfo* key);
 void    ug_data_remove(UgData* data, const UgGroupDataInfo* key);
 void*   ug_data_get(UgData* data, const UgGroupDataInfo* key);
+void*   ug_data_get_writable(UgData* data, const UgGroupDataInfo* key);
 void*   ug_data_set(UgData* data, const UgGroupDataInfo* key, void* new_group_data);
 UgPair* ug_data_find(UgData* data, const UgGroupDataInfo* key, int* inserted_index);
 
 void    ug_data_assign(UgData* data, UgData* src, const UgGroupDataInfo* exclude);
 
+// ug_data_inherit() is like ug_data_assign(), but UgGroupData that 'data'
+// doesn't have will be shared with 'src' (copy-on-write).
+// ug_data_get() return shared UgGroupData as it is, caller must not change it.
+// ug_data_get_writable(), ug_data_realloc() and ug_data_set() copy shared
+// UgGroupData before return it.
+// UgGroupData.shared is not atomic. Shared UgGroupData belong to the thread
+// that owns 'src' (UgetApp use main thread), other threads must use
+// ug_data_assign() to get their own copy.
+void    ug_data_inherit(UgData* data, UgData* src, const UgGroupDataInfo* exclude);
+
 // ----------------
 // JSON parser/writer that used with UG_ENTRY_CUSTOM.
 // if 'registry' is NULL, use default registry.
@@ -123,6 +140,7 @@ struct UgData
 
 	int     cache_length;
 	int     ref_count;
+	UgSlice* slice;    // arena of UgData and it's UgGroupData, can be NULL
 
 #ifdef __cplusplus
 	// C++11 standard-layout
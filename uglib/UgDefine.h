@@ -69,6 +69,7 @@ typedef void  (*UgNotifyFunc) (void* user_data);
 
 typedef void  (*UgForeachFunc)(void* instance, void* data);
 typedef int   (*UgCompareFunc)(const void* a, const void* b);
+typedef char* (*UgStrdupFunc) (const char* string);
 
 #if defined _WIN32 || defined _WIN64
 #define UG_DIR_SEPARATOR    '\\'
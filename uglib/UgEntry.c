@@ -40,22 +40,276 @@
 #include <UgString.h>
 #include <UgEntry.h>
 #include <UgValue.h>
+#include <UgThread.h>
 
 #if defined(_MSC_VER)
 #define strtoll     _strtoi64
 #define strtoull    _strtoui64
 #endif
 
+// ----------------------------------------------------------------------------
+// UgEntryIndex: hash table of names in UgEntry array.
+// It is built by ug_entry_index_add() and freed by ug_entry_index_remove().
+// Seed of hash function is chosen to avoid collision, so name usually can be
+// found at first slot.
+
+static UgMutexStatic  index_mutex = UG_MUTEX_STATIC_INIT;
+#define index_lock()      ug_mutex_static_lock (&index_mutex)
+#define index_unlock()    ug_mutex_static_unlock (&index_mutex)
+
+#if defined _WIN32 || defined _WIN64
+#include <windows.h>
+#define index_load(slot)          (const UgEntry*) InterlockedCompareExchangePointer ((PVOID volatile*) &(slot), NULL, NULL)
+#define index_store(slot, entry)  InterlockedExchangePointer ((PVOID volatile*) &(slot), (PVOID) (entry))
+#else
+#define index_load(slot)          __atomic_load_n (&(slot), __ATOMIC_ACQUIRE)
+#define index_store(slot, entry)  __atomic_store_n (&(slot), entry, __ATOMIC_RELEASE)
+#endif
+
+#define INDEX_N_SEEDS      64
+#define INDEX_TABLE_SIZE   256     // power of 2
+#define INDEX_REMOVED      ((const UgEntry*) index_table)
+
+typedef struct UgEntryIndex   UgEntryIndex;
+typedef struct UgEntrySlot    UgEntrySlot;
+
+struct UgEntryIndex
+{
+	const UgEntry*  entry;      // UgEntry array
+	const UgEntry*  any;        // first entry that UgEntry.name is NULL
+	unsigned int    seed;
+	unsigned int    mask;       // number of slots - 1
+	const UgEntry*  slots[1];   // NULL if slot is empty
+};
+
+// open addressing, key is address of UgEntry array.
+// 'index' is set before 'entry', so reader doesn't lock it. Reader only use
+// 'index' of array that it is parsing, and that one can't be removed.
+struct UgEntrySlot
+{
+	const UgEntry*  entry;      // NULL if empty, INDEX_REMOVED if removed
+	UgEntryIndex*   index;
+	int             ref_count;  // protected by index_mutex
+};
+
+static UgEntrySlot    index_table[INDEX_TABLE_SIZE];
+
+static unsigned int  index_hash(const char* name, unsigned int seed)
+{
+	unsigned int  hash = 2166136261u ^ seed;
+
+	for (;  *name;  name++)
+		hash = (hash ^ (unsigned char) *name) * 16777619u;
+	return hash ^ (hash >> 15);
+}
+
+static unsigned int  index_hash_pointer(const void* pointer)
+{
+	uintptr_t  value = (uintptr_t) pointer;
+
+	value ^= value >> 17;
+	return (unsigned int) (value * 2654435761u);
+}
+
+// return TRUE if all names were placed without collision.
+static int  index_fill(UgEntryIndex* index)
+{
+	const UgEntry*  entry;
+	unsigned int    pos;
+	int             perfect = TRUE;
+
+	memset(index->slots, 0, sizeof(UgEntry*) * (index->mask + 1));
+	for (entry = index->entry;  entry->type;  entry++) {
+		if (entry->name == NULL) {
+			if (index->any == NULL)
+				index->any = entry;
+			continue;
+		}
+		pos = index_hash(entry->name, index->seed) & index->mask;
+		for (;  index->slots[pos];  pos = (pos + 1) & index->mask) {
+			// keep first one if name is duplicated
+			if (strcmp(index->slots[pos]->name, entry->name) == 0)
+				break;
+			perfect = FALSE;
+		}
+		if (index->slots[pos] == NULL)
+			index->slots[pos] = entry;
+	}
+	return perfect;
+}
+
+static UgEntryIndex*  index_new(const UgEntry* entry0)
+{
+	const UgEntry*  entry;
+	UgEntryIndex*   index;
+	unsigned int    size, count;
+
+	for (count = 0, entry = entry0;  entry->type;  entry++) {
+		if (entry->name)
+			count++;
+	}
+	// keep load factor under 25% so it is easy to find perfect seed.
+	for (size = 8;  size < count * 4;  size *= 2)
+		;
+
+	index = ug_malloc0(sizeof(UgEntryIndex) + sizeof(UgEntry*) * (size - 1));
+	index->entry = entry0;
+	index->mask = size - 1;
+	for (index->seed = 0;  index->seed < INDEX_N_SEEDS;  index->seed++) {
+		if (index_fill(index))
+			return index;
+	}
+	// no perfect seed, use linear probing
+	index->seed = 0;
+	index_fill(index);
+	return index;
+}
+
+// return NULL if UgEntry array was not added.
+static const UgEntryIndex*  index_get(const UgEntry* entry0)
+{
+	const UgEntry*  key;
+	unsigned int    pos, count;
+
+	pos = index_hash_pointer(entry0) & (INDEX_TABLE_SIZE - 1);
+	for (count = 0;  count < INDEX_TABLE_SIZE;  count++) {
+		key = index_load(index_table[pos].entry);
+		if (key == entry0)
+			return index_table[pos].index;
+		if (key == NULL)
+			break;
+		pos = (pos + 1) & (INDEX_TABLE_SIZE - 1);
+	}
+	return NULL;
+}
+
+// caller must lock index_mutex.
+// return slot of 'entry0' or a free slot. return NULL if table is full.
+static UgEntrySlot*  index_slot(const UgEntry* entry0)
+{
+	UgEntrySlot*    slot;
+	UgEntrySlot*    removed = NULL;
+	unsigned int    pos, count;
+
+	pos = index_hash_pointer(entry0) & (INDEX_TABLE_SIZE - 1);
+	for (count = 0;  count < INDEX_TABLE_SIZE;  count++) {
+		slot = index_table + pos;
+		if (slot->entry == entry0)
+			return slot;
+		if (slot->entry == NULL)
+			return (removed) ? removed : slot;
+		if (slot->entry == INDEX_REMOVED && removed == NULL)
+			removed = slot;
+		pos = (pos + 1) & (INDEX_TABLE_SIZE - 1);
+	}
+	return removed;
+}
+
+// caller must lock index_mutex.
+static int  index_add(const UgEntry* entry0)
+{
+	const UgEntry*  entry;
+	UgEntrySlot*    slot;
+
+	slot = index_slot(entry0);
+	if (slot == NULL)
+		return FALSE;
+	if (slot->entry == entry0) {
+		slot->ref_count++;
+		return TRUE;
+	}
+	slot->index = index_new(entry0);
+	slot->ref_count = 1;
+	index_store(slot->entry, entry0);
+	// UgEntry array of member object
+	for (entry = entry0;  entry->type;  entry++) {
+		if (entry->type == UG_ENTRY_OBJECT && entry->param1)
+			index_add(entry->param1);
+	}
+	return TRUE;
+}
+
+// caller must lock index_mutex.
+static void  index_remove(const UgEntry* entry0)
+{
+	const UgEntry*  entry;
+	UgEntrySlot*    slot;
+
+	slot = index_slot(entry0);
+	if (slot == NULL || slot->entry != entry0)
+		return;
+	if (--slot->ref_count > 0)
+		return;
+	index_store(slot->entry, INDEX_REMOVED);
+	ug_free(slot->index);
+	slot->index = NULL;
+	// UgEntry array of member object
+	for (entry = entry0;  entry->type;  entry++) {
+		if (entry->type == UG_ENTRY_OBJECT && entry->param1)
+			index_remove(entry->param1);
+	}
+}
+
+int   ug_entry_index_add(const UgEntry* entry)
+{
+	int  result;
+
+	index_lock();
+	result = index_add(entry);
+	index_unlock();
+	return result;
+}
+
+void  ug_entry_index_remove(const UgEntry* entry)
+{
+	index_lock();
+	index_remove(entry);
+	index_unlock();
+}
+
+// return first entry that match 'name', same as walking UgEntry array.
+static const UgEntry*  index_find(const UgEntryIndex* index, const char* name)
+{
+	const UgEntry*  entry;
+	unsigned int    pos;
+
+	// array element has no name
+	if (name == NULL)
+		return index->any;
+	pos = index_hash(name, index->seed) & index->mask;
+	for (;  (entry = index->slots[pos]) != NULL;  pos = (pos + 1) & index->mask) {
+		if (strcmp(entry->name, name) == 0)
+			break;
+	}
+	if (index->any && (entry == NULL || index->any < entry))
+		return index->any;
+	return entry;
+}
+
+// ----------------------------------------------------------------------------
+
 UgJsonError ug_json_parse_entry(UgJson* json,
                                 const char* name, const char* value,
                                 void* dest, void* entry0)
 {
-	const UgEntry* entry;
-	UgJsonError    error = UG_JSON_ERROR_NONE;
+	const UgEntryIndex* index;
+	const UgEntry*      entry;
+	UgJsonError         error = UG_JSON_ERROR_NONE;
+
+	index = index_get(entry0);
+	if (index)
+		entry = index_find(index, name);
+	else {
+		// UgEntry array was not added to index, walk it.
+		for (entry = entry0;  entry->type;  entry++) {
+			if (entry->name == NULL || (name && strcmp(entry->name, name) == 0))
+				break;
+		}
+		if (entry->type == UG_ENTRY_NONE)
+			entry = NULL;
+	}
 
-	for (entry = entry0;  entry->type;  entry++) {
-		if (entry->name && strcmp(entry->name, name) != 0)
-			continue;
+	if (entry) {
 		// get destination
 		dest = ((char*) dest) + entry->offset;
 
@@ -108,8 +362,12 @@ UgJsonError ug_json_parse_entry(UgJson* json,
 			break;
 
 		case UG_ENTRY_STRING:
-			if (json->type == UG_JSON_STRING)
-				*(char**) dest = ug_strdup(value);
+			if (json->type == UG_JSON_STRING) {
+				if (entry->param1)
+					*(char**) dest = ((UgStrdupFunc)entry->param1)(value);
+				else
+					*(char**) dest = ug_strdup(value);
+			}
 			else if (json->type == UG_JSON_NULL)
 				*(char**) dest = NULL;
 			else
@@ -138,7 +396,6 @@ UgJsonError ug_json_parse_entry(UgJson* json,
 			break;
 		}
 		// End of switch (entry->type)
-		break;
 	}
 
 	// if entry->type != UG_ENTRY_OBJECT or UG_ENTRY_ARRAY
@@ -104,6 +104,8 @@ typedef enum
 	UgEntryType = UG_ENTRY_STRING
 	If you don't want to output anything when string value is NULL,
 	set UG_ENTRY_NO_NULL at UgEntry.param2.
+	UgEntry.param1 pointer to function that copy string, e.g. ug_str_intern().
+	parser use ug_strdup() if it is NULL.
 
 	UgEntryType = UG_ENTRY_OBJECT
 	UgEntry.param1 pointer to UgEntry
@@ -145,6 +147,14 @@ UgJsonError ug_json_parse_entry(UgJson* json,
 // write JSON value by UgEntry
 void  ug_json_write_entry(UgJson* json, void* src, const UgEntry* entry);
 
+// ug_json_parse_entry() walks UgEntry array to find name. If a static array
+// is parsed often, add it to name index before parsing and remove it after no
+// thread parses it. Arrays in UG_ENTRY_OBJECT are added/removed with it.
+// Index is reference counted. ug_entry_index_add() return FALSE if too many
+// arrays were added, parser still walks that array.
+int   ug_entry_index_add(const UgEntry* entry);
+void  ug_entry_index_remove(const UgEntry* entry);
+
 #ifdef __cplusplus
 }
 #endif
@@ -54,6 +54,7 @@
 #include <unistd.h>
 #include <utime.h>       // struct utimbuf
 #include <sys/time.h>
+#include <sys/mman.h>    // mmap(), munmap()
 #endif
 
 // ----------------------------------------------------------------------------
@@ -130,6 +131,26 @@ int  ug_modify_file_time (const char *file_utf8, time_t mod_time)
 }
 #endif
 
+#if defined _WIN32 || defined _WIN64
+int64_t ug_file_get_time (int fd)
+{
+	struct _stat64  st;
+
+	if (_fstat64 (fd, &st) == -1)
+		return -1;
+	return st.st_mtime;
+}
+#else
+int64_t ug_file_get_time (int fd)
+{
+	struct stat  st;
+
+	if (fstat (fd, &st) == -1)
+		return -1;
+	return st.st_mtime;
+}
+#endif
+
 // ----------------------------------------------------------------------------
 // file and directory functions
 
@@ -426,6 +447,69 @@ int  ug_file_copy (const char *src_file_utf8, const char *new_file_utf8)
 }
 #endif	// _WIN32
 
+#if defined _WIN32 || defined _WIN64
+void* ug_file_map (const char* filename_utf8, int64_t* length)
+{
+	HANDLE         file;
+	HANDLE         mapping;
+	LARGE_INTEGER  size;
+	wchar_t*       wfilename;
+	void*          address = NULL;
+
+	wfilename = ug_utf8_to_utf16 (filename_utf8, -1, NULL);
+	if (wfilename == NULL)
+		return NULL;
+	file = CreateFileW (wfilename, GENERIC_READ, FILE_SHARE_READ, NULL,
+	                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	ug_free (wfilename);
+	if (file == INVALID_HANDLE_VALUE)
+		return NULL;
+
+	if (GetFileSizeEx (file, &size) && size.QuadPart > 0) {
+		mapping = CreateFileMappingW (file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping) {
+			address = MapViewOfFile (mapping, FILE_MAP_READ, 0, 0, 0);
+			// view keeps a reference to mapping
+			CloseHandle (mapping);
+		}
+	}
+	CloseHandle (file);
+
+	if (address)
+		*length = size.QuadPart;
+	return address;
+}
+
+void  ug_file_unmap (void* address, int64_t length)
+{
+	UnmapViewOfFile (address);
+}
+#else
+void* ug_file_map (const char* filename_utf8, int64_t* length)
+{
+	void*  address = NULL;
+	int    fd;
+
+	fd = ug_open (filename_utf8, UG_O_RDONLY | UG_O_BINARY, 0);
+	if (fd == -1)
+		return NULL;
+
+	*length = ug_seek (fd, 0, SEEK_END);
+	if (*length > 0) {
+		address = mmap (NULL, (size_t) *length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (address == MAP_FAILED)
+			address = NULL;
+	}
+	ug_close (fd);
+	return address;
+}
+
+void  ug_file_unmap (void* address, int64_t length)
+{
+	munmap (address, (size_t) length);
+}
+#endif	// _WIN32
+
 int  ug_file_get_lines (const char* filename_utf8, UgList* list)
 {
 	UgLink* link;
@@ -51,6 +51,7 @@
 #endif
 
 #include <time.h>
+#include <stdint.h>
 #include <UgList.h>
 
 #ifdef __cplusplus
@@ -86,6 +87,8 @@ const char* ug_dir_read (UgDir* udir);
 
 // Change the modified time of file
 int   ug_modify_file_time (const char *file_utf8, time_t mod_time);
+// return the modified time of opened file, return -1 if error.
+int64_t ug_file_get_time (int fd);
 
 // ----------------------------------------------------------------------------
 // file & directory functions
@@ -114,6 +117,10 @@ int   ug_file_copy (const char *src_file_utf8, const char *dest_file_utf8);
 // return number of lines
 int   ug_file_get_lines (const char* filename_utf8, UgList* list);
 
+// map whole file to memory for reading. return NULL if error or file is empty.
+void* ug_file_map (const char* filename_utf8, int64_t* length);
+void  ug_file_unmap (void* address, int64_t length);
+
 #ifdef __cplusplus
 }
 #endif
@@ -38,11 +38,8 @@
 #include <config.h>
 #endif
 
-#ifdef HAVE_GLIB
-#include <glib.h>    // g_slice_xxx
-#endif
-
 #include <stdlib.h>
+#include <UgSlice.h>
 #include <UgGroupData.h>
 #include <UgJson-custom.h>
 
@@ -52,15 +49,16 @@
 // +-- UgGroupDataInfo
 
 void* ug_type_new(const void* typeinfo)
+{
+	return ug_type_new_in(NULL, typeinfo);
+}
+
+void* ug_type_new_in(UgSlice* slice, const void* typeinfo)
 {
 	UgInitFunc  init;
 	UgType*     type;
 
-#ifdef HAVE_GLIB
-	type = g_slice_alloc0(((UgTypeInfo*)typeinfo)->size);
-#else
-	type = ug_malloc0(((UgTypeInfo*)typeinfo)->size);
-#endif // HAVE_GLIB
+	type = ug_slice_alloc0(slice, ((UgTypeInfo*)typeinfo)->size);
 
 	type->info = typeinfo;
 	init = type->info->init;
@@ -77,11 +75,7 @@ void  ug_type_free(void* type)
 	if (final)
 		final(type);
 
-#ifdef HAVE_GLIB
-	g_slice_free1(((UgType*)type)->info->size, type);
-#else
-	ug_free(type);
-#endif // HAVE_GLIB
+	ug_slice_free1(((UgType*)type)->info->size, type);
 }
 
 void  ug_type_init(void* type)
@@ -118,11 +112,7 @@ void* ug_group_data_copy(void* data)
 		init   = info->init;
 		assign = info->assign;
 		if (assign) {
-#ifdef HAVE_GLIB
-			newone = g_slice_alloc0(info->size);
-#else
-			newone = ug_malloc0(info->size);
-#endif
+			newone = ug_slice_alloc0(NULL, info->size);
 			((UgGroupData*)newone)->info = info;
 			if (init)
 				init(newone);
@@ -39,6 +39,7 @@
 
 #include <stdint.h>     // uintptr_t
 #include <UgEntry.h>
+#include <UgSlice.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -85,6 +86,8 @@ struct UgType
 
 // void*   ug_type_new(const UgTypeInfo* typeinfo);
 void*      ug_type_new(const void* typeinfo);
+// allocate from arena 'slice', see UgSlice.h
+void*      ug_type_new_in(UgSlice* slice, const void* typeinfo);
 void       ug_type_free(void* type);
 void       ug_type_init(void* type);
 void       ug_type_final(void* type);
@@ -100,7 +103,8 @@ void       ug_type_final(void* type);
 #define	UG_GROUP_DATA_INFO_MEMBERS  \
 	UG_TYPE_INFO_MEMBERS;     \
 	UgAssignFunc    assign;   \
-	const UgEntry*  entry
+	const UgEntry*  entry;    \
+	int             slot
 
 struct UgGroupDataInfo
 {
@@ -114,6 +118,7 @@ struct UgGroupDataInfo
 	// ------ UgGroupDataInfo members ------
 	UgAssignFunc    assign;
 	const UgEntry*	entry;
+	int             slot;    // fixed slot in UgData cache space, 0 if none.
  */
 };
 
@@ -126,12 +131,14 @@ struct UgGroupDataInfo
  */
 
 #define	UG_GROUP_DATA_MEMBERS  \
-	const UgGroupDataInfo*  info
+	const UgGroupDataInfo*  info;  \
+	int                     shared
 
 struct UgGroupData
 {
 	UG_GROUP_DATA_MEMBERS;
 //	const UgGroupDataInfo*  info;    // UgType member
+//	int                     shared;  // number of other UgData that share it
 };
 
 // UgGroupData* ug_group_data_new(const UgGroupDataInfo* dinfo);
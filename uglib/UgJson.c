@@ -46,10 +46,24 @@
 #include <limits.h>     // INT_MAX
 #include <stdarg.h>     // va_list, va_start, va_end
 #include <stdio.h>      // vsnprintf
+#include <stdlib.h>     // strtod
+#include <math.h>       // signbit
 // uglib
 #include <UgDefine.h>
 #include <UgJson.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UG_JSON_SSE2            1
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define UG_JSON_AVX2            1
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER) && (defined(UG_JSON_SSE2) || defined(UG_JSON_AVX2))
+#include <intrin.h>             // _BitScanForward
+#endif
+
 #define BUFFER_SIZE             128
 
 #define IGNORE_ERROR_IN_SEPARATOR  1
@@ -99,9 +113,163 @@ enum {
 
 static void  ug_json_call_parser (UgJson* json);
 
+// ----------------------------------------------------------------------------
+// span scanners used by ug_json_parse() to skip or copy runs of bytes.
+// They return length of span that starting at 'cur'.
+
+#if defined(UG_JSON_SSE2) || defined(UG_JSON_AVX2)
+static inline int  lowest_bit (unsigned int mask)
+{
+#ifdef _MSC_VER
+	unsigned long  index;
+
+	_BitScanForward (&index, mask);
+	return (int) index;
+#else
+	return __builtin_ctz (mask);
+#endif
+}
+#endif
+
+// whitespace: ' ', '\t', '\n', '\r'
+static int  span_space (const char* cur, const char* end)
+{
+	const char* beg = cur;
+
+#ifdef UG_JSON_AVX2
+	for (;  end - cur >= 32;  cur += 32) {
+		__m256i  bytes = _mm256_loadu_si256 ((const __m256i*) cur);
+		__m256i  match;
+		unsigned int  mask;
+
+		match = _mm256_or_si256 (
+				_mm256_or_si256 (
+						_mm256_cmpeq_epi8 (bytes, _mm256_set1_epi8 (' ')),
+						_mm256_cmpeq_epi8 (bytes, _mm256_set1_epi8 ('\t'))),
+				_mm256_or_si256 (
+						_mm256_cmpeq_epi8 (bytes, _mm256_set1_epi8 ('\n')),
+						_mm256_cmpeq_epi8 (bytes, _mm256_set1_epi8 ('\r'))));
+		mask = ~(unsigned int) _mm256_movemask_epi8 (match);
+		if (mask)
+			return (int) (cur - beg) + lowest_bit (mask);
+	}
+#endif
+#ifdef UG_JSON_SSE2
+	for (;  end - cur >= 16;  cur += 16) {
+		__m128i  bytes = _mm_loadu_si128 ((const __m128i*) cur);
+		__m128i  match;
+		unsigned int  mask;
+
+		match = _mm_or_si128 (
+				_mm_or_si128 (
+						_mm_cmpeq_epi8 (bytes, _mm_set1_epi8 (' ')),
+						_mm_cmpeq_epi8 (bytes, _mm_set1_epi8 ('\t'))),
+				_mm_or_si128 (
+						_mm_cmpeq_epi8 (bytes, _mm_set1_epi8 ('\n')),
+						_mm_cmpeq_epi8 (bytes, _mm_set1_epi8 ('\r'))));
+		mask = ~(unsigned int) _mm_movemask_epi8 (match) & 0xFFFF;
+		if (mask)
+			return (int) (cur - beg) + lowest_bit (mask);
+	}
+#endif
+	for (;  cur < end;  cur++) {
+		if (*cur != ' ' && *cur != '\t' && *cur != '\n' && *cur != '\r')
+			break;
+	}
+	return (int) (cur - beg);
+}
+
+// string body: stop at '\"' or '\\'
+static int  span_string (const char* cur, const char* end)
+{
+	const char* beg = cur;
+
+#ifdef UG_JSON_AVX2
+	for (;  end - cur >= 32;  cur += 32) {
+		__m256i  bytes = _mm256_loadu_si256 ((const __m256i*) cur);
+		unsigned int  mask;
+
+		mask = (unsigned int) _mm256_movemask_epi8 (_mm256_or_si256 (
+				_mm256_cmpeq_epi8 (bytes, _mm256_set1_epi8 ('\"')),
+				_mm256_cmpeq_epi8 (bytes, _mm256_set1_epi8 ('\\'))));
+		if (mask)
+			return (int) (cur - beg) + lowest_bit (mask);
+	}
+#endif
+#ifdef UG_JSON_SSE2
+	for (;  end - cur >= 16;  cur += 16) {
+		__m128i  bytes = _mm_loadu_si128 ((const __m128i*) cur);
+		unsigned int  mask;
+
+		mask = (unsigned int) _mm_movemask_epi8 (_mm_or_si128 (
+				_mm_cmpeq_epi8 (bytes, _mm_set1_epi8 ('\"')),
+				_mm_cmpeq_epi8 (bytes, _mm_set1_epi8 ('\\'))));
+		if (mask)
+			return (int) (cur - beg) + lowest_bit (mask);
+	}
+#endif
+	for (;  cur < end;  cur++) {
+		if (*cur == '\"' || *cur == '\\')
+			break;
+	}
+	return (int) (cur - beg);
+}
+
+// digits: '0' - '9'
+static int  span_digit (const char* cur, const char* end)
+{
+	const char* beg = cur;
+
+#ifdef UG_JSON_AVX2
+	for (;  end - cur >= 32;  cur += 32) {
+		__m256i  bytes = _mm256_loadu_si256 ((const __m256i*) cur);
+		unsigned int  mask;
+
+		// signed compare, bytes >= 0x80 are negative and not digit.
+		mask = ~(unsigned int) _mm256_movemask_epi8 (_mm256_and_si256 (
+				_mm256_cmpgt_epi8 (bytes, _mm256_set1_epi8 ('0' - 1)),
+				_mm256_cmpgt_epi8 (_mm256_set1_epi8 ('9' + 1), bytes)));
+		if (mask)
+			return (int) (cur - beg) + lowest_bit (mask);
+	}
+#endif
+#ifdef UG_JSON_SSE2
+	for (;  end - cur >= 16;  cur += 16) {
+		__m128i  bytes = _mm_loadu_si128 ((const __m128i*) cur);
+		unsigned int  mask;
+
+		mask = ~(unsigned int) _mm_movemask_epi8 (_mm_and_si128 (
+				_mm_cmpgt_epi8 (bytes, _mm_set1_epi8 ('0' - 1)),
+				_mm_cmplt_epi8 (bytes, _mm_set1_epi8 ('9' + 1)))) & 0xFFFF;
+		if (mask)
+			return (int) (cur - beg) + lowest_bit (mask);
+	}
+#endif
+	for (;  cur < end;  cur++) {
+		if (*cur < '0' || *cur > '9')
+			break;
+	}
+	return (int) (cur - beg);
+}
+
+// copy 'length' bytes to json->buf and keep one byte free for next loop.
+static void  buf_append (UgJson* json, const char* cur, int length)
+{
+	if (json->buf.allocated <= json->buf.length + length) {
+		do {
+			json->buf.allocated *= 2;
+		} while (json->buf.allocated <= json->buf.length + length);
+		json->buf.at = ug_realloc (json->buf.at,
+				json->buf.allocated * sizeof (char));
+	}
+	memcpy (json->buf.at + json->buf.length, cur, length);
+	json->buf.length += length;
+}
+
 void  ug_json_begin_parse (UgJson* json)
 {
-	// reset state
+	// reset state, stack may have parsers of previous failed parsing.
+	json->stack.length = 0;
 	json->count = 0;
 	json->colon = 0;
 	json->numberPoint = 0;
@@ -209,6 +377,7 @@ UgJsonError  ug_json_parse (UgJson* json, const char* string, int len)
 	const char* cur;
 	const char* end;
 	char        vchar;
+	int         length;
 
 	if (len == -1)
 		len = strlen (string);
@@ -232,6 +401,7 @@ TopLevelSwitch:
 			case '\t':
 			case '\n':
 			case '\r':
+				cur += span_space (cur + 1, end);
 				continue;
 //				break;
 
@@ -315,6 +485,7 @@ TopLevelSwitch:
 			case '\t':
 			case '\n':
 			case '\r':
+				cur += span_space (cur + 1, end);
 				continue;
 //				break;
 
@@ -371,6 +542,7 @@ TopLevelSwitch:
 			case '\t':
 			case '\n':
 			case '\r':
+				cur += span_space (cur + 1, end);
 				continue;
 //				break;
 
@@ -438,7 +610,10 @@ TopLevelSwitch:
 //				break;
 
 			default:
-				json->buf.at[json->buf.length++] = vchar;
+				// copy string body until '\"' or '\\'
+				length = span_string (cur, end);
+				buf_append (json, cur, length);
+				cur += length - 1;
 				continue;
 //				break;
 			}
@@ -589,7 +764,12 @@ TopLevelSwitch:
 					json->buf.at[json->buf.length++] = 0;
 					goto TopLevelSwitch;
 				}
-				break;
+				// copy run of digits
+				length = span_digit (cur, end);
+				buf_append (json, cur, length);
+				cur += length - 1;
+				continue;
+//				break;
 			}
 			json->buf.at[json->buf.length++] = vchar;
 			break;
@@ -715,7 +895,7 @@ void  ug_json_end_write (UgJson* json)
 
 	// UgJson.stack.at[0] = UgBuffer
 	buffer = json->stack.at[0];
-	if (buffer->more != ug_buffer_expand)
+	if (buffer->more != ug_buffer_expand && buffer->more != ug_buffer_chain_expand)
 		buffer->more (buffer);
 	// clear stack
 	json->stack.length = 0;
@@ -879,23 +1059,9 @@ void  ug_json_write_number (UgJson* json, const char* format, ...)
 	json->colon = 0;
 }
 
-void  ug_json_write_string (UgJson* json, const char* string)
+// ',' and indent before value
+static void  write_prefix (UgJson* json, UgBuffer* buffer)
 {
-	static const uint8_t  utf8Limits[] = {0xC0, 0xE0, 0xF0, 0xF8, 0xFC};
-	static const uint8_t  hexTable[]   = {"0123456789ABCDEF"};
-	uint8_t               ch;
-	int                   count;
-	uint32_t              value;
-	UgBuffer*             buffer;
-
-	if (string == NULL) {
-		ug_json_write_null (json);
-		return;
-	}
-
-	// UgJson.stack.at[0] = UgBuffer
-	buffer = json->stack.at[0];
-
 	if (json->type < UG_JSON_N_TYPE)
 		ug_buffer_write_char (buffer, ',');
 	// UgJson.state = UgJsonFormat
@@ -906,48 +1072,215 @@ void  ug_json_write_string (UgJson* json, const char* string)
 //		ug_buffer_fill (buffer, ' ', json->index[0]);
 		ug_buffer_fill (buffer, '\t', json->index[0]);
 	}
+}
 
-	ug_buffer_write_char (buffer, '\"');
+static const char  digit_pairs[] =
+	"00010203040506070809" "10111213141516171819"
+	"20212223242526272829" "30313233343536373839"
+	"40414243444546474849" "50515253545556575859"
+	"60616263646566676869" "70717273747576777879"
+	"80818283848586878889" "90919293949596979899";
 
-	while ((ch = string[0])) {
-		string++;
-		if (ch < 0x80 || (json->state & UG_JSON_FORMAT_UTF8)) {
-			switch (ch) {
-			case '\"':
-				ug_buffer_write (buffer, "\\\"", 2);
-				break;
+// write digits backward from 'end', return beginning of digits.
+static char*  format_uint64 (char* end, uint64_t value)
+{
+	const char*  pair;
 
-			case '\\':
-				ug_buffer_write (buffer, "\\\\", 2);
-				break;
+	while (value >= 100) {
+		pair = digit_pairs + (value % 100) * 2;
+		value /= 100;
+		*--end = pair[1];
+		*--end = pair[0];
+	}
+	if (value >= 10) {
+		pair = digit_pairs + value * 2;
+		*--end = pair[1];
+		*--end = pair[0];
+	}
+	else
+		*--end = (char) ('0' + value);
+	return end;
+}
 
-			case '/':
-				ug_buffer_write (buffer, "\\/", 2);
-				break;
+void  ug_json_write_int64 (UgJson* json, int64_t value)
+{
+	UgBuffer* buffer;
+	char      string[24];
+	char*     beg;
 
-			case '\b':
-				ug_buffer_write (buffer, "\\b", 2);
-				break;
+	// UgJson.stack.at[0] = UgBuffer
+	buffer = json->stack.at[0];
+	write_prefix (json, buffer);
 
-			case '\f':
-				ug_buffer_write (buffer, "\\f", 2);
-				break;
+	if (value < 0) {
+		beg = format_uint64 (string + sizeof (string), 0 - (uint64_t) value);
+		*--beg = '-';
+	}
+	else
+		beg = format_uint64 (string + sizeof (string), (uint64_t) value);
+	ug_buffer_write_data (buffer, beg, (int) (string + sizeof (string) - beg));
 
-			case '\n':
-				ug_buffer_write (buffer, "\\n", 2);
-				break;
+	json->type = UG_JSON_NUMBER;
+	json->colon = 0;
+}
 
-			case '\r':
-				ug_buffer_write (buffer, "\\r", 2);
-				break;
+void  ug_json_write_uint64 (UgJson* json, uint64_t value)
+{
+	UgBuffer* buffer;
+	char      string[24];
+	char*     beg;
 
-			case '\t':
-				ug_buffer_write (buffer, "\\t", 2);
+	// UgJson.stack.at[0] = UgBuffer
+	buffer = json->stack.at[0];
+	write_prefix (json, buffer);
+
+	beg = format_uint64 (string + sizeof (string), value);
+	ug_buffer_write_data (buffer, beg, (int) (string + sizeof (string) - beg));
+
+	json->type = UG_JSON_NUMBER;
+	json->colon = 0;
+}
+
+void  ug_json_write_double (UgJson* json, double value)
+{
+	// powers of 10 that double can represent exactly
+	static const double  pow10_double[] = {
+		1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,
+		1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+	};
+	static const uint64_t  pow10_uint64[] = {
+		1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+		10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+		100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+		100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+		100000000000000000ULL,
+	};
+	UgBuffer* buffer;
+	char      string[48];
+	char*     beg;
+	char*     end;
+	double    absolute, scaled = 0;
+	uint64_t  digits = 0;
+	int       count, point;
+
+	// UgJson.stack.at[0] = UgBuffer
+	buffer = json->stack.at[0];
+	write_prefix (json, buffer);
+
+	// Find the fewest decimal places 'point' that digits / 10^point gives
+	// back 'value'. digits < 2^53 and 10^point are exact, so the division is
+	// rounded just like the parser (strtod) rounds the written string.
+	absolute = (value < 0) ? -value : value;
+	for (point = 0;  point < (int) (sizeof (pow10_double) / sizeof (double));  point++) {
+		scaled = absolute * pow10_double[point];
+		if (!(scaled < 9007199254740992.0))  // 2^53, infinity, or NaN
+			break;
+		// 'scaled' is rounded, so the last digit may be off by one.
+		digits = (uint64_t) (scaled + 0.5);
+		if ((double) digits / pow10_double[point] == absolute)
+			break;
+		if ((double) (digits + 1) / pow10_double[point] == absolute) {
+			digits++;
+			break;
+		}
+		if (digits && (double) (digits - 1) / pow10_double[point] == absolute) {
+			digits--;
+			break;
+		}
+	}
+
+	if (point < (int) (sizeof (pow10_double) / sizeof (double)) &&
+	    scaled < 9007199254740992.0)
+	{
+		end = string + sizeof (string);
+		if (point > 0) {
+			beg = format_uint64 (end, digits % pow10_uint64[point]);
+			// fill leading zero of fraction
+			for (count = (int) (end - beg);  count < point;  count++)
+				*--beg = '0';
+			*--beg = '.';
+			end = beg;
+		}
+		beg = format_uint64 (end, digits / pow10_uint64[point]);
+		// keep sign of -0
+		if (signbit (value))
+			*--beg = '-';
+		ug_buffer_write_data (buffer, beg,
+				(int) (string + sizeof (string) - beg));
+	}
+	else {
+		// 17 significant digits, huge, tiny, or not a number.
+		for (point = 15;  point < 17;  point++) {
+			count = snprintf (string, sizeof (string), "%.*g", point, value);
+			if (strtod (string, NULL) == value)
 				break;
+		}
+		if (point == 17)
+			count = snprintf (string, sizeof (string), "%.17g", value);
+		ug_buffer_write_data (buffer, string, count);
+	}
 
-			default:
-				ug_buffer_write_char (buffer, ch);
+	json->type = UG_JSON_NUMBER;
+	json->colon = 0;
+}
+
+void  ug_json_write_string (UgJson* json, const char* string)
+{
+	static const uint8_t  utf8Limits[] = {0xC0, 0xE0, 0xF0, 0xF8, 0xFC};
+	static const uint8_t  hexTable[]   = {"0123456789ABCDEF"};
+	// character after '\\' if ASCII character must be escaped.
+	// 'u' is control character that written as "\u00XX".
+	static const char     escapeTable[128] = {
+		 0, 'u','u','u','u','u','u','u','b','t','n','u','f','r','u','u',
+		'u','u','u','u','u','u','u','u','u','u','u','u','u','u','u','u',
+		 0,  0,'\"', 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, '/',
+		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,'\\', 0,  0,  0,
+		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+	};
+	const char*           cur;
+	uint8_t               ch;
+	int                   count;
+	uint32_t              value;
+	UgBuffer*             buffer;
+
+	if (string == NULL) {
+		ug_json_write_null (json);
+		return;
+	}
+
+	// UgJson.stack.at[0] = UgBuffer
+	buffer = json->stack.at[0];
+	write_prefix (json, buffer);
+
+	ug_buffer_write_char (buffer, '\"');
+
+	for (;;) {
+		// copy run of characters that don't need escape at once
+		for (cur = string;  (ch = cur[0]);  cur++) {
+			if (ch < 0x80) {
+				if (escapeTable[ch])
+					break;
+			}
+			else if ((json->state & UG_JSON_FORMAT_UTF8) == 0)
 				break;
+		}
+		if (cur > string)
+			ug_buffer_write_data (buffer, string, (int) (cur - string));
+		if (ch == 0)
+			break;
+		string = cur + 1;
+
+		if (ch < 0x80) {
+			ug_buffer_write_char (buffer, '\\');
+			ug_buffer_write_char (buffer, escapeTable[ch]);
+			if (escapeTable[ch] == 'u') {
+				ug_buffer_write_char (buffer, '0');
+				ug_buffer_write_char (buffer, '0');
+				ug_buffer_write_char (buffer, hexTable[ch >> 4]);
+				ug_buffer_write_char (buffer, hexTable[ch & 15]);
 			}
 			continue;
 		}
@@ -966,8 +1299,10 @@ void  ug_json_write_string (UgJson* json, const char* string)
 			uint8_t  ch2;
 
 			ch2 = *string++;
-			if (ch2 == 0)
+			if (ch2 == 0) {
+				string--;    // don't pass null-terminated
 				break;
+			}
 			if (ch2 < 0x80 || ch2 >= 0xC0)
 				break;
 			value <<= 6;
@@ -183,21 +183,17 @@ void    ug_json_write_bool   (UgJson* json, int value);
 void    ug_json_write_number (UgJson* json, const char* format, ...);
 void    ug_json_write_string (UgJson* json, const char* Cstring);
 
+// These number writers don't use printf().
+// ug_json_write_double() write shortest string that can be parsed back to
+// the same value.
+void    ug_json_write_int64  (UgJson* json, int64_t  value);
+void    ug_json_write_uint64 (UgJson* json, uint64_t value);
+void    ug_json_write_double (UgJson* json, double   value);
+
 // void ug_json_write_int    (UgJson* json, int value);
 // void ug_json_write_uint   (UgJson* json, unsigned int value);
-// void ug_json_write_int64  (UgJson* json, int64_t  value);
-// void ug_json_write_uint64 (UgJson* json, uint64_t value);
-// void ug_json_write_double (UgJson* json, double   value);
-#define ug_json_write_int(json, value)      ug_json_write_number (json, "%d", value)
-#define ug_json_write_uint(json, value)     ug_json_write_number (json, "%u", value)
-#define ug_json_write_double(json, value)   ug_json_write_number (json, "%f", value)
-#if defined (_MSC_VER) || defined (__MINGW32__)
-#define ug_json_write_int64(json, value)    ug_json_write_number (json, "%I64d", value)
-#define ug_json_write_uint64(json, value)   ug_json_write_number (json, "%I64u", value)
-#else
-#define ug_json_write_int64(json, value)    ug_json_write_number (json, "%lld", (long long) (value))
-#define ug_json_write_uint64(json, value)   ug_json_write_number (json, "%llu", (unsigned long long) (value))
-#endif
+#define ug_json_write_int(json, value)      ug_json_write_int64 (json, (int64_t) (value))
+#define ug_json_write_uint(json, value)     ug_json_write_uint64 (json, (uint64_t) (value))
 
 #ifdef __cplusplus
 }
@@ -38,7 +38,10 @@
 #include <UgDefine.h>
 #include <UgJsonFile.h>
 
-static int  buffer_to_fd (UgBuffer* buffer);
+static int  chain_to_fd (UgBufferChain* chain);
+
+// number of blocks that flushed by one writev()
+#define FLUSH_BLOCKS    16
 
 UgJsonFile*  ug_json_file_new (int buffer_size)
 {
@@ -103,12 +106,13 @@ int   ug_json_file_begin_parse_fd (UgJsonFile* jfile, int fd)
 int   ug_json_file_begin_write_fd (UgJsonFile* jfile, int fd, UgJsonFormat format)
 {
 	jfile->fd = fd;
-	// init UgBuffer for writer
-	ug_buffer_init_external (&jfile->buffer, jfile->bytes, jfile->n_bytes);
-	jfile->buffer.data = (void*)(uintptr_t) jfile->fd;
-	jfile->buffer.more = buffer_to_fd;
+	// init UgBufferChain for writer
+	ug_buffer_chain_init (&jfile->chain, jfile->n_bytes);
+	jfile->chain.data = (void*)(uintptr_t) jfile->fd;
+	jfile->chain.flush = chain_to_fd;
+	jfile->chain.limit = FLUSH_BLOCKS;
 	// ready to write
-	ug_json_begin_write (&jfile->json, format, &jfile->buffer);
+	ug_json_begin_write (&jfile->json, format, &jfile->chain.buffer);
 	return TRUE;
 }
 
@@ -134,8 +138,9 @@ exit:
 void  ug_json_file_end_write (UgJsonFile* jfile)
 {
 	ug_json_end_write (&jfile->json);
-	ug_buffer_clear (&jfile->buffer, FALSE);
-	ug_write (jfile->fd, "\n\n", 2);
+	ug_buffer_write (&jfile->chain.buffer, "\n\n", 2);
+	ug_buffer_chain_write_fd (&jfile->chain, jfile->fd);
+	ug_buffer_chain_final (&jfile->chain);
 
 	// close() doesn't call fsync()
 	// If you want to avoid delayed write, call fsync() before close()
@@ -148,15 +153,13 @@ void  ug_json_file_end_write (UgJsonFile* jfile)
 // ----------------------------------------------------------------------------
 // static function for ug_json_file_save
 
-// UgBufferFunc
-static int  buffer_to_fd (UgBuffer* buffer)
+// UgBufferChainFunc
+static int  chain_to_fd (UgBufferChain* chain)
 {
 	int     fd;
 
-	fd = (uintptr_t)buffer->data;
-	ug_write (fd, buffer->beg, ug_buffer_length (buffer));
-	buffer->cur = buffer->beg;
-	return 0;
+	fd = (uintptr_t)chain->data;
+	return ug_buffer_chain_write_fd (chain, fd);
 }
 
 
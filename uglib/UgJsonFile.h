@@ -52,7 +52,7 @@ typedef struct UgJsonFile            UgJsonFile;
 struct UgJsonFile
 {
 	UgJson    json;
-	UgBuffer  buffer;
+	UgBufferChain  chain;
 	int       fd;
 	int       n_bytes;
 	char      bytes[1];
@@ -103,10 +103,24 @@ void  ug_jsonrpc_object_free(UgJsonrpcObject* jobj)
 	// check NULL for uget_aria2_unref()
 	if (jobj) {
 		ug_jsonrpc_object_clear(jobj);
+		if (jobj->arena)
+			ug_arena_free(jobj->arena);
 		ug_free(jobj);
 	}
 }
 
+// value that parsed by ug_json_parse_value_arena() is released with arena.
+static void  ug_jsonrpc_value_clear(UgValue* value, uint8_t* in_arena)
+{
+	if (*in_arena) {
+		*in_arena = FALSE;
+		value->name = NULL;
+		value->type = UG_VALUE_NONE;
+	}
+	else
+		ug_value_clear(value);
+}
+
 void  ug_jsonrpc_object_init(UgJsonrpcObject* jobj)
 {
 	memset(jobj, 0, sizeof(UgJsonrpcObject));
@@ -120,17 +134,21 @@ void  ug_jsonrpc_object_clear(UgJsonrpcObject* jobj)
 //	ug_free(jobj->jsonrpc);
 //	jobj->jsonrpc = NULL;
 	// id
-	ug_value_clear(&jobj->id);
+	ug_jsonrpc_value_clear(&jobj->id, &jobj->in_arena.id);
 	// method
 	ug_free(jobj->method);
 	jobj->method = NULL;
 	jobj->method_static = NULL;
 	// params
 	ug_value_clear(&jobj->params);
+	jobj->result_parser.func = NULL;
 	// result
-	ug_value_clear(&jobj->result);
+	ug_jsonrpc_value_clear(&jobj->result, &jobj->in_arena.result);
 	// error
 	ug_jsonrpc_error_clear(&jobj->error);
+	// arena
+	if (jobj->arena)
+		ug_arena_reset(jobj->arena);
 }
 
 void  ug_jsonrpc_object_clear_request(UgJsonrpcObject* jobj)
@@ -139,11 +157,12 @@ void  ug_jsonrpc_object_clear_request(UgJsonrpcObject* jobj)
 	jobj->method = NULL;
 	jobj->method_static = NULL;
 	ug_value_clear(&jobj->params);
+	jobj->result_parser.func = NULL;
 }
 
 void  ug_jsonrpc_object_clear_response(UgJsonrpcObject* jobj)
 {
-	ug_value_clear(&jobj->result);
+	ug_jsonrpc_value_clear(&jobj->result, &jobj->in_arena.result);
 	ug_jsonrpc_error_clear(&jobj->error);
 }
 
@@ -225,7 +244,9 @@ UgJsonrpcObject*  ug_jsonrpc_array_find(UgJsonrpcArray* joarray, UgValue* id, in
 	}
 	else if (id->type == UG_VALUE_STRING) {
 		for (;  cur < end;  cur++) {
-			if (cur[0]->id.type == UG_VALUE_STRING &&
+			if (cur[0] != NULL &&
+			    cur[0]->id.type == UG_VALUE_STRING &&
+			    cur[0]->id.c.string && id->c.string &&
 			    strcmp(cur[0]->id.c.string, id->c.string) == 0)
 			{
 				result = *cur;
@@ -248,12 +269,49 @@ UgJsonrpcObject*  ug_jsonrpc_array_alloc(UgJsonrpcArray* joarray)
 	return *jobj;
 }
 
+UgJsonError  ug_json_parse_rpc_object(UgJson* json,
+                                      const char* name, const char* value,
+                                      void* jrobject, void* requests)
+{
+	UgJsonrpcObject*  object;
+	UgJsonrpcObject*  request;
+
+	object = (UgJsonrpcObject*) jrobject;
+	if (requests && name && object->id.type != UG_VALUE_NONE &&
+	    strcmp(name, "result") == 0)
+	{
+		request = ug_jsonrpc_array_find(requests, &object->id, NULL);
+		if (request && request->result_parser.func) {
+			return request->result_parser.func(json, name, value,
+					request->result_parser.data,
+					request->result_parser.data2);
+		}
+	}
+	if (object->arena && name) {
+		if (strcmp(name, "result") == 0) {
+			ug_jsonrpc_value_clear(&object->result, &object->in_arena.result);
+			object->in_arena.result = TRUE;
+			return ug_json_parse_value_arena(json, name, value,
+					&object->result, object->arena);
+		}
+		if (strcmp(name, "id") == 0) {
+			ug_jsonrpc_value_clear(&object->id, &object->in_arena.id);
+			object->in_arena.id = TRUE;
+			return ug_json_parse_value_arena(json, name, value,
+					&object->id, object->arena);
+		}
+	}
+	return ug_json_parse_entry(json, name, value,
+	                           object, (void*)UgJsonrpcObjectEntry);
+}
+
 UgJsonError  ug_json_parse_rpc_array(UgJson* json,
                                      const char* name, const char* value,
-                                     void* jrarray, void* none)
+                                     void* jrarray, void* jsonrpc)
 {
+	UgJsonrpc*        jrpc = jsonrpc;
 	UgJsonrpcArray*   array;
-	UgJsonrpcObject*  object;
+	UgJsonrpcObject*  object = NULL;
 
 	array = (UgJsonrpcArray*) jrarray;
 	if (json->type != UG_JSON_OBJECT) {
@@ -262,9 +320,14 @@ UgJsonError  ug_json_parse_rpc_array(UgJson* json,
 		return UG_JSON_ERROR_RPC_INVALID;
 	}
 
-	object = ug_jsonrpc_array_alloc(array);
-	ug_json_push(json, ug_json_parse_entry,
-	             object, (void*)UgJsonrpcObjectEntry);
+	if (jrpc) {
+		while (object == NULL && jrpc->batch.filled < array->length)
+			object = array->at[jrpc->batch.filled++];
+	}
+	if (object == NULL)
+		object = ug_jsonrpc_array_alloc(array);
+	ug_json_push(json, ug_json_parse_rpc_object,
+	             object, (jrpc) ? jrpc->batch.request : NULL);
 	return UG_JSON_ERROR_NONE;
 }
 
@@ -295,6 +358,8 @@ void  ug_jsonrpc_init(UgJsonrpc* jrpc, UgJson* json, UgBuffer* buffer)
 	jrpc->buffer = buffer;
 	jrpc->data.id.previous = 0;
 	jrpc->data.id.current = 0;
+	jrpc->batch.request = NULL;
+	jrpc->batch.filled = 0;
 }
 
 void  ug_jsonrpc_clear(UgJsonrpc* jrpc)
@@ -304,10 +369,22 @@ void  ug_jsonrpc_clear(UgJsonrpc* jrpc)
 // ------------------------------------
 // client API : set response == NULL if this is notify request
 
+// index large objects in "result" after it was parsed into arena.
+static void  ug_jsonrpc_index_result(UgJsonrpcObject** cur, int length)
+{
+	UgJsonrpcObject** end;
+
+	for (end = cur + length;  cur < end;  cur++) {
+		if (cur[0] && cur[0]->in_arena.result)
+			ug_value_index_arena(&cur[0]->result, cur[0]->arena);
+	}
+}
+
 int  ug_jsonrpc_call(UgJsonrpc* jrpc,
                      UgJsonrpcObject* request,
                      UgJsonrpcObject* response)
 {
+	UgJsonrpcArray  requests;
 	int    n;
 
 //	if (jrpc->send.func == NULL || jrpc->receive.func == NULL)
@@ -318,7 +395,7 @@ int  ug_jsonrpc_call(UgJsonrpc* jrpc,
 	ug_json_begin_write(jrpc->json, 0, jrpc->buffer);
 	// notify does NOT have id
 	if (request->id.type != UG_VALUE_NONE)
-		ug_value_clear(&request->id);
+		ug_jsonrpc_value_clear(&request->id, &request->in_arena.id);
 	if (response) {
 		request->id.type = UG_VALUE_INT;
 		request->id.c.integer = jrpc->data.id.current++;
@@ -338,8 +415,13 @@ int  ug_jsonrpc_call(UgJsonrpc* jrpc,
 		             NULL, NULL);
 	}
 	else {
-		ug_json_push(jrpc->json, ug_json_parse_entry,
-		             response, (void*)UgJsonrpcObjectEntry);
+		// array that has only one request for ug_json_parse_rpc_object()
+		requests.at = &request;
+		requests.length = 1;
+		requests.allocated = 1;
+		requests.element_size = sizeof(UgJsonrpcObject*);
+		ug_json_push(jrpc->json, ug_json_parse_rpc_object,
+		             response, &requests);
 		ug_json_push(jrpc->json, ug_json_parse_object, NULL, NULL);
 	}
 	// send request
@@ -360,6 +442,7 @@ int  ug_jsonrpc_call(UgJsonrpc* jrpc,
 	if (n < 0 || jrpc->error == 0)
 		jrpc->error = n;
 	// parser --- end ---
+	ug_jsonrpc_index_result(&response, 1);
 
 	return 0;   // no error
 }
@@ -388,7 +471,7 @@ int  ug_jsonrpc_call_batch(UgJsonrpc* jrpc,
 			continue;
 		// notify does NOT have id
 		if (cur[0]->id.type != UG_VALUE_NONE) {
-			ug_value_clear(&cur[0]->id);
+			ug_jsonrpc_value_clear(&cur[0]->id, &cur[0]->in_arena.id);
 			cur[0]->id.type = UG_VALUE_INT;
 			cur[0]->id.c.integer = jrpc->data.id.current++;
 		}
@@ -407,7 +490,9 @@ int  ug_jsonrpc_call_batch(UgJsonrpc* jrpc,
 	if (response == NULL)
 		ug_json_push(jrpc->json, ug_json_parse_unknown, NULL, NULL);
 	else {
-		ug_json_push(jrpc->json, ug_json_parse_rpc_array, response, NULL);
+		jrpc->batch.request = request;
+		jrpc->batch.filled = 0;
+		ug_json_push(jrpc->json, ug_json_parse_rpc_array, response, jrpc);
 		ug_json_push(jrpc->json, ug_json_parse_array, NULL, NULL);
 	}
 
@@ -429,6 +514,8 @@ int  ug_jsonrpc_call_batch(UgJsonrpc* jrpc,
 	if (n < 0 || jrpc->error == 0)
 		jrpc->error = n;
 	// parser --- end ---
+	if (response)
+		ug_jsonrpc_index_result(response->at, response->length);
 
 	return 0;   // no error
 }
@@ -38,6 +38,7 @@
 #define UG_JSONRPC_H
 
 #include <UgArray.h>
+#include <UgArena.h>
 #include <UgJson.h>
 #include <UgValue.h>
 #include <UgEntry.h>
@@ -93,12 +94,28 @@ struct UgJsonrpcObject
 	const char*  method_static;
 	// This member MAY be omitted.
 	UgValue      params;
+	// If func is not NULL, "result" of response is parsed by it instead of
+	// UgValue. It is used if "id" is before "result" in response.
+	struct {
+		UgJsonParseFunc  func;
+		void*            data;
+		void*            data2;
+	} result_parser;
 
 	// response
 	// This member MUST NOT exist if there was an error.
 	UgValue         result;
 	// This member MUST NOT exist if there was no error.
 	UgJsonrpcError  error;
+
+	// If it is not NULL, "id" and "result" of response are allocated from it
+	// and ug_jsonrpc_object_clear() reset it. It is freed with object.
+	UgArena*        arena;
+	// TRUE if "id" or "result" is allocated from arena by parser.
+	struct {
+		uint8_t     id;
+		uint8_t     result;
+	} in_arena;
 };
 
 UgJsonrpcObject* ug_jsonrpc_object_new(void);
@@ -132,9 +149,18 @@ UgJsonrpcObject*  ug_jsonrpc_array_find(UgJsonrpcArray* joarray, UgValue* id, in
 UgJsonrpcObject*  ug_jsonrpc_array_alloc(UgJsonrpcArray* joarray);
 
 // ------------------------------------
+// parser for response object, it use UgJsonrpcObject.arena if possible.
+// If 'requests' is not NULL, find request by "id" and use it's result_parser.
+// param requests: UgJsonrpcArray*
+UgJsonError  ug_json_parse_rpc_object(UgJson* json,
+                                      const char* name, const char* value,
+                                      void* jrobject, void* requests);
+// If 'jsonrpc' is not NULL, objects that already in array are filled from
+// index jsonrpc->batch.filled before new objects are added to array.
+// param jsonrpc: UgJsonrpc*
 UgJsonError  ug_json_parse_rpc_array(UgJson* json,
                                      const char* name, const char* value,
-                                     void* jrarray, void* none);
+                                     void* jrarray, void* jsonrpc);
 // param noArrayIfPossible: TRUE or FALSE
 void         ug_json_write_rpc_array(UgJson* json, UgJsonrpcArray* objects,
                                      int  noArrayIfPossible);
@@ -183,6 +209,12 @@ struct  UgJsonrpc
 			UgJsonrpcArray*   array;
 		} request;
 	} data;
+
+	// client: batch that is parsing by ug_json_parse_rpc_array()
+	struct {
+		UgJsonrpcArray*  request;
+		int              filled;
+	} batch;
 };
 
 void  ug_jsonrpc_init(UgJsonrpc* jrpc, UgJson* json, UgBuffer* buffer);
@@ -196,6 +228,7 @@ int  ug_jsonrpc_call(UgJsonrpc* jrpc,
                      UgJsonrpcObject* request,
                      UgJsonrpcObject* response);
 
+// objects that already in 'response' are filled before new objects are added.
 int  ug_jsonrpc_call_batch(UgJsonrpc* jrpc,
                            UgJsonrpcArray* request,
                            UgJsonrpcArray* response);
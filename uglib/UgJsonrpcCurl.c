@@ -50,9 +50,9 @@ void  ug_jsonrpc_curl_init (UgJsonrpcCurl* jrcurl)
 	}
 	global_ref_count++;
 
-	ug_buffer_init (&jrcurl->buffer, 4096);
+	ug_buffer_chain_init (&jrcurl->chain, 4096);
 	ug_json_init (&jrcurl->json);
-	ug_jsonrpc_init (&jrcurl->rpc, &jrcurl->json, &jrcurl->buffer);
+	ug_jsonrpc_init (&jrcurl->rpc, &jrcurl->json, &jrcurl->chain.buffer);
 	jrcurl->url = NULL;
 
 	// libcurl
@@ -60,6 +60,8 @@ void  ug_jsonrpc_curl_init (UgJsonrpcCurl* jrcurl)
 	jrcurl->slist = NULL;
 	jrcurl->slist = curl_slist_append (jrcurl->slist,
 			"Content-Type: application/json-rpc; charset=utf-8");
+	// request body is read from chain, don't wait for "100 Continue"
+	jrcurl->slist = curl_slist_append (jrcurl->slist, "Expect:");
 
 	jrcurl->rpc.send.func = (UgJsonrpcFunc) ug_jsonrpc_curl_send;
 	jrcurl->rpc.send.data = jrcurl;
@@ -76,7 +78,7 @@ void  ug_jsonrpc_curl_final (UgJsonrpcCurl* jrcurl)
 
 	ug_json_final (&jrcurl->json);
 	ug_jsonrpc_clear (&jrcurl->rpc);
-	ug_buffer_clear (&jrcurl->buffer, TRUE);
+	ug_buffer_chain_final (&jrcurl->chain);
 	ug_free (jrcurl->url);
 
 	// libcurl
@@ -112,14 +114,56 @@ static size_t	ug_jsonrpc_curl_write (char* buffer, size_t size, size_t nmemb, Ug
 	return size;
 }
 
+static size_t	ug_jsonrpc_curl_read (char* buffer, size_t size, size_t nmemb, UgJsonrpcCurl* jrcurl)
+{
+	UgBufferBlock*  block;
+	size_t          count;
+	size_t          total = 0;
+
+	size = size * nmemb;
+	for (block = jrcurl->sending.block;  block && size > 0;  ) {
+		count = block->length - jrcurl->sending.offset;
+		if (count > size)
+			count = size;
+		memcpy (buffer, block->data + jrcurl->sending.offset, count);
+		buffer += count;
+		size -= count;
+		total += count;
+		jrcurl->sending.offset += count;
+		if (jrcurl->sending.offset == block->length) {
+			jrcurl->sending.offset = 0;
+			block = block->next;
+		}
+	}
+	jrcurl->sending.block = block;
+	return total;
+}
+
+static int	ug_jsonrpc_curl_seek (UgJsonrpcCurl* jrcurl, curl_off_t offset, int origin)
+{
+	// libcurl rewind request body only
+	if (offset != 0 || origin != SEEK_SET)
+		return CURL_SEEKFUNC_CANTSEEK;
+	jrcurl->sending.block = jrcurl->chain.first;
+	jrcurl->sending.offset = 0;
+	return CURL_SEEKFUNC_OK;
+}
+
 int   ug_jsonrpc_curl_send (UgJsonrpcCurl* jrcurl)
 {
 	int  send_size;
 
-	send_size = jrcurl->buffer.cur - jrcurl->buffer.beg;
+	send_size = ug_buffer_chain_length (&jrcurl->chain);
+	jrcurl->sending.block = jrcurl->chain.first;
+	jrcurl->sending.offset = 0;
 	curl_easy_setopt (jrcurl->curl, CURLOPT_POST, TRUE);
-	curl_easy_setopt (jrcurl->curl, CURLOPT_POSTFIELDS, jrcurl->buffer.beg);
 	curl_easy_setopt (jrcurl->curl, CURLOPT_POSTFIELDSIZE, send_size);
+	curl_easy_setopt (jrcurl->curl, CURLOPT_READFUNCTION,
+			(curl_read_callback) ug_jsonrpc_curl_read);
+	curl_easy_setopt (jrcurl->curl, CURLOPT_READDATA, jrcurl);
+	curl_easy_setopt (jrcurl->curl, CURLOPT_SEEKFUNCTION,
+			(curl_seek_callback) ug_jsonrpc_curl_seek);
+	curl_easy_setopt (jrcurl->curl, CURLOPT_SEEKDATA, jrcurl);
 	curl_easy_setopt (jrcurl->curl, CURLOPT_HTTPHEADER, jrcurl->slist);
 	curl_easy_setopt (jrcurl->curl, CURLOPT_WRITEFUNCTION,
 			(curl_write_callback) ug_jsonrpc_curl_write);
@@ -131,7 +175,7 @@ int   ug_jsonrpc_curl_send (UgJsonrpcCurl* jrcurl)
 	jrcurl->response = 0;
 	curl_easy_getinfo (jrcurl->curl, CURLINFO_RESPONSE_CODE, &jrcurl->response);
 
-	jrcurl->buffer.cur = jrcurl->buffer.beg;
+	ug_buffer_chain_reset (&jrcurl->chain);
 	if (jrcurl->response != 200)
 		return -1;
 	return send_size;
@@ -139,7 +183,7 @@ int   ug_jsonrpc_curl_send (UgJsonrpcCurl* jrcurl)
 
 int   ug_jsonrpc_curl_receive (UgJsonrpcCurl* jrcurl)
 {
-	jrcurl->buffer.cur = jrcurl->buffer.beg;
+	ug_buffer_chain_reset (&jrcurl->chain);
 	if (jrcurl->response != 200)
 		return -1;
 	return jrcurl->receive_size;
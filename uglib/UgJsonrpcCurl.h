@@ -52,7 +52,13 @@ struct  UgJsonrpcCurl
 {
 	UgJson     json;
 	UgJsonrpc  rpc;
-	UgBuffer   buffer;
+	UgBufferChain  chain;
+
+	// read position of chain for CURLOPT_READFUNCTION
+	struct {
+		UgBufferBlock*  block;
+		int             offset;
+	} sending;
 
 	char*      url;
 	void*      curl;
@@ -55,9 +55,9 @@ void  ug_jsonrpc_socket_init (UgJsonrpcSocket* jrsock)
 	global_ref_count++;
 #endif // _WIN32 || _WIN64
 
-	ug_buffer_init (&jrsock->buffer, 4096);
+	ug_buffer_chain_init (&jrsock->chain, 4096);
 	ug_json_init (&jrsock->json);
-	ug_jsonrpc_init (&jrsock->rpc, &jrsock->json, &jrsock->buffer);
+	ug_jsonrpc_init (&jrsock->rpc, &jrsock->json, &jrsock->chain.buffer);
 	jrsock->socket = INVALID_SOCKET;
 
 	jrsock->rpc.send.func = (UgJsonrpcFunc) ug_jsonrpc_socket_send;
@@ -73,7 +73,7 @@ void  ug_jsonrpc_socket_final (UgJsonrpcSocket* jrsock)
 
 	ug_json_final (&jrsock->json);
 	ug_jsonrpc_clear (&jrsock->rpc);
-	ug_buffer_clear (&jrsock->buffer, TRUE);
+	ug_buffer_chain_final (&jrsock->chain);
 
 #if defined _WIN32 || defined _WIN64
 	global_ref_count--;
@@ -134,14 +134,33 @@ int   ug_jsonrpc_socket_connect_unix (UgJsonrpcSocket* jrsock, const char* path,
 
 int   ug_jsonrpc_socket_send (UgJsonrpcSocket* jrsock)
 {
-	int  n;
-
-	n = send (jrsock->socket, jrsock->buffer.beg,
-	          jrsock->buffer.cur - jrsock->buffer.beg, 0);
-	jrsock->buffer.cur = jrsock->buffer.beg;
-	if (n == -1)
-		return -1;
-	return n;
+#if defined _WIN32 || defined _WIN64
+	UgBufferBlock*  block;
+	WSABUF          wsabuf[64];
+	DWORD           n_wsabuf;
+	DWORD           n;
+	int             total = 0;
+
+	ug_buffer_chain_length (&jrsock->chain);
+	for (block = jrsock->chain.first;  block;  ) {
+		// gather blocks and send them by one call
+		for (n_wsabuf = 0;  block && n_wsabuf < 64;  block = block->next) {
+			wsabuf[n_wsabuf].buf = block->data;
+			wsabuf[n_wsabuf].len = block->length;
+			n_wsabuf++;
+		}
+		if (WSASend (jrsock->socket, wsabuf, n_wsabuf, &n, 0, NULL, NULL) != 0) {
+			total = -1;
+			break;
+		}
+		total += n;
+	}
+	ug_buffer_chain_reset (&jrsock->chain);
+	return total;
+#else
+	// writev() on socket works like sendmsg() without flags.
+	return ug_buffer_chain_write_fd (&jrsock->chain, jrsock->socket);
+#endif
 }
 
 int   ug_jsonrpc_socket_receive (UgJsonrpcSocket* jrsock)
@@ -151,13 +170,14 @@ int   ug_jsonrpc_socket_receive (UgJsonrpcSocket* jrsock)
 	int        error;
 	int        receive_size = 0;
 
-	buffer_size = jrsock->buffer.end - jrsock->buffer.beg;
+	// use first block of chain to receive data
+	buffer_size = jrsock->chain.block_size;
 	do {
 		// if connection was closed, read()/recv()/recvXXX() will return zero.
-		length = recv (jrsock->socket, jrsock->buffer.beg, buffer_size, 0);
+		length = recv (jrsock->socket, jrsock->chain.first->data, buffer_size, 0);
 		if (length == -1)
 			return -1;
-		error = ug_json_parse (&jrsock->json, jrsock->buffer.beg, length);
+		error = ug_json_parse (&jrsock->json, jrsock->chain.first->data, length);
 		if (error < 0 || jrsock->rpc.error == 0)
 			jrsock->rpc.error = error;
 		receive_size += length;
@@ -202,7 +222,7 @@ struct UgJsonrpcSocketThread
 	UG_JSONRPC_SOCKET_MEMBERS;
 //	UgJson           json;
 //	UgJsonrpc        rpc;
-//	UgBuffer         buffer;
+//	UgBufferChain    chain;
 //	int              socket;
 
 	UgSocketServer*  server;
@@ -51,14 +51,14 @@ typedef struct UgSocketServer    UgSocketServer;
 
 //           +-----------------------------+
 //           |       UgJsonrpcSocket       |    UgJsonrpcArray
-// buffer <--+--> UgJson <--> UgJsonrpc <--+-->       or
+//  chain <--+--> UgJson <--> UgJsonrpc <--+-->       or
 //           |                             |    UgJsonrpcObject
 //           +-----------------------------+
 
 #define UG_JSONRPC_SOCKET_MEMBERS  \
 	UgJson           json;         \
 	UgJsonrpc        rpc;          \
-	UgBuffer         buffer;       \
+	UgBufferChain    chain;        \
 	int              socket
 
 struct  UgJsonrpcSocket
@@ -67,7 +67,7 @@ struct  UgJsonrpcSocket
 /*	// ------ UgJsonrpcSocket members ------
 	UgJson           json;
 	UgJsonrpc        rpc;
-	UgBuffer         buffer;
+	UgBufferChain    chain;
 	int              socket;
  */
 };
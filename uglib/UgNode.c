@@ -46,6 +46,10 @@
 #include <UgDefine.h>
 #include <UgNode.h>
 
+static void  ug_node_index_insert (UgNode* parent, UgNode* sibling, UgNode* node);
+static void  ug_node_index_remove (UgNode* parent, UgNode* node);
+static void  ug_node_index_reverse (UgNodeIndex* record);
+
 UgNode* ug_node_new  (void)
 {
 #ifdef HAVE_GLIB
@@ -57,6 +61,8 @@ UgNode* ug_node_new  (void)
 
 void ug_node_free (UgNode* link)
 {
+	if (link->index_root)
+		ug_node_index_free (link);
 #ifdef HAVE_GLIB
 	g_slice_free1 (sizeof (UgNode), link);
 #else
@@ -73,12 +79,16 @@ void   ug_node_init (UgNode* node)
 	node->children = NULL;
 	node->last = NULL;
 	node->n_children = 0;
+	node->index = NULL;
+	node->index_root = NULL;
 }
 
 void    ug_node_reverse (UgNode* node)
 {
 	UgNode* temp;
 
+	if (node->index_root)
+		ug_node_index_reverse (node->index_root);
 	temp = node->last;
 	node->last = node->children;
 	node->children = temp;
@@ -100,6 +110,8 @@ void    ug_node_prepend (UgNode* parent, UgNode* node)
 	node->next = parent->children;
 	parent->children = node;
 	parent->n_children++;
+	if (parent->index_root)
+		ug_node_index_insert (parent, node->next, node);
 }
 
 void   ug_node_append (UgNode* parent, UgNode* node)
@@ -112,6 +124,8 @@ void   ug_node_append (UgNode* parent, UgNode* node)
 	node->prev = parent->last;
 	parent->last = node;
 	parent->n_children++;
+	if (parent->index_root)
+		ug_node_index_insert (parent, NULL, node);
 }
 
 void   ug_node_insert (UgNode* parent, UgNode *sibling, UgNode* node)
@@ -131,10 +145,14 @@ void   ug_node_insert (UgNode* parent, UgNode *sibling, UgNode* node)
 	node->prev = sibling->prev;
 	sibling->prev = node;
 	parent->n_children++;
+	if (parent->index_root)
+		ug_node_index_insert (parent, sibling, node);
 }
 
 void   ug_node_remove (UgNode* parent, UgNode* node)
 {
+	if (node->index)
+		ug_node_index_remove (parent, node);
 	if (parent->last == node)
 		parent->last = node->prev;
 	if (parent->children == node)
@@ -171,19 +189,61 @@ void   ug_node_unlink (UgNode* node)
 
 UgNode* ug_node_nth_child (UgNode* node, int nth)
 {
-	if (nth >= 0) {
-		for (node = node->children;  node;  node = node->next, nth--) {
+	UgNodeIndex*  record;
+
+	if (nth < 0 || nth >= node->n_children)
+		return NULL;
+
+	if (node->index_root == NULL && node->n_children >= UG_NODE_INDEX_THRESHOLD)
+		ug_node_index_build (node);
+	if (node->index_root) {
+		for (record = node->index_root;  record;  ) {
+			if (record->left) {
+				if (nth < record->left->size) {
+					record = record->left;
+					continue;
+				}
+				nth -= record->left->size;
+			}
 			if (nth == 0)
-				return node;
+				return record->node;
+			nth--;
+			record = record->right;
 		}
+		return NULL;
+	}
+
+	for (node = node->children;  node;  node = node->next, nth--) {
+		if (nth == 0)
+			return node;
 	}
 	return NULL;
 }
 
 int   ug_node_child_position (UgNode* node, UgNode* child)
 {
+	UgNodeIndex*  record;
 	int  position = 0;
 
+	if (child == NULL || child->parent != node)
+		return -1;
+
+	if (node->index_root == NULL && node->n_children >= UG_NODE_INDEX_THRESHOLD)
+		ug_node_index_build (node);
+	if (child->index) {
+		record = child->index;
+		if (record->left)
+			position = record->left->size;
+		for (;  record->parent;  record = record->parent) {
+			if (record == record->parent->right) {
+				position++;
+				if (record->parent->left)
+					position += record->parent->left->size;
+			}
+		}
+		return position;
+	}
+
 	for (node = node->children;  node;  node = node->next, position++) {
 		if (node == child)
 			return position;
@@ -191,3 +251,212 @@ int   ug_node_child_position (UgNode* node, UgNode* child)
 	return -1;
 }
 
+// ----------------------------------------------------------------------------
+// UgNodeIndex: treap ordered by position of children.
+//              priority is random, record that has higher priority is
+//              closer to root. UgNodeIndex.size is size of subtree.
+
+#define INDEX_SIZE(record)    ((record) ? (record)->size : 0)
+
+static unsigned int  index_seed = 2463534242u;
+
+static unsigned int  ug_node_index_random (void)
+{
+	// xorshift32
+	index_seed ^= index_seed << 13;
+	index_seed ^= index_seed >> 17;
+	index_seed ^= index_seed << 5;
+	return index_seed;
+}
+
+static UgNodeIndex*  ug_node_index_new (UgNode* node)
+{
+	UgNodeIndex*  record;
+
+#ifdef HAVE_GLIB
+	record = g_slice_alloc (sizeof (UgNodeIndex));
+#else
+	record = ug_malloc (sizeof (UgNodeIndex));
+#endif
+	record->left = NULL;
+	record->right = NULL;
+	record->parent = NULL;
+	record->node = node;
+	record->size = 1;
+	record->priority = ug_node_index_random ();
+	node->index = record;
+	return record;
+}
+
+static void  ug_node_index_free1 (UgNodeIndex* record)
+{
+	record->node->index = NULL;
+#ifdef HAVE_GLIB
+	g_slice_free1 (sizeof (UgNodeIndex), record);
+#else
+	ug_free (record);
+#endif
+}
+
+static int  ug_node_index_count (UgNodeIndex* record)
+{
+	if (record == NULL)
+		return 0;
+	record->size = ug_node_index_count (record->left) +
+	               ug_node_index_count (record->right) + 1;
+	return record->size;
+}
+
+// rotate 'record' up, it's parent will become it's child.
+static void  ug_node_index_rotate (UgNode* parent, UgNodeIndex* record)
+{
+	UgNodeIndex*  upper;
+	UgNodeIndex*  moved;
+
+	upper = record->parent;
+	if (upper->left == record) {
+		moved = record->right;
+		upper->left = moved;
+		record->right = upper;
+	}
+	else {
+		moved = record->left;
+		upper->right = moved;
+		record->left = upper;
+	}
+	if (moved)
+		moved->parent = upper;
+
+	record->parent = upper->parent;
+	if (upper->parent == NULL)
+		parent->index_root = record;
+	else if (upper->parent->left == upper)
+		upper->parent->left = record;
+	else
+		upper->parent->right = record;
+	upper->parent = record;
+
+	upper->size = INDEX_SIZE (upper->left) + INDEX_SIZE (upper->right) + 1;
+	record->size = INDEX_SIZE (record->left) + INDEX_SIZE (record->right) + 1;
+}
+
+// insert 'node' before 'sibling'. if 'sibling' is NULL, append it.
+static void  ug_node_index_insert (UgNode* parent, UgNode* sibling, UgNode* node)
+{
+	UgNodeIndex*  record;
+	UgNodeIndex*  cur;
+
+	record = ug_node_index_new (node);
+	if (sibling == NULL || sibling->index == NULL) {
+		cur = parent->index_root;
+		while (cur->right)
+			cur = cur->right;
+		cur->right = record;
+	}
+	else {
+		cur = sibling->index;
+		if (cur->left == NULL)
+			cur->left = record;
+		else {
+			for (cur = cur->left;  cur->right;  cur = cur->right)
+				continue;
+			cur->right = record;
+		}
+	}
+	record->parent = cur;
+
+	for (;  cur;  cur = cur->parent)
+		cur->size++;
+	while (record->parent && record->parent->priority < record->priority)
+		ug_node_index_rotate (parent, record);
+}
+
+static void  ug_node_index_remove (UgNode* parent, UgNode* node)
+{
+	UgNodeIndex*  record;
+	UgNodeIndex*  cur;
+
+	record = node->index;
+	// rotate record down until it become leaf
+	while (record->left || record->right) {
+		if (record->left == NULL)
+			cur = record->right;
+		else if (record->right == NULL)
+			cur = record->left;
+		else if (record->left->priority > record->right->priority)
+			cur = record->left;
+		else
+			cur = record->right;
+		ug_node_index_rotate (parent, cur);
+	}
+
+	cur = record->parent;
+	if (cur == NULL)
+		parent->index_root = NULL;
+	else if (cur->left == record)
+		cur->left = NULL;
+	else
+		cur->right = NULL;
+	for (;  cur;  cur = cur->parent)
+		cur->size--;
+
+	ug_node_index_free1 (record);
+}
+
+static void  ug_node_index_reverse (UgNodeIndex* record)
+{
+	UgNodeIndex*  temp;
+
+	for (;  record;  record = record->left) {
+		temp = record->left;
+		record->left = record->right;
+		record->right = temp;
+		ug_node_index_reverse (record->right);
+	}
+}
+
+void  ug_node_index_build (UgNode* node)
+{
+	UgNodeIndex*  record;
+	UgNodeIndex*  upper;
+	UgNodeIndex*  top;
+	UgNode*       child;
+
+	if (node->index_root || node->children == NULL)
+		return;
+
+	// build treap (cartesian tree) from ordered children in O(n).
+	// 'top' is the last record in right spine of tree.
+	top = NULL;
+	for (child = node->children;  child;  child = child->next) {
+		record = ug_node_index_new (child);
+		upper = NULL;
+		while (top && top->priority < record->priority) {
+			upper = top;
+			top = top->parent;
+		}
+		record->left = upper;
+		if (upper)
+			upper->parent = record;
+		record->parent = top;
+		if (top)
+			top->right = record;
+		top = record;
+	}
+
+	while (top->parent)
+		top = top->parent;
+	node->index_root = top;
+	ug_node_index_count (top);
+}
+
+void  ug_node_index_free (UgNode* node)
+{
+	UgNode*  child;
+
+	for (child = node->children;  child;  child = child->next) {
+		if (child->index)
+			ug_node_index_free1 (child->index);
+	}
+	node->index_root = NULL;
+}
@@ -44,6 +44,7 @@ extern "C" {
 #endif
 
 typedef struct	UgNode          UgNode;
+typedef struct	UgNodeIndex     UgNodeIndex;
 
 // ----------------------------------------------------------------------------
 // UgNode: Data Node for all data, compatible with GNode in glib
@@ -55,7 +56,9 @@ typedef struct	UgNode          UgNode;
 	NodeType*  parent;     \
 	NodeType*  children;   \
 	NodeType*  last;       \
-	int        n_children
+	int        n_children; \
+	UgNodeIndex*  index;   \
+	UgNodeIndex*  index_root
 
 struct UgNode
 {
@@ -68,9 +71,30 @@ struct UgNode
 	UgNode*  children;
 	UgNode*  last;
 	int      n_children;
+	UgNodeIndex*  index;       // record of this node in parent's index
+	UgNodeIndex*  index_root;  // index of children
  */
 };
 
+// ----------------------------------------------------------------------------
+// UgNodeIndex: optional order-statistic index (treap) over children.
+//              It will be created by ug_node_nth_child() or
+//              ug_node_child_position() when node has many children,
+//              and then maintained by prepend/append/insert/remove.
+//              nth_child, child_position, and inserting become O(log n).
+
+#define UG_NODE_INDEX_THRESHOLD    64
+
+struct UgNodeIndex
+{
+	UgNodeIndex*  left;
+	UgNodeIndex*  right;
+	UgNodeIndex*  parent;
+	UgNode*       node;
+	int           size;       // number of records in this subtree
+	unsigned int  priority;
+};
+
 UgNode* ug_node_new  (void);
 void    ug_node_free (UgNode* link);
 
@@ -86,6 +110,10 @@ void    ug_node_unlink (UgNode* node);
 UgNode* ug_node_nth_child (UgNode* node, int nth);
 int     ug_node_child_position (UgNode* node, UgNode* child);
 
+// build or free index of children manually.
+void    ug_node_index_build (UgNode* node);
+void    ug_node_index_free (UgNode* node);
+
 #ifdef __cplusplus
 }
 #endif
@@ -92,13 +92,11 @@ UgPair* ug_registry_find(UgRegistry* reg, const char* key, int* inserted_index)
 		return NULL;
 	}
 
-	return ug_array_find_sorted(reg, &key,
-	                            ug_array_compare_string,
-	                            inserted_index);
+	return ug_array_find_sorted_str(reg, key, inserted_index);
 }
 
 void  ug_registry_sort(UgRegistry* reg)
 {
-	ug_array_sort(reg, ug_array_compare_string);
+	ug_array_sort_str(reg);
 	reg->sorted = TRUE;
 }
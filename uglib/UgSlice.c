@@ -0,0 +1,219 @@
+/*
+ *
+ *   Copyright (C) 2012-2018 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  In addition, as a special exception, the copyright holders give
+ *  permission to link the code of portions of this program with the
+ *  OpenSSL library under certain conditions as described in each
+ *  individual source file, and distribute linked combinations
+ *  including the two.
+ *  You must obey the GNU Lesser General Public License in all respects
+ *  for all of the code used other than OpenSSL.  If you modify
+ *  file(s) with this exception, you may extend this exception to your
+ *  version of the file(s), but you are not obligated to do so.  If you
+ *  do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source
+ *  files in the program, then also delete it here.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#if defined _WIN32 || defined _WIN64
+#include <malloc.h>     // _aligned_malloc()
+#endif
+#include <UgSlice.h>
+#include <UgThread.h>
+
+#if !(defined UG_SLICE_MALLOC)
+
+// size of object is rounded up to SLICE_ALIGN, the same alignment as malloc()
+#define SLICE_ALIGN       (sizeof (void*) * 2)
+#define SLICE_MAX_SIZE    512
+#define SLICE_N_CLASSES   (SLICE_MAX_SIZE / SLICE_ALIGN)
+#define SLAB_SIZE         (16 * 1024)
+
+typedef struct UgSlab         UgSlab;
+typedef struct UgSliceClass   UgSliceClass;
+
+// head of slab, it's size is SLICE_ALIGN.
+struct UgSlab
+{
+	UgSlice*  slice;
+	UgSlab*   next;     // next slab of the same size
+};
+
+struct UgSliceClass
+{
+	void**   freed;     // free list
+	char*    cur;       // unused space of the newest slab
+	char*    end;
+	UgSlab*  slabs;
+};
+
+struct UgSlice
+{
+	UgMutexStatic  mutex;
+	int            ref_count;    // 1 + number of objects
+	UgSliceClass   classes[SLICE_N_CLASSES];
+};
+
+static UgSlice  slice_shared = {UG_MUTEX_STATIC_INIT, 1};
+
+static UgSlab*  slab_new (UgSlice* slice)
+{
+	UgSlab*  slab;
+
+#if defined _WIN32 || defined _WIN64
+	slab = _aligned_malloc (SLAB_SIZE, SLAB_SIZE);
+#else
+	if (posix_memalign ((void**) &slab, SLAB_SIZE, SLAB_SIZE) != 0)
+		slab = NULL;
+#endif
+	if (slab)
+		slab->slice = slice;
+	return slab;
+}
+
+static void  slab_free (UgSlab* slab)
+{
+#if defined _WIN32 || defined _WIN64
+	_aligned_free (slab);
+#else
+	free (slab);
+#endif
+}
+
+UgSlice* ug_slice_new (void)
+{
+	UgMutexStatic  mutex = UG_MUTEX_STATIC_INIT;
+	UgSlice*       slice;
+
+	slice = ug_malloc0 (sizeof (UgSlice));
+	slice->mutex = mutex;
+	slice->ref_count = 1;
+	return slice;
+}
+
+static void  ug_slice_free (UgSlice* slice)
+{
+	UgSlab*  slab;
+	UgSlab*  next;
+	int      index;
+
+	for (index = 0;  index < SLICE_N_CLASSES;  index++) {
+		for (slab = slice->classes[index].slabs;  slab;  slab = next) {
+			next = slab->next;
+			slab_free (slab);
+		}
+	}
+	ug_free (slice);
+}
+
+void  ug_slice_unref (UgSlice* slice)
+{
+	int  ref_count;
+
+	if (slice == NULL || slice == &slice_shared)
+		return;
+	ug_mutex_static_lock (&slice->mutex);
+	ref_count = --slice->ref_count;
+	ug_mutex_static_unlock (&slice->mutex);
+	if (ref_count == 0)
+		ug_slice_free (slice);
+}
+
+void*  ug_slice_alloc (UgSlice* slice, size_t size)
+{
+	UgSliceClass* sclass;
+	UgSlab*       slab;
+	void**        mem;
+
+	if (size == 0 || size > SLICE_MAX_SIZE)
+		return ug_malloc (size);
+	if (slice == NULL)
+		slice = &slice_shared;
+	size = (size + SLICE_ALIGN - 1) & ~(SLICE_ALIGN - 1);
+	sclass = slice->classes + size / SLICE_ALIGN - 1;
+
+	ug_mutex_static_lock (&slice->mutex);
+	if (sclass->freed) {
+		mem = sclass->freed;
+		sclass->freed = *mem;
+	}
+	else {
+		if ((size_t) (sclass->end - sclass->cur) < size) {
+			slab = slab_new (slice);
+			if (slab == NULL) {
+				ug_mutex_static_unlock (&slice->mutex);
+				return NULL;
+			}
+			slab->next = sclass->slabs;
+			sclass->slabs = slab;
+			sclass->cur = (char*) slab + SLICE_ALIGN;
+			sclass->end = (char*) slab + SLAB_SIZE;
+		}
+		mem = (void**) sclass->cur;
+		sclass->cur += size;
+	}
+	slice->ref_count++;
+	ug_mutex_static_unlock (&slice->mutex);
+	return mem;
+}
+
+void*  ug_slice_alloc0 (UgSlice* slice, size_t size)
+{
+	void*  mem;
+
+	mem = ug_slice_alloc (slice, size);
+	if (mem)
+		memset (mem, 0, size);
+	return mem;
+}
+
+void   ug_slice_free1 (size_t size, void* mem)
+{
+	UgSliceClass* sclass;
+	UgSlice*      slice;
+	int           ref_count;
+
+	if (mem == NULL)
+		return;
+	if (size == 0 || size > SLICE_MAX_SIZE) {
+		ug_free (mem);
+		return;
+	}
+	slice = ((UgSlab*) ((uintptr_t) mem & ~(uintptr_t) (SLAB_SIZE - 1)))->slice;
+	size = (size + SLICE_ALIGN - 1) & ~(SLICE_ALIGN - 1);
+	sclass = slice->classes + size / SLICE_ALIGN - 1;
+
+	ug_mutex_static_lock (&slice->mutex);
+	*(void**) mem = sclass->freed;
+	sclass->freed = mem;
+	ref_count = --slice->ref_count;
+	ug_mutex_static_unlock (&slice->mutex);
+	// the last object of arena that was unreferenced
+	if (ref_count == 0)
+		ug_slice_free (slice);
+}
+
+#endif  // !UG_SLICE_MALLOC
+
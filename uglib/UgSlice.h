@@ -0,0 +1,87 @@
+/*
+ *
+ *   Copyright (C) 2012-2018 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  In addition, as a special exception, the copyright holders give
+ *  permission to link the code of portions of this program with the
+ *  OpenSSL library under certain conditions as described in each
+ *  individual source file, and distribute linked combinations
+ *  including the two.
+ *  You must obey the GNU Lesser General Public License in all respects
+ *  for all of the code used other than OpenSSL.  If you modify
+ *  file(s) with this exception, you may extend this exception to your
+ *  version of the file(s), but you are not obligated to do so.  If you
+ *  do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source
+ *  files in the program, then also delete it here.
+ *
+ */
+
+#ifndef UG_SLICE_H
+#define UG_SLICE_H
+
+#include <stddef.h>
+#include <UgDefine.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct UgSlice    UgSlice;
+
+/* ----------------------------------------------------------------------------
+   UgSlice: arena for many small objects, e.g. UgetNode, UgData, and
+            UgGroupData.
+
+   Objects are carved from 16 KiB slabs of arena, freed objects are kept in
+   free list of their size. Objects of one category use the same arena, so
+   they are contiguous in memory. Slab is aligned by it's size, free1() finds
+   arena of object by address.
+   If 'slice' is NULL, object is allocated from shared arena.
+   Arena is freed after unref() and all of it's objects are freed.
+   Define UG_SLICE_MALLOC to use malloc() directly. It is defined when
+   AddressSanitizer is enabled.
+ */
+
+#if defined __SANITIZE_ADDRESS__ && !defined UG_SLICE_MALLOC
+#define UG_SLICE_MALLOC
+#endif
+
+#if defined UG_SLICE_MALLOC
+#define ug_slice_new()                  NULL
+#define ug_slice_unref(slice)           ((void) (slice))
+#define ug_slice_alloc(slice, size)     ((void) (slice), ug_malloc (size))
+#define ug_slice_alloc0(slice, size)    ((void) (slice), ug_malloc0 (size))
+#define ug_slice_free1(size, mem)       ug_free (mem)
+#else
+UgSlice* ug_slice_new   (void);
+void     ug_slice_unref (UgSlice* slice);
+
+void*  ug_slice_alloc  (UgSlice* slice, size_t size);
+void*  ug_slice_alloc0 (UgSlice* slice, size_t size);
+void   ug_slice_free1  (size_t size, void* mem);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UG_SLICE_H
+
@@ -38,10 +38,12 @@
 #define _CRT_SECURE_NO_WARNINGS
 #endif
 
+#include <stddef.h> // offsetof
 #include <stdio.h>  // vsnprintf
 #include <stdlib.h>
 #include <stdarg.h>
 #include <UgString.h>
+#include <UgThread.h>
 
 // ----------------------------------------------------------------------------
 // String
@@ -329,6 +331,175 @@ time_t  ug_str_rfc3339_to_time (const char* string)
 	return mktime (&timem);
 }
 
+// ------------------------------------
+// shared string
+// Reference count is changed atomically. Table is locked only to find, add,
+// or remove string. ug_str_intern() revive string whose count dropped to 0,
+// so ug_str_unref() remove it only if count is still 0 under lock.
+
+static UgMutexStatic  intern_mutex = UG_MUTEX_STATIC_INIT;
+#define intern_lock()      ug_mutex_static_lock (&intern_mutex)
+#define intern_unlock()    ug_mutex_static_unlock (&intern_mutex)
+
+#if defined _WIN32 || defined _WIN64
+#include <windows.h>
+#define intern_ref(shared)      InterlockedIncrement (&(shared)->ref_count)
+#define intern_unref(shared)    InterlockedDecrement (&(shared)->ref_count)
+#define intern_count(shared)    InterlockedCompareExchange (&(shared)->ref_count, 0, 0)
+#else
+#define intern_ref(shared)      __atomic_add_fetch (&(shared)->ref_count, 1, __ATOMIC_RELAXED)
+#define intern_unref(shared)    __atomic_sub_fetch (&(shared)->ref_count, 1, __ATOMIC_ACQ_REL)
+#define intern_count(shared)    __atomic_load_n (&(shared)->ref_count, __ATOMIC_ACQUIRE)
+#endif
+
+typedef struct UgSharedStr    UgSharedStr;
+
+struct UgSharedStr
+{
+	unsigned int  hash;
+	volatile long ref_count;
+	char          string[1];
+};
+
+// open addressing, size of table is power of 2
+static struct
+{
+	UgSharedStr** at;
+	unsigned int  mask;
+	int           length;
+} intern_table;
+
+#define SHARED_STR(string)   \
+		((UgSharedStr*) ((char*)(string) - offsetof (UgSharedStr, string)))
+
+static unsigned int  intern_hash (const char* string)
+{
+	unsigned int  hash = 5381;
+
+	for (;  *string;  string++)
+		hash = hash * 33 + (unsigned char) *string;
+	return hash;
+}
+
+static void  intern_resize (void)
+{
+	UgSharedStr** old_at;
+	unsigned int  old_size;
+	unsigned int  index, pos;
+
+	old_at = intern_table.at;
+	old_size = (old_at) ? intern_table.mask + 1 : 0;
+	intern_table.mask = (old_size) ? old_size * 2 - 1 : 255;
+	intern_table.at = ug_malloc0 (sizeof (UgSharedStr*) * (intern_table.mask + 1));
+
+	for (index = 0;  index < old_size;  index++) {
+		if (old_at[index] == NULL)
+			continue;
+		pos = old_at[index]->hash & intern_table.mask;
+		while (intern_table.at[pos])
+			pos = (pos + 1) & intern_table.mask;
+		intern_table.at[pos] = old_at[index];
+	}
+	ug_free (old_at);
+}
+
+// remove slot and move following entries back
+static void  intern_remove (unsigned int pos)
+{
+	unsigned int  next, home;
+
+	intern_table.at[pos] = NULL;
+	intern_table.length--;
+	for (next = (pos + 1) & intern_table.mask;  intern_table.at[next];
+	     next = (next + 1) & intern_table.mask)
+	{
+		home = intern_table.at[next]->hash & intern_table.mask;
+		if (((next - home) & intern_table.mask) >= ((next - pos) & intern_table.mask)) {
+			intern_table.at[pos] = intern_table.at[next];
+			intern_table.at[next] = NULL;
+			pos = next;
+		}
+	}
+}
+
+char*  ug_str_intern (const char* string)
+{
+	UgSharedStr*  shared;
+	unsigned int  hash, pos;
+	size_t        length;
+
+	if (string == NULL)
+		return NULL;
+	hash = intern_hash (string);
+
+	intern_lock ();
+	if (intern_table.at) {
+		for (pos = hash & intern_table.mask;  (shared = intern_table.at[pos]) != NULL;
+		     pos = (pos + 1) & intern_table.mask)
+		{
+			if (shared->hash == hash && strcmp (shared->string, string) == 0) {
+				intern_ref (shared);
+				intern_unlock ();
+				return shared->string;
+			}
+		}
+	}
+	// keep load factor under 1/2
+	if (intern_table.at == NULL || (unsigned) intern_table.length * 2 >= intern_table.mask)
+		intern_resize ();
+
+	length = strlen (string);
+	shared = ug_malloc (offsetof (UgSharedStr, string) + length + 1);
+	shared->hash = hash;
+	shared->ref_count = 1;
+	memcpy (shared->string, string, length + 1);
+
+	pos = hash & intern_table.mask;
+	while (intern_table.at[pos])
+		pos = (pos + 1) & intern_table.mask;
+	intern_table.at[pos] = shared;
+	intern_table.length++;
+	intern_unlock ();
+	return shared->string;
+}
+
+void  ug_str_unref (char* string)
+{
+	UgSharedStr*  shared;
+	unsigned int  hash, pos;
+
+	if (string == NULL)
+		return;
+	shared = SHARED_STR (string);
+	hash = shared->hash;
+	if (intern_unref (shared) > 0)
+		return;
+
+	intern_lock ();
+	// string may be revived or removed by other thread before lock.
+	for (pos = hash & intern_table.mask;  intern_table.at[pos];
+	     pos = (pos + 1) & intern_table.mask)
+	{
+		if (intern_table.at[pos] != shared)
+			continue;
+		if (intern_count (shared) == 0) {
+			intern_remove (pos);
+			ug_free (shared);
+		}
+		break;
+	}
+	intern_unlock ();
+}
+
+void  ug_str_set_shared (char** field, const char* string)
+{
+	char*  old;
+
+	old = *field;
+	*field = ug_str_intern (string);
+	ug_str_unref (old);
+}
+
 // ------------------------------------
 // command-line
 
@@ -99,6 +99,17 @@ char*  ug_str_from_time (time_t ptt, int date_only);
 time_t  ug_str_rfc822_to_time  (const char* rfc822_string);
 time_t  ug_str_rfc3339_to_time (const char* rfc3339_string);
 
+// ------------------------------------
+// shared string: identical strings share one reference-counted allocation,
+// so they can be compared by pointer.
+// ug_str_intern() return shared copy of string.
+// ug_str_unref() release string returned by ug_str_intern().
+// ug_str_set_shared() replace shared string in *field by shared copy of string.
+//   Fields that hold shared string must be changed by it.
+char*  ug_str_intern (const char* string);
+void   ug_str_unref (char* string);
+void   ug_str_set_shared (char** field, const char* string);
+
 // ------------------------------------
 // command-line
 char** ug_argv_from_cmd (const char* commandline, int* argc, int reserve_len);
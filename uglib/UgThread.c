@@ -95,5 +95,15 @@ void  ug_mutex_unlock (UgMutex* mutex)
 	LeaveCriticalSection (*mutex);
 }
 
+void  ug_mutex_static_lock (UgMutexStatic* mutex)
+{
+	AcquireSRWLockExclusive ((PSRWLOCK) mutex);
+}
+
+void  ug_mutex_static_unlock (UgMutexStatic* mutex)
+{
+	ReleaseSRWLockExclusive ((PSRWLOCK) mutex);
+}
+
 #endif // _WIN32 || _WIN64
 
@@ -68,6 +68,15 @@ void  ug_mutex_clear (UgMutex* mutex);
 void  ug_mutex_lock  (UgMutex* mutex);
 void  ug_mutex_unlock(UgMutex* mutex);
 
+// static mutex ------
+// UgMutexStatic is initialized by UG_MUTEX_STATIC_INIT and never cleared.
+typedef void*              UgMutexStatic;    // SRWLOCK
+
+#define UG_MUTEX_STATIC_INIT    NULL
+
+void  ug_mutex_static_lock  (UgMutexStatic* mutex);
+void  ug_mutex_static_unlock(UgMutexStatic* mutex);
+
 //#elif defined(HAVE_PTHREAD)
 #else
 #include <pthread.h>
@@ -107,6 +116,18 @@ typedef UgThreadResult (*UgThreadFunc)(void*);
 // void ug_mutex_unlock(UgMutex* mutex);
 #define ug_mutex_unlock(mutex)  pthread_mutex_unlock(mutex)
 
+// static mutex ------
+// UgMutexStatic is initialized by UG_MUTEX_STATIC_INIT and never cleared.
+typedef pthread_mutex_t    UgMutexStatic;
+
+#define UG_MUTEX_STATIC_INIT    PTHREAD_MUTEX_INITIALIZER
+
+// void ug_mutex_static_lock(UgMutexStatic* mutex);
+#define ug_mutex_static_lock(mutex)    pthread_mutex_lock(mutex)
+
+// void ug_mutex_static_unlock(UgMutexStatic* mutex);
+#define ug_mutex_static_unlock(mutex)  pthread_mutex_unlock(mutex)
+
 #endif  // _WIN32 || _WIN64
 
 
@@ -365,6 +365,196 @@ int  ug_uri_match_file_exts (UgUri* uuri, char** exts)
 	return -1;
 }
 
+// ------------------------------------
+// canonical URI for comparing
+
+static const char  hex_digits[] = "0123456789ABCDEF";
+
+static int  hex_value (char ch)
+{
+	if (ch >= '0' && ch <= '9')
+		return ch - '0';
+	if (ch >= 'A' && ch <= 'F')
+		return ch - 'A' + 10;
+	if (ch >= 'a' && ch <= 'f')
+		return ch - 'a' + 10;
+	return -1;
+}
+
+// RFC 3986: unreserved = ALPHA / DIGIT / "-" / "." / "_" / "~"
+static int  is_unreserved (int ch)
+{
+	return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') ||
+	       (ch >= '0' && ch <= '9') ||
+	       ch == '-' || ch == '.' || ch == '_' || ch == '~';
+}
+
+// copy and normalize percent-encoding. return end of 'dest'
+static char* copy_percent_normalized (char* dest, const char* src, int length)
+{
+	const char* end;
+	int         high;
+	int         low;
+
+	for (end = src + length;  src < end;  src++) {
+		if (src[0] == '%' && src + 2 < end &&
+		    (high = hex_value (src[1])) >= 0 && (low = hex_value (src[2])) >= 0)
+		{
+			if (is_unreserved (high * 16 + low))
+				*dest++ = (char) (high * 16 + low);
+			else {
+				*dest++ = '%';
+				*dest++ = hex_digits[high];
+				*dest++ = hex_digits[low];
+			}
+			src += 2;
+			continue;
+		}
+		*dest++ = src[0];
+	}
+	return dest;
+}
+
+static char* copy_lower (char* dest, const char* src, int length)
+{
+	for (;  length > 0;  length--, src++) {
+		if (src[0] >= 'A' && src[0] <= 'Z')
+			*dest++ = src[0] + ('a' - 'A');
+		else
+			*dest++ = src[0];
+	}
+	return dest;
+}
+
+static int  match_query_field (const char* field, int length, char** fields)
+{
+	int  len;
+
+	for (;  *fields;  fields++) {
+		len = strlen (*fields);
+		if (len > 0 && fields[0][len - 1] == '*') {
+			if (length >= len - 1 && strncasecmp (field, *fields, len - 1) == 0)
+				return TRUE;
+		}
+		else if (length == len && strncasecmp (field, *fields, len) == 0)
+			return TRUE;
+	}
+	return FALSE;
+}
+
+static int  is_default_port (const char* scheme, int scheme_len,
+                             const char* port, int port_len)
+{
+	static const struct {
+		const char*  scheme;
+		const char*  port;
+	} default_ports[] = {
+		{"http",  "80"},
+		{"https", "443"},
+		{"ftp",   "21"},
+		{NULL,    NULL},
+	};
+	int  index;
+
+	// empty port "http://host:/"
+	if (port_len == 0)
+		return TRUE;
+	for (index = 0;  default_ports[index].scheme;  index++) {
+		if (scheme_len == (int) strlen (default_ports[index].scheme) &&
+		    strncasecmp (scheme, default_ports[index].scheme, scheme_len) == 0)
+		{
+			return port_len == (int) strlen (default_ports[index].port) &&
+			       strncmp (port, default_ports[index].port, port_len) == 0;
+		}
+	}
+	return FALSE;
+}
+
+int  ug_uri_canonicalize (UgUri* uuri, char** query_fields, char* dest)
+{
+	const char* uri = uuri->uri;
+	const char* beg;
+	const char* end;
+	const char* host;
+	const char* query;
+	const char* fragment;
+	const char* field;
+	char*       cur;
+	int         length;
+	int         n_fields;
+
+	length = strlen (uri);
+	if (uuri->scheme_len == 0 || length > INT16_MAX) {
+		memcpy (dest, uri, length + 1);
+		return length;
+	}
+
+	cur = copy_lower (dest, uri, uuri->scheme_len);
+	*cur++ = ':';
+
+	// Don't use parts of UgUri, authority of it ends at '/' only.
+	// fragment begins at first '#', query begins at first '?' before it.
+	beg = uri + uuri->scheme_len + 1;   // + ':'
+	fragment = beg + strcspn (beg, "#");
+	query = memchr (beg, '?', fragment - beg);
+	if (query == NULL)
+		query = fragment;
+
+	if (beg[0] == '/' && beg[1] == '/') {
+		*cur++ = '/';
+		*cur++ = '/';
+		beg += 2;
+		end = beg + strcspn (beg, "/?#");
+		// user info is case-sensitive
+		for (host = end;  host > beg && host[-1] != '@';  host--)
+			;
+		memcpy (cur, beg, host - beg);
+		cur += host - beg;
+		// IPv6 address has ':' in brackets
+		if (host[0] == '[' && (beg = memchr (host, ']', end - host)) != NULL)
+			beg++;
+		else
+			beg = host;
+		beg += strcspn (beg, ":/?#");
+		cur = copy_lower (cur, host, beg - host);
+		// port
+		if (beg < end && beg[0] == ':' &&
+		    is_default_port (uri, uuri->scheme_len, beg + 1, end - beg - 1) == FALSE)
+		{
+			memcpy (cur, beg, end - beg);
+			cur += end - beg;
+		}
+		beg = end;
+		// path of URI that has authority begins with '/'
+		if (beg[0] != '/')
+			*cur++ = '/';
+	}
+
+	// path
+	cur = copy_percent_normalized (cur, beg, query - beg);
+
+	// query
+	if (query < fragment) {
+		for (beg = query + 1, n_fields = 0;  beg < fragment;  beg = field + 1) {
+			for (field = beg;  field < fragment && field[0] != '&';  field++)
+				;
+			length = strcspn (beg, "=&#");
+			if (length > field - beg)
+				length = field - beg;
+			if (field == beg ||
+			    (query_fields && match_query_field (beg, length, query_fields)))
+			{
+				continue;
+			}
+			*cur++ = (n_fields++ == 0) ? '?' : '&';
+			cur = copy_percent_normalized (cur, beg, field - beg);
+		}
+	}
+
+	*cur = 0;
+	return cur - dest;
+}
+
 // ------------------------------------
 // UgUriQuery
 
@@ -126,6 +126,18 @@ int  ug_uri_match_hosts   (UgUri* uuri, char** hosts);
 int  ug_uri_match_schemes (UgUri* uuri, char** schemes);
 int  ug_uri_match_file_exts (UgUri* uuri, char** exts);
 
+// ------------------------------------
+// canonical URI for comparing
+
+// write canonical form of URI to 'dest'. return length of it.
+// 'dest' must have strlen(uri) + 2 bytes at least.
+// - lowercase scheme and host, remove default port and fragment.
+// - decode percent-encoded unreserved characters, uppercase others.
+// - remove query fields in 'query_fields'. It must be null-terminated and
+//   field that ends with '*' matches prefix. e.g. {"utm_*", "fbclid", NULL}
+// URI without scheme (local path) is copied as is.
+int  ug_uri_canonicalize (UgUri* uuri, char** query_fields, char* dest);
+
 // ------------------------------------
 // UgUriQuery
 
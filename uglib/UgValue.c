@@ -38,6 +38,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <UgString.h>
+#include <UgArena.h>
 #include <UgValue.h>
 
 #if defined(_MSC_VER)
@@ -46,6 +47,7 @@
 #endif
 
 static UgValueArray*  ug_value_array_new(int preAllocate);
+static UgValueArray*  ug_value_array_new_arena(UgArena* arena, int preAllocate);
 static void           ug_value_array_free(UgValueArray* varray);
 #define ug_value_object_new     ug_value_array_new
 #define ug_value_object_free    ug_value_array_free
@@ -174,18 +176,140 @@ UgValue* ug_value_alloc_front(UgValue* uvalue, int nValue)
 }
 #endif
 
+// object that has more members than this will be indexed.
+#define INDEX_MIN_MEMBERS    8
+
+static unsigned int  index_hash(const char* name)
+{
+	unsigned int  hash = 2166136261u;
+
+	for (;  *name;  name++)
+		hash = (hash ^ (unsigned char) *name) * 16777619u;
+	return hash;
+}
+
+static unsigned int  index_size(int length)
+{
+	unsigned int  size;
+
+	for (size = 16;  size < (unsigned int) length * 2;  size *= 2)
+		;
+	return size;
+}
+
+static void  ug_value_object_index(UgValueObject* vobject)
+{
+	unsigned int  size, pos;
+	int*          slots;
+	int           count;
+
+	size = index_size(vobject->length);
+	// object in arena can't grow, it's index is allocated by
+	// ug_value_index_arena() after parsing.
+	if (vobject->allocated < 0)
+		;
+	else if (vobject->index == NULL || (unsigned int) vobject->index[1] + 1 < size) {
+		ug_free(vobject->index);
+		vobject->index = ug_malloc(sizeof(int) * (size + 2));
+		vobject->index[1] = size - 1;
+	}
+	size = vobject->index[1] + 1;
+	slots = vobject->index + 2;
+	memset(slots, 0, sizeof(int) * size);
+
+	// slot store position + 1, keep first member if name is duplicated.
+	for (count = 0;  count < vobject->length;  count++) {
+		if (vobject->at[count].name == NULL)
+			continue;
+		pos = index_hash(vobject->at[count].name) & (size - 1);
+		for (;  slots[pos];  pos = (pos + 1) & (size - 1)) {
+			if (strcmp(vobject->at[slots[pos] - 1].name, vobject->at[count].name) == 0)
+				break;
+		}
+		if (slots[pos] == 0)
+			slots[pos] = count + 1;
+	}
+	vobject->index[0] = vobject->length;
+}
+
+void  ug_value_index_arena(UgValue* value, UgArena* arena)
+{
+	UgValueArray*  varray;
+	unsigned int   size;
+	int            count;
+
+	if (value->type != UG_VALUE_OBJECT && value->type != UG_VALUE_ARRAY)
+		return;
+	varray = value->c.array;
+	if (varray->allocated >= 0)
+		return;
+	for (count = 0;  count < varray->length;  count++)
+		ug_value_index_arena(varray->at + count, arena);
+
+	if (value->type == UG_VALUE_OBJECT && varray->index == NULL &&
+	    varray->length > INDEX_MIN_MEMBERS)
+	{
+		size = index_size(varray->length);
+		varray->index = ug_arena_alloc(arena, sizeof(int) * (size + 2));
+		varray->index[1] = size - 1;
+		ug_value_object_index(varray);
+	}
+}
+
 UgValue* ug_value_find_name(UgValue* value, const char* name)
 {
-	UgValue  temp;
+	UgValueObject* vobject;
+	UgValue*       member;
+	unsigned int   mask, pos;
+	int*           slots;
+	int            count;
+
+	if (value->type != UG_VALUE_OBJECT)
+		return NULL;
+	vobject = value->c.object;
+
+	// object in arena has no index before ug_value_index_arena()
+	if (vobject->length <= INDEX_MIN_MEMBERS ||
+	    (vobject->allocated < 0 && vobject->index == NULL))
+	{
+		for (count = 0;  count < vobject->length;  count++) {
+			member = vobject->at + count;
+			if (member->name && strcmp(member->name, name) == 0)
+				return member;
+		}
+		return NULL;
+	}
 
-	if (value->type == UG_VALUE_OBJECT) {
-		temp.name = (char*)name;
-		return bsearch(&temp, value->c.object->at, value->c.object->length,
-				sizeof(UgValue), ug_value_compare_name);
+	// rebuild index if members were added
+	if (vobject->index == NULL || vobject->index[0] != vobject->length)
+		ug_value_object_index(vobject);
+	mask = vobject->index[1];
+	slots = vobject->index + 2;
+	for (pos = index_hash(name) & mask;  slots[pos];  pos = (pos + 1) & mask) {
+		member = vobject->at + slots[pos] - 1;
+		if (strcmp(member->name, name) == 0)
+			return member;
 	}
 	return NULL;
 }
 
+void  ug_value_sort(UgValue* value, UgCompareFunc compare)
+{
+	UgValueArray*  varray;
+
+	varray = value->c.array;
+	// positions of members will be changed
+	if (varray->allocated < 0) {
+		if (varray->index)
+			varray->index[0] = -1;
+	}
+	else {
+		ug_free(varray->index);
+		varray->index = NULL;
+	}
+	qsort(varray->at, varray->length, sizeof(UgValue), compare);
+}
+
 void  ug_value_sort_recursive(UgValue* value, UgCompareFunc compare)
 {
 	UgValue* end;
@@ -314,6 +438,40 @@ static UgJsonError ug_json_parse_value_array(UgJson* json,
                                        const char* name, const char* value,
                                        void* uvalue, void* none);
 
+static void  ug_value_parse_number(UgValue* uvalue, const char* value)
+{
+	if (strchr(value, '.')) {
+		uvalue->type = UG_VALUE_DOUBLE;
+		uvalue->c.fraction = strtod(value, NULL);
+	}
+	else if (value[0] == '-') {
+		uvalue->c.integer64 = (int64_t) strtoll(value, NULL, 10);
+		if (uvalue->c.integer64 >= INT_MIN) {
+			uvalue->c.integer = (int) uvalue->c.integer64;
+			uvalue->type = UG_VALUE_INT;
+		}
+		else
+			uvalue->type = UG_VALUE_INT64;
+	}
+	else {
+		uvalue->c.uinteger64 = (uint64_t) strtoull(value, NULL, 10);
+		if (uvalue->c.uinteger64 <= INT_MAX) {
+			uvalue->c.integer = (int) uvalue->c.uinteger64;
+			uvalue->type = UG_VALUE_INT;
+		}
+		else if (uvalue->c.uinteger64 <= UINT_MAX) {
+			uvalue->c.uinteger = (unsigned int) uvalue->c.uinteger64;
+			uvalue->type = UG_VALUE_UINT;
+		}
+		else if (uvalue->c.uinteger64 <= INT64_MAX) {
+			uvalue->c.integer64 = (int64_t) uvalue->c.uinteger64;
+			uvalue->type = UG_VALUE_INT64;
+		}
+		else
+			uvalue->type = UG_VALUE_UINT64;
+	}
+}
+
 UgJsonError ug_json_parse_value(UgJson* json,
                                 const char* name, const char* value,
                                 void* data, void* none)
@@ -343,36 +501,7 @@ UgJsonError ug_json_parse_value(UgJson* json,
 		break;
 
 	case UG_JSON_NUMBER:
-		if (strchr(value, '.')) {
-			uvalue->type = UG_VALUE_DOUBLE;
-			uvalue->c.fraction = strtod(value, NULL);
-		}
-		else if (value[0] == '-') {
-			uvalue->c.integer64 = (int64_t) strtoll(value, NULL, 10);
-			if (uvalue->c.integer64 >= INT_MIN) {
-				uvalue->c.integer = (int) uvalue->c.integer64;
-				uvalue->type = UG_VALUE_INT;
-			}
-			else
-				uvalue->type = UG_VALUE_INT64;
-		}
-		else {
-			uvalue->c.uinteger64 = (uint64_t) strtoull(value, NULL, 10);
-			if (uvalue->c.uinteger64 <= INT_MAX) {
-				uvalue->c.integer = (int) uvalue->c.uinteger64;
-				uvalue->type = UG_VALUE_INT;
-			}
-			else if (uvalue->c.uinteger64 <= UINT_MAX) {
-				uvalue->c.uinteger = (unsigned int) uvalue->c.uinteger64;
-				uvalue->type = UG_VALUE_UINT;
-			}
-			else if (uvalue->c.uinteger64 <= INT64_MAX) {
-				uvalue->c.integer64 = (int64_t) uvalue->c.uinteger64;
-				uvalue->type = UG_VALUE_INT64;
-			}
-			else
-				uvalue->type = UG_VALUE_UINT64;
-		}
+		ug_value_parse_number(uvalue, value);
 		break;
 
 	case UG_JSON_STRING:
@@ -400,6 +529,61 @@ UgJsonError ug_json_parse_value(UgJson* json,
 	return UG_JSON_ERROR_NONE;
 }
 
+static UgJsonError ug_json_parse_value_array_arena(UgJson* json,
+                                       const char* name, const char* value,
+                                       void* uvalue, void* arena);
+
+UgJsonError ug_json_parse_value_arena(UgJson* json,
+                                      const char* name, const char* value,
+                                      void* data, void* arena)
+{
+	UgValue*  uvalue;
+
+	uvalue = data;
+	if (json->scope == UG_JSON_OBJECT)
+		uvalue->name = ug_arena_strdup(arena, name);
+	else
+		uvalue->name = NULL;
+
+	switch (json->type) {
+	case UG_JSON_NULL:
+		uvalue->type = UG_VALUE_STRING;
+		uvalue->c.string = NULL;
+		break;
+
+	case UG_JSON_TRUE:
+	case UG_JSON_FALSE:
+		uvalue->type = UG_VALUE_BOOL;
+		uvalue->c.boolean = (json->type == UG_JSON_TRUE);
+		break;
+
+	case UG_JSON_NUMBER:
+		ug_value_parse_number(uvalue, value);
+		break;
+
+	case UG_JSON_STRING:
+		uvalue->type = UG_VALUE_STRING;
+		uvalue->c.string = ug_arena_strdup(arena, value);
+		break;
+
+	case UG_JSON_OBJECT:
+	case UG_JSON_ARRAY:
+		if (json->type == UG_JSON_OBJECT)
+			uvalue->type = UG_VALUE_OBJECT;
+		else
+			uvalue->type = UG_VALUE_ARRAY;
+		uvalue->c.array = ug_value_array_new_arena(arena, 8);
+		ug_json_push(json, ug_json_parse_value_array_arena, uvalue, arena);
+		break;
+
+	default:
+		uvalue->type = UG_VALUE_NONE;
+		break;
+	};
+
+	return UG_JSON_ERROR_NONE;
+}
+
 static void  ug_json_write_value_array(UgJson* json, UgValueArray* varray);
 
 void  ug_json_write_value(UgJson* json, UgValue* uvalue)
@@ -468,6 +652,20 @@ static UgValueArray*  ug_value_array_new(int preAllocate)
 	varray = ug_malloc(sizeof(UgValueArray) + sizeof(UgValue) * preAllocate);
 	varray->allocated = preAllocate + 1;
 	varray->length = 0;
+	varray->index = NULL;
+	return varray;
+}
+
+// UgValueArray.allocated is negative if array is allocated from arena.
+static UgValueArray*  ug_value_array_new_arena(UgArena* arena, int preAllocate)
+{
+	UgValueArray*  varray;
+
+	varray = ug_arena_alloc(arena,
+			sizeof(UgValueArray) + sizeof(UgValue) * preAllocate);
+	varray->allocated = -(preAllocate + 1);
+	varray->length = 0;
+	varray->index = NULL;
 	return varray;
 }
 
@@ -480,6 +678,7 @@ static void  ug_value_array_free(UgValueArray* varray)
 	end = varray->at + varray->length;
 	for (;  cur < end;  cur++)
 		ug_value_clear(cur);
+	ug_free(varray->index);
 	ug_free(varray);
 }
 
@@ -493,6 +692,26 @@ static UgJsonError ug_json_parse_value_array(UgJson* json,
 	return ug_json_parse_value(json, name, value, uvalue1, none);
 }
 
+static UgJsonError ug_json_parse_value_array_arena(UgJson* json,
+                                       const char* name, const char* value,
+                                       void* uvalue, void* arena)
+{
+	UgValueArray*  varray;
+	UgValueArray*  varray_old;
+
+	varray = ((UgValue*) uvalue)->c.array;
+	// old array is left in arena, it will be released by ug_arena_reset()
+	if (varray->length == -varray->allocated) {
+		varray_old = varray;
+		varray = ug_value_array_new_arena(arena, varray_old->length * 2);
+		memcpy(varray->at, varray_old->at, sizeof(UgValue) * varray_old->length);
+		varray->length = varray_old->length;
+		((UgValue*) uvalue)->c.array = varray;
+	}
+	uvalue = varray->at + varray->length++;
+	return ug_json_parse_value_arena(json, name, value, uvalue, arena);
+}
+
 static void  ug_json_write_value_array(UgJson* json, UgValueArray* varray)
 {
 	UgValue*  cur;
@@ -40,6 +40,7 @@
 #include <stdint.h>     // int64_t
 #include <stdlib.h>     // qsort(), malloc(), free()
 #include <UgJson.h>
+#include <UgArena.h>
 #include <UgDefine.h>
 
 #ifdef __cplusplus
@@ -114,10 +115,7 @@ UgValue* ug_value_alloc_front(UgValue* uvalue, int nValue);
 #define ug_value_length(varray)  \
 		(varray)->c.array->length
 
-// void ug_value_sort(UgValue* value, UgCompareFunc compare);
-#define ug_value_sort(varray, compareFunc)  \
-		qsort((varray)->c.array->at, (varray)->c.array->length,  \
-		      sizeof(UgValue), compareFunc)
+void  ug_value_sort(UgValue* value, UgCompareFunc compare);
 
 // UgValue*  ug_value_find(UgValue* value, UgValue* key, UgCompareFunc func);
 #define ug_value_find(varray, key, compareFunc)  \
@@ -126,9 +124,10 @@ UgValue* ug_value_alloc_front(UgValue* uvalue, int nValue);
 
 // void ug_value_sort_name(UgValue* value)
 #define ug_value_sort_name(vobj)  \
-		qsort((vobj)->c.object->at, (vobj)->c.object->length,  \
-		      sizeof(UgValue), ug_value_compare_name)
+		ug_value_sort(vobj, ug_value_compare_name)
 
+// ug_value_find_name() doesn't need sorted object. It scans small object and
+// build hash index of member name for large object.
 UgValue*  ug_value_find_name(UgValue* value, const char* name);
 
 // recursive functions
@@ -158,6 +157,19 @@ UgJsonError ug_json_parse_value(UgJson* json,
                                 void* uvalue, void* none);
 void        ug_json_write_value(UgJson* json, UgValue* value);
 
+// This parser allocates all names, strings, arrays, and objects from arena.
+// param arena: UgArena*
+// Don't call ug_value_clear() or ug_value_alloc() with these values,
+// they are released by ug_arena_reset() or ug_arena_final().
+UgJsonError ug_json_parse_value_arena(UgJson* json,
+                                      const char* name, const char* value,
+                                      void* uvalue, void* arena);
+
+// build member index of large objects in 'value' that parsed by
+// ug_json_parse_value_arena(). Index is allocated from arena, call it once
+// after parsing. Objects without index are scanned by ug_value_find_name().
+void  ug_value_index_arena(UgValue* value, UgArena* arena);
+
 #ifdef __cplusplus
 }
 #endif
@@ -221,7 +233,10 @@ struct UgValue
 struct UgValueArray
 {
 	int       length;
-	int       allocated;
+	int       allocated;  // negative if it is allocated from arena
+	// hash index of member name, it is built by ug_value_find_name().
+	// index[0] = number of indexed members, index[1] = mask of slots.
+	int*      index;
 	UgValue   at[1];
 };
 
@@ -230,8 +230,7 @@ static void uget_node_set_by_dataset (UgetNode* node, UgDataset* dataset)
 		old.common->url = NULL;
 		new.common->mirrors = old.common->mirrors;
 		old.common->mirrors = NULL;
-		new.common->folder = old.common->folder;
-		old.common->folder = NULL;
+		ug_str_set_shared (&new.common->folder, old.common->folder);
 		new.common->file = old.common->file;
 		old.common->file = NULL;
 		new.common->user = old.common->user;
@@ -252,8 +251,7 @@ static void uget_node_set_by_dataset (UgetNode* node, UgDataset* dataset)
 	old.proxy = ug_dataset_get (dataset, UgProxyInfo, 0);
 	if (old.proxy) {
 		new.proxy = ug_data_realloc (node->data, UgetProxyInfo);
-		new.proxy->host = old.proxy->host;
-		old.proxy->host = NULL;
+		ug_str_set_shared (&new.proxy->host, old.proxy->host);
 		new.proxy->port = old.proxy->port;
 		new.proxy->type = old.proxy->type;
 		new.proxy->user = old.proxy->user;
@@ -269,18 +267,14 @@ static void uget_node_set_by_dataset (UgetNode* node, UgDataset* dataset)
 		old.http->user = NULL;
 		new.http->password = old.http->password;
 		old.http->password = NULL;
-		new.http->referrer = old.http->referrer;
-		old.http->referrer = NULL;
-		new.http->user_agent = old.http->user_agent;
-		old.http->user_agent = NULL;
+		ug_str_set_shared (&new.http->referrer, old.http->referrer);
+		ug_str_set_shared (&new.http->user_agent, old.http->user_agent);
 		new.http->post_data = old.http->post_data;
 		old.http->post_data = NULL;
-		new.http->post_file = old.http->post_file;
-		old.http->post_file = NULL;
+		ug_str_set_shared (&new.http->post_file, old.http->post_file);
 		new.http->cookie_data = old.http->cookie_data;
 		old.http->cookie_data = NULL;
-		new.http->cookie_file = old.http->cookie_file;
-		old.http->cookie_file = NULL;
+		ug_str_set_shared (&new.http->cookie_file, old.http->cookie_file);
 		new.http->redirection_limit = old.http->redirection_limit;
 		new.http->redirection_count = old.http->redirection_count;
 	}
@@ -184,7 +184,10 @@ void  ugtk_app_quit (UgtkApp* app)
 	// sync setting and save data
 	ugtk_app_get_window_setting (app, &app->setting);
 	ugtk_app_get_column_setting (app, &app->setting);
+	// journal can't be appended while category files are written in background
+	uget_app_wait_categories ((UgetApp*) app);
 	ugtk_app_save (app);
+	uget_app_wait_categories ((UgetApp*) app);
 	// clear plug-in
 	uget_app_clear_plugins ((UgetApp*) app);
 	// hide icon in system tray before quit
@@ -567,6 +570,8 @@ void  ugtk_app_set_other_setting (UgtkApp* app, UgtkSetting* setting)
 	uget_task_set_speed (&app->task,
 			setting->bandwidth.normal.download * 1024,
 			setting->bandwidth.normal.upload   * 1024);
+	// messages of download
+	uget_log_set_capacity (setting->log_capacity);
 }
 
 void  ugtk_app_set_menu_setting (UgtkApp* app, UgtkSetting* setting)
@@ -1751,6 +1756,9 @@ void  ugtk_app_category_changed (UgtkApp* app, UgetNode* cnode)
 	GtkTreePath*  path;
 	GtkTreeModel* model;
 
+	// category files will be rewritten in next saving
+	uget_app_journal_changed ((UgetApp*) app, cnode);
+
 	model = GTK_TREE_MODEL (app->traveler.category.model);
 	if (app->traveler.category.cursor.pos > 0) {
 		iter.stamp = app->traveler.category.model->stamp;
@@ -1780,7 +1788,7 @@ void  ugtk_app_add_default_category (UgtkApp* app)
 	cnode = uget_node_new (NULL);
 	common = ug_data_realloc (cnode->data, UgetCommonInfo);
 	common->name = ug_strdup_printf ("%s %d", _("New"), counts++);
-	common->folder = ug_strdup (g_get_home_dir ());
+	ug_str_set_shared (&common->folder, g_get_home_dir ());
 	category = ug_data_realloc (cnode->data, UgetCategoryInfo);
 	*(char**)ug_array_alloc (&category->schemes, 1) = ug_strdup ("ftps");
 	*(char**)ug_array_alloc (&category->schemes, 1) = ug_strdup ("magnet");
@@ -78,6 +78,10 @@ struct UgtkApp
 	UgetNode        sorted_split;   // virtual root
 	UgetNode        mix;            // virtual root
 	UgetNode        mix_split;      // virtual root
+	int             n_sorted_refs;  // reference count of virtual roots,
+	int             n_sorted_split_refs; // see uget_app_ref_view()
+	int             n_mix_refs;     // (mix and mix_split)
+	UgetAppJournal  journal;
 	UgRegistry      infos;
 	UgRegistry      plugins;
 	UgetPluginInfo* plugin_default;
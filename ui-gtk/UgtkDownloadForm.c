@@ -447,6 +447,17 @@ static void ugtk_download_form_init_page2 (UgtkDownloadForm* dform)
 	dform->timestamp = (GtkToggleButton*) widget;
 }
 
+// field hold shared string, see ug_str_set_shared()
+static void  set_shared_text (char** field, const char* text)
+{
+	char*  string;
+
+	string = (*text) ? ug_strdup (text) : NULL;
+	ug_str_remove_crlf (string, string);
+	ug_str_set_shared (field, string);
+	ug_free (string);
+}
+
 void  ugtk_download_form_get (UgtkDownloadForm* dform, UgData* node_data)
 {
 	UgUri         uuri;
@@ -463,9 +474,7 @@ void  ugtk_download_form_get (UgtkDownloadForm* dform, UgData* node_data)
 	temp.common = ug_data_realloc(node_data, UgetCommonInfo);
 	// folder
 	text = gtk_entry_get_text ((GtkEntry*)dform->folder_entry);
-	ug_free (temp.common->folder);
-	temp.common->folder = (*text) ? ug_strdup (text) : NULL;
-	ug_str_remove_crlf (temp.common->folder, temp.common->folder);
+	set_shared_text (&temp.common->folder, text);
 	// user
 	text = gtk_entry_get_text ((GtkEntry*)dform->username_entry);
 	ug_free (temp.common->user);
@@ -543,24 +552,16 @@ void  ugtk_download_form_get (UgtkDownloadForm* dform, UgData* node_data)
 	temp.http = ug_data_realloc(node_data, UgetHttpInfo);
 	// referrer
 	text = gtk_entry_get_text ((GtkEntry*) dform->referrer_entry);
-	ug_free (temp.http->referrer);
-	temp.http->referrer = (*text) ? ug_strdup (text) : NULL;
-	ug_str_remove_crlf (temp.http->referrer, temp.http->referrer);
+	set_shared_text (&temp.http->referrer, text);
 	// cookie_file
 	text = gtk_entry_get_text ((GtkEntry*) dform->cookie_entry);
-	ug_free (temp.http->cookie_file);
-	temp.http->cookie_file = (*text) ? ug_strdup (text) : NULL;
-	ug_str_remove_crlf (temp.http->cookie_file, temp.http->cookie_file);
+	set_shared_text (&temp.http->cookie_file, text);
 	// post_file
 	text = gtk_entry_get_text ((GtkEntry*) dform->post_entry);
-	ug_free (temp.http->post_file);
-	temp.http->post_file = (*text) ? ug_strdup (text) : NULL;
-	ug_str_remove_crlf (temp.http->post_file, temp.http->post_file);
+	set_shared_text (&temp.http->post_file, text);
 	// user_agent
 	text = gtk_entry_get_text ((GtkEntry*) dform->agent_entry);
-	ug_free (temp.http->user_agent);
-	temp.http->user_agent = (*text) ? ug_strdup (text) : NULL;
-	ug_str_remove_crlf (temp.http->user_agent, temp.http->user_agent);
+	set_shared_text (&temp.http->user_agent, text);
 
 	// ------------------------------------------
 	// UgetRelation
@@ -640,6 +640,7 @@ static void on_set_download_prioriy (GtkWidget* widget, UgtkApp* app)
 		node = node->base;
 		relation = ug_data_realloc (node->data, UgetRelationInfo);
 		relation->task.priority = priority;
+		uget_app_journal_changed ((UgetApp*) app, node);
 	}
 	g_list_free (list);
 }
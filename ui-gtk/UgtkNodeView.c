@@ -38,6 +38,7 @@
 #include <UgString.h>
 #include <UgetNode.h>
 #include <UgetData.h>
+#include <UgetApp.h>
 #include <UgtkNodeTree.h>
 #include <UgtkNodeView.h>
 
@@ -577,7 +578,9 @@ static void col_set_quantity (GtkTreeViewColumn *tree_column,
 	if (node == NULL)
 		return;
 
-	quantity = ug_strdup_printf ("%u", node->n_children);
+	// add downloads that are not loaded yet
+	quantity = ug_strdup_printf ("%d",
+			node->n_children + uget_app_count_paged_out (node));
 	g_object_set (cell, "text", quantity, NULL);
 	ug_free (quantity);
 }
@@ -200,8 +200,7 @@ void  ugtk_proxy_form_get (UgtkProxyForm* pform, UgData* node_data)
 	proxy->password = (*text) ? ug_strdup (text) : NULL;
 	// host
 	text = gtk_entry_get_text ((GtkEntry*)pform->host);
-	ug_free (proxy->host);
-	proxy->host = (*text) ? ug_strdup (text) : NULL;
+	ug_str_set_shared (&proxy->host, (*text) ? text : NULL);
 
 	proxy->port = gtk_spin_button_get_value_as_int ((GtkSpinButton*) pform->port);
 
@@ -38,6 +38,7 @@
 #include <UgString.h>
 #include <UgJsonFile.h>
 #include <UgetMedia.h>
+#include <UgetData.h>
 #include <UgtkSetting.h>
 #include <UgtkNodeView.h>
 
@@ -385,6 +386,8 @@ static const UgEntry  UgtkSettingEntry[] =
 			UG_ENTRY_INT,    NULL,  NULL},
 	{"AutoSaveInterval",offsetof (UgtkSetting, auto_save.interval),
 			UG_ENTRY_INT,    NULL,  NULL},
+	{"LogCapacity",     offsetof (UgtkSetting, log_capacity),
+			UG_ENTRY_INT,    NULL,  NULL},
 //	{"OfflineMode",     offsetof (UgtkSetting, offline_mode),
 //			UG_ENTRY_BOOL,   NULL,  NULL},
 
@@ -523,6 +526,7 @@ void  ugtk_setting_reset (UgtkSetting* setting)
 	setting->completion.on_error = NULL;
 	setting->auto_save.enable = TRUE;
 	setting->auto_save.interval = 3;
+	setting->log_capacity = UGET_LOG_CAPACITY;
 
 	setting->offline_mode = FALSE;
 }
@@ -688,4 +692,8 @@ void  ugtk_setting_fix_data (UgtkSetting* setting)
 		setting->media.quality = UGET_MEDIA_QUALITY_360P;
 	if (setting->media.type < 0 || setting->media.type > UGET_MEDIA_N_TYPE)
 		setting->media.type = UGET_MEDIA_TYPE_MP4;
+
+	// UgetLog
+	if (setting->log_capacity < 1)
+		setting->log_capacity = UGET_LOG_CAPACITY;
 }
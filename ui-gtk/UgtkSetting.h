@@ -249,6 +249,9 @@ struct UgtkSetting
 		int    interval;
 	} auto_save;
 
+	// UgetLog: number of messages kept for each download
+	int        log_capacity;
+
 	// "FolderHistory"
 	UgList     folder_history;
 
@@ -79,6 +79,7 @@ void  ugtk_summary_show (UgtkSummary* summary, UgetNode* node)
 	gchar*        name;
 	gchar*        value;
 	gchar*        stock;
+	gchar*        repeats = NULL;
 	union {
 		UgetLog*      log;
 		UgetEvent*    event;
@@ -166,6 +167,12 @@ void  ugtk_summary_show (UgtkSummary* summary, UgetNode* node)
 		}
 		else {
 			value = temp.event->string;
+			// show how many times the same message happened
+			if (temp.event->repeats > 0 && value) {
+				repeats = g_strdup_printf ("%s (x%d)", value,
+						temp.event->repeats + 1);
+				value = repeats;
+			}
 			switch (temp.event->type) {
 			case UGET_EVENT_ERROR:
 				stock = GTK_STOCK_DIALOG_ERROR;
@@ -185,6 +192,7 @@ void  ugtk_summary_show (UgtkSummary* summary, UgetNode* node)
 				UGTK_SUMMARY_COLUMN_NAME , name,
 				UGTK_SUMMARY_COLUMN_VALUE, value,
 				-1);
+		g_free (repeats);
 	}
 	// clear remaining rows
 	if (gtk_tree_model_iter_next (GTK_TREE_MODEL (summary->store), &iter)) {
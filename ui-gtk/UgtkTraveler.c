@@ -62,7 +62,9 @@ void  ugtk_traveler_init (UgtkTraveler* traveler, UgtkApp* app)
 	gtk_tree_view_set_model (traveler->state.view,
 			GTK_TREE_MODEL (traveler->state.model));
 
-	// category
+	// category (build virtual roots that traveler display)
+	uget_app_ref_view ((UgetApp*) app, &app->sorted_split);
+	uget_app_ref_view ((UgetApp*) app, &app->mix_split);
 	traveler->category.self = gtk_scrolled_window_new (NULL, NULL);
 	traveler->category.view = (GtkTreeView*) ugtk_node_view_new_for_category ();
 	traveler->category.model = ugtk_node_tree_new (&app->sorted, TRUE);
@@ -499,6 +501,7 @@ static void on_state_cursor_changed (GtkTreeView* view, UgtkTraveler* traveler)
 	GtkTreeModel*  model;
 	GtkTreePath*   path;
 	GtkTreeIter    iter;
+	UgetNode*      node;
 
 	// clear download cursor
 	traveler->download.cursor.node = NULL;
@@ -519,6 +522,18 @@ static void on_state_cursor_changed (GtkTreeView* view, UgtkTraveler* traveler)
 	gtk_tree_path_free (path);
 	traveler->state.cursor.node = iter.user_data;
 
+	// load finished and recycled downloads before showing them
+	node = iter.user_data;
+	if (node && (uget_node_get_group (node) &
+	             (UGET_GROUP_ACTIVE | UGET_GROUP_QUEUING)) == 0)
+	{
+		// "All Category" has downloads of all categories
+		if (traveler->category.cursor.pos == 0)
+			uget_app_page_in ((UgetApp*) traveler->app, NULL);
+		else
+			uget_app_page_in ((UgetApp*) traveler->app, node->base);
+	}
+
 	// change download.model and refresh it's view
 	gtk_tree_view_set_model (traveler->download.view, NULL);
 	if (iter.user_data) {